@@ -20,6 +20,7 @@
     SOKOL_API_IMPL      - public function implementation prefix (default: -)
 
     SAUDIO_RING_MAX_SLOTS   - max number of slots in the push-audio ring buffer (default 1024)
+    SAUDIO_NO_SIMD          - don't use SSE/NEON in the mixer
 
     If sokol_audio.h is compiled as a DLL, define the following before
     including the declaration or implementation:
@@ -40,9 +41,15 @@
     - emscripten: WebAudio with ScriptProcessorNode
     - Android: OpenSLES (link with OpenSLES)
 
-    Sokol Audio will not do any buffer mixing or volume control, if you have
-    multiple independent input streams of sample data you need to perform the
-    mixing yourself before forwarding the data to Sokol Audio.
+    Additionally, a 'null backend' can be selected at runtime on all
+    platforms with threading support, this renders the audio stream
+    without any audio device and optionally writes it to a WAV file
+    (useful for headless testing and benchmarking).
+
+    Sokol Audio can optionally mix additional input streams (each with
+    its own stream callback or push FIFO) into the main stream (see
+    MULTIPLE STREAMS below), and it has an optional mixer for playing back
+    PCM buffers with a fixed pool of voices (see THE MIXER below).
 
     There are two mutually exclusive ways to provide the sample data:
 
@@ -141,6 +148,10 @@
         int sample_rate     -- the sample rate in Hz, default: 44100
         int num_channels    -- number of channels, default: 1 (mono)
         int buffer_frames   -- number of frames in streaming buffer, default: 2048
+                               (or 3 * period_frames in low-latency mode on
+                               the ALSA and null backends)
+        int period_frames   -- optional: number of frames per stream callback,
+                               see LOW-LATENCY MODE, default: buffer_frames
 
     The stream callback prototype (either with or without userdata):
 
@@ -164,7 +175,8 @@
         int saudio_channels(void);
 
     It's unlikely that the number of channels will be different than requested,
-    but a different sample rate isn't uncommon.
+    but a different sample rate isn't uncommon (see SAMPLE RATE CONVERSION
+    below for how to let Sokol Audio deal with this).
 
     (NOTE: there's an yet unsolved issue when an audio backend might switch
     to a different sample rate when switching output devices, for instance
@@ -273,6 +285,397 @@
             }
         }
 
+    The pushed samples are queued in a packet FIFO which is shared between
+    the thread calling saudio_push() and the audio thread. The FIFO is a
+    wait-free single-producer/single-consumer queue built on atomic
+    head/tail indices, so neither side ever takes a lock, and the audio
+    thread can't be blocked by the main thread. As a consequence,
+    saudio_push() and saudio_expect() must always be called from the
+    same thread.
+
+    SAMPLE FORMATS
+    ==============
+    By default, pushed samples are 32-bit floats. If your sample data is
+    in a different format, you can tell Sokol Audio about it in
+    saudio_desc.sample_format, and push the samples with
+    saudio_push_samples() instead of saudio_push():
+
+        saudio_setup(&(saudio_desc){
+            .sample_format = SAUDIO_SAMPLEFORMAT_INT16,
+        });
+        ...
+        const int16_t* samples = ...;
+        saudio_push_samples(samples, num_frames);
+
+    The following sample formats are supported:
+
+        SAUDIO_SAMPLEFORMAT_FLOAT32:    32-bit floats in the range -1.0 .. +1.0 (default)
+        SAUDIO_SAMPLEFORMAT_INT16:      signed 16-bit integers
+        SAUDIO_SAMPLEFORMAT_INT24:      signed 24-bit integers, packed into 3 bytes (little endian)
+
+    The samples are stored in the packet FIFO in the pushed format (so
+    with INT16 samples, the FIFO only needs half the memory), and are
+    converted (using SSE2 or NEON) to floats on the audio thread.
+
+    saudio_push() can only be used with SAUDIO_SAMPLEFORMAT_FLOAT32, and
+    the stream callback always works with float samples.
+
+    On backends which need 16-bit integer samples (WASAPI and OpenSLES),
+    the float samples are converted (and clamped to the valid range) right
+    before they are handed to the audio device. This means that pushed
+    INT16 samples are converted twice on those backends (to float and
+    back), but since both conversions use the same scale factor, the
+    samples arrive unchanged at the audio device (unless they are
+    resampled or mixed with other streams or voices).
+
+    SAMPLE RATE CONVERSION
+    ======================
+    If your audio data has a fixed sample rate which may be different from
+    the sample rate of the audio device, set saudio_desc.source_sample_rate
+    to the sample rate of your audio data:
+
+        saudio_setup(&(saudio_desc){
+            .stream_cb = my_stream_callback,
+            .source_sample_rate = 44100,
+        });
+
+    Sokol Audio will then convert the audio stream from the source sample
+    rate to the sample rate of the audio device with a polyphase
+    windowed-sinc resampler on the audio thread. This affects the stream
+    callback, the push model and the mixer:
+
+    - the stream callback is called with num_frames at the source sample
+      rate
+    - saudio_expect() and saudio_push() count frames at the source sample rate
+    - mixer voices play at the source sample rate
+
+    saudio_sample_rate() still returns the sample rate of the audio device.
+    If the device ends up with the source sample rate, the resampler is
+    skipped.
+
+    The tradeoff between quality and CPU cost can be selected with
+    saudio_desc.resampler_quality:
+
+        SAUDIO_RESAMPLER_QUALITY_LOW:       8 taps, 64 filter phases
+        SAUDIO_RESAMPLER_QUALITY_MEDIUM:    16 taps, 256 filter phases (default)
+        SAUDIO_RESAMPLER_QUALITY_HIGH:      32 taps, 1024 filter phases
+
+    Each output sample costs one dot product with 'taps' elements per
+    channel (using SSE or NEON unless SAUDIO_NO_SIMD is defined), the filter
+    tables are computed once in saudio_setup(). The resampler adds a latency
+    of half the number of taps (in source frames).
+
+    STATISTICS
+    ==========
+    To tune the buffer_frames, packet_frames and num_packets parameters,
+    Sokol Audio collects statistics on the audio thread, call
+    saudio_query_stats() to get a snapshot:
+
+        saudio_stats stats = saudio_query_stats();
+
+    The following values are provided:
+
+        num_buffers         -- number of stream buffers filled
+        num_underruns       -- number of underruns detected by the backend,
+                               currently only the ALSA backend (failed
+                               snd_pcm_writei()), the WASAPI backend (the
+                               device buffer was empty when refilled) and
+                               the null backend (a buffer was rendered too
+                               late) can detect underruns
+        num_silence_buffers -- number of stream buffers which had to be
+                               filled with silence because there wasn't
+                               enough pushed data in the FIFO (only in
+                               the push model)
+        fifo_min_frames
+        fifo_avg_frames
+        fifo_max_frames     -- number of frames in the push FIFO, sampled
+                               each time the audio thread pulls data
+        fill_avg_ms
+        fill_max_ms         -- time spent to fill a stream buffer (includes
+                               the stream callback, the mixer and the
+                               sample rate conversion)
+        fill_histogram      -- histogram of fill times, bucket 0 counts fills
+                               which took less than 16 microseconds, bucket
+                               i counts fills which took between (8 << i)
+                               and (16 << i) microseconds, the last bucket
+                               also counts all longer fills
+        latency_ms          -- the output latency from the end of the stream
+                               buffer to the speaker, on ALSA (with
+                               snd_pcm_delay()) and WASAPI (the queued
+                               frames in the device buffer plus
+                               IAudioClient_GetStreamLatency()) this is
+                               measured (latency_measured is true), on other
+                               backends (including the null backend) it is
+                               estimated from the stream buffer size, the
+                               resampler latency is included; the latency
+                               of the push FIFO is not included (see
+                               fifo_avg_frames)
+
+    The statistics are written on the audio thread with atomic stores, and
+    can be queried from any thread at any time without blocking the audio
+    thread.
+
+    To start a new measurement (for instance after a loading phase), call
+    saudio_reset_stats(). The reset happens asynchronously on the audio
+    thread before the next stream buffer is filled.
+
+    LOW-LATENCY MODE
+    ================
+    By default, the audio thread fills the entire stream buffer at once, so
+    the output latency is at least buffer_frames (about 46 ms with the
+    default 2048 frames at 44.1 kHz). Simply making the buffer smaller
+    increases the risk of underruns, because the device runs dry as soon as
+    a single buffer fill is late.
+
+    In low-latency mode, the device buffer is split into smaller 'periods',
+    and the stream buffer is refilled (and the stream callback called) once
+    per period, while the device is still playing the remaining periods.
+    To enable low-latency mode, set saudio_desc.period_frames:
+
+        saudio_setup(&(saudio_desc){
+            .sample_rate = 48000,
+            .period_frames = 256,   // about 5 ms
+            .buffer_frames = 768,   // 3 periods, this is also the default
+        });
+
+    The actual number of frames per stream buffer fill can be queried
+    with:
+
+        int saudio_period_frames(void)
+
+    In the push model, period_frames must be a multiple of packet_frames,
+    and the push FIFO should hold at least a few periods.
+
+    Low-latency mode is currently supported by the ALSA backend and the
+    null backend. ALSA sets the device period size with
+    snd_pcm_hw_params_set_period_size_near() and reads back the period size
+    the device actually picked (in the push model rounded down to a multiple
+    of packet_frames), so saudio_period_frames() may differ from the
+    requested period_frames.
+
+    The other backends (CoreAudio, WASAPI, WebAudio and OpenSLES) don't
+    support low-latency mode. They ignore period_frames entirely (the
+    buffer_frames default stays at 2048 frames), and saudio_period_frames()
+    returns the stream buffer size.
+
+    The resulting output latency as measured by the backend is reported
+    in saudio_stats.latency_ms (see STATISTICS).
+
+    REAL-TIME AUDIO THREAD
+    ======================
+    By default, the audio threads created by Sokol Audio run with the
+    default scheduling policy of the process, and the audio buffers are
+    ordinary heap memory. If the rest of the application keeps the CPU
+    busy, or the system is low on memory, this may lead to dropouts.
+    The following opt-in options are provided in saudio_desc.realtime:
+
+        saudio_setup(&(saudio_desc){
+            .realtime = {
+                .policy = SAUDIO_SCHEDPOLICY_FIFO,
+                .priority = 0,
+                .lock_memory = true,
+                .flush_denormals = true
+            }
+        });
+
+    .policy
+        SAUDIO_SCHEDPOLICY_DEFAULT: don't change the thread priority
+        SAUDIO_SCHEDPOLICY_FIFO: use SCHED_FIFO (POSIX)
+        SAUDIO_SCHEDPOLICY_RR: use SCHED_RR (POSIX)
+
+        On Windows, both FIFO and RR set the thread priority to
+        THREAD_PRIORITY_TIME_CRITICAL.
+
+    .priority
+        The real-time priority for SCHED_FIFO or SCHED_RR, this is
+        clamped to the range allowed by the system, the default (0)
+        is the middle of the allowed range. Ignored on Windows.
+
+    .lock_memory
+        Lock the Sokol Audio state, the push FIFO, the mixer and resampler
+        state and the backend's stream buffers into physical memory with
+        mlock() (POSIX) or VirtualLock() (Windows), so that the audio
+        thread never waits for a page fault. Note that the sample data
+        played by the mixer is owned by the application and isn't locked.
+
+    .flush_denormals
+        Enable flush-to-zero and denormals-are-zero mode while stream
+        buffers are filled (this includes the stream callback). Denormal
+        floats appear in decaying filters and reverb tails and can be
+        very slow to compute. This is supported on x86 with SSE (MXCSR
+        FTZ and DAZ bits) and on 64-bit ARM (FPCR FZ bit), on other
+        platforms the option is ignored. The previous floating point
+        mode is restored after each stream buffer.
+
+    The thread priority is applied to the threads which are created by
+    Sokol Audio (ALSA, WASAPI, OpenSLES and the null backend). CoreAudio
+    and WebAudio manage their own audio threads which already run with
+    a high priority, the policy is ignored there.
+
+    On Linux, unprivileged processes usually may not use real-time
+    scheduling policies or lock much memory. Sokol Audio doesn't attempt
+    to elevate the process (for instance via rtkit), instead the
+    privileges must be granted to the process, for instance with
+    RLIMIT_RTPRIO and RLIMIT_MEMLOCK in /etc/security/limits.conf, or
+    the CAP_SYS_NICE and CAP_IPC_LOCK capabilities. If changing the
+    priority or locking memory fails, Sokol Audio logs a message and
+    continues normally. To check whether the options were applied,
+    use saudio_query_stats():
+
+        realtime_thread     -- true if the audio thread runs with the
+                               requested scheduling policy
+        memory_locked       -- true if all audio buffers were locked
+
+    THE MIXER
+    =========
+    For simple sound effect playback, Sokol Audio has an optional built-in
+    mixer which plays PCM buffers on a fixed pool of 'voices'. The mixer
+    is enabled by setting saudio_desc.num_voices to the max number of
+    voices which can play at the same time:
+
+        saudio_setup(&(saudio_desc){
+            .num_voices = 128,
+        });
+
+    The voices are mixed on the audio thread into the stream buffer
+    after it has been filled by the stream callback or with pushed samples
+    (if neither provides any data, the voices are mixed into silence).
+    On x86 and ARM, the inner mixing loops use SSE or NEON, define
+    SAUDIO_NO_SIMD to use the plain C code instead.
+
+    To start playing a PCM buffer, call saudio_play():
+
+        saudio_voice voice = saudio_play(&(saudio_voice_desc){
+            .samples = samples,         // interleaved float samples
+            .num_frames = num_frames,
+            .num_channels = 2,          // mono or stereo
+            .volume = 0.5f,
+            .pan = -0.25f,
+            .loop = false,
+        });
+
+    saudio_play() returns an invalid voice handle (voice.id == 0) if all
+    voices are busy. The samples are not copied, the sample data must
+    remain valid until the voice has stopped playing!
+
+    A playing voice can be controlled with:
+
+        saudio_stop(voice);
+        saudio_voice_volume(voice, volume);
+        saudio_voice_pan(voice, pan);
+        saudio_voice_loop(voice, loop);
+
+    ...and saudio_voice_playing(voice) returns true until the voice has
+    reached the end of its buffer or was stopped. Calling those functions
+    with a voice that has stopped playing is a no-op.
+
+    The mixer functions are not thread-safe, they must be called from the
+    same thread (usually the main thread). They don't call into the
+    audio thread, instead they put commands into a wait-free command
+    queue which is drained on the audio thread before each mix. The size
+    of the command queue can be tweaked with saudio_desc.num_mixer_commands
+    (default: 256), if the command queue is full commands are dropped (this
+    is reported in saudio_mixer_stats.num_dropped_commands).
+
+    Use saudio_query_mixer_stats() to see how much time the mixer spends on
+    the audio thread, and how many voices are playing.
+
+    Mono voices are mixed into both channels of a stereo stream and panned
+    with a simple balance control, stereo voices are mixed down into a mono
+    stream. For streams with more than 2 channels, only the first 2 channels
+    are used by the mixer.
+
+    MULTIPLE STREAMS
+    ================
+    In addition to the main stream (provided by the stream callback or
+    saudio_push()), Sokol Audio can mix any number of additional streams
+    into the output, each with its own stream callback or push FIFO, and
+    its own gain. This is useful when independent parts of an application
+    (for instance music, voice chat and a synthesizer) each produce a
+    continuous stream of samples. Set saudio_desc.max_streams to the max
+    number of additional streams which can exist at the same time:
+
+        saudio_setup(&(saudio_desc){
+            .max_streams = 4,
+        });
+
+    A stream is created with saudio_make_stream():
+
+        saudio_stream music = saudio_make_stream(&(saudio_stream_desc){
+            .name = "music",
+            .gain = 0.5f,
+        });
+
+        saudio_stream synth = saudio_make_stream(&(saudio_stream_desc){
+            .name = "synth",
+            .stream_cb = synth_cb,      // called on the audio thread
+            .user_data = &synth_state,
+        });
+
+    If the stream has no stream_cb, samples are pushed into it in the
+    same format as for saudio_push_samples():
+
+        int num_frames = saudio_stream_expect(music);
+        ...
+        saudio_stream_push(music, frames, num_frames);
+
+    Each pushed stream has its own packet FIFO with the same size as the
+    main stream's FIFO (saudio_desc.packet_frames and num_packets). The
+    pushing functions (saudio_stream_push(), saudio_stream_push_samples()
+    and saudio_stream_expect()) for different streams may be called from
+    different threads, but each stream must only be pushed to from one
+    thread at a time. A stream must not be destroyed while another thread
+    is inside one of the pushing functions for that stream, so stop
+    pushing (for instance by joining the pushing thread) before calling
+    saudio_destroy_stream(). Pushing to a stream which has already been
+    destroyed is safe, it does nothing and returns 0.
+
+    Like the main stream callback, a stream callback must completely fill
+    the buffer it receives, its signature is:
+
+        void synth_cb(float* buffer, int num_frames, int num_channels, void* user_data);
+
+    saudio_make_stream() returns an invalid handle (stream.id == 0) if all
+    stream slots are in use. Streams can be looked up by name with
+    saudio_find_stream(), and the gain can be changed any time with:
+
+        saudio_stream_gain(music, 0.25f);
+
+    Gain changes are applied as a linear ramp over the next stream buffer,
+    a gain of 0.0 in saudio_stream_desc means 1.0 (the default), use
+    saudio_stream_gain() to start a stream muted.
+
+    saudio_destroy_stream(stream) removes a stream from the mix; when the
+    function returns, the audio thread may still be in the middle of
+    mixing the stream, so the stream callback and user data must remain
+    valid until the next stream buffer has been filled. The slot of a
+    destroyed stream becomes available again once the audio thread has
+    finished one more mix, which means that without a running audio
+    thread (for instance with the dummy backend) slots are never reused.
+
+    The streams are mixed on the audio thread before the mixer voices, at
+    the source sample rate (see SAMPLE RATE CONVERSION). The time each
+    stream spends on the audio thread is measured separately, use
+    saudio_query_stream_stats() to get the statistics of one stream:
+
+        name                -- the stream name
+        num_fills           -- number of times the stream was mixed
+                               (without the skipped buffers counted in
+                               num_silence_buffers)
+        num_silence_buffers -- number of buffers where the stream's push
+                               FIFO didn't have enough data (the stream
+                               is skipped in that case)
+        fill_avg_ms         -- moving average of the time to fill and mix
+                               the stream (skipped buffers not included)
+        fill_max_ms         -- max time to fill and mix the stream
+        cpu_load            -- fill_avg_ms relative to the buffer duration
+
+    The other stream functions are not thread-safe, they must be called
+    from the same thread as saudio_setup(). When
+    additional streams are used, saudio_desc.packet_frames must divide
+    the number of frames per stream buffer fill (see LOW-LATENCY MODE)
+    also in the callback model.
+
     THE WEBAUDIO BACKEND
     ====================
     The WebAudio backend is currently using a ScriptProcessorNode callback to
@@ -300,9 +703,6 @@
     Since the CoreAudio API is implemented in C (not Objective-C) the
     implementation part of Sokol Audio can be included into a C source file.
 
-    For thread synchronisation, the CoreAudio backend will use the
-    pthread_mutex_* functions.
-
     The incoming floating point samples will be directly forwarded to
     CoreAudio without further conversion.
 
@@ -314,8 +714,6 @@
     The WASAPI backend is automatically selected when compiling on Windows
     (_WIN32 is defined).
 
-    For thread synchronisation a Win32 critical section is used.
-
     WASAPI may use a different size for its own streaming buffer then requested,
     so the base latency may be slightly bigger. The current backend implementation
     converts the incoming floating point sample values to signed 16-bit
@@ -330,8 +728,6 @@
     The ALSA backend is automatically selected when compiling on Linux
     ('linux' is defined).
 
-    For thread synchronisation, the pthread_mutex_* functions are used.
-
     Samples are directly forwarded to ALSA in 32-bit float format, no
     further conversion is taking place.
 
@@ -339,6 +735,37 @@
     header must be present (usually both are installed with some sort
     of ALSA development package).
 
+    THE NULL BACKEND
+    ================
+    The null backend doesn't talk to any audio device, instead it pulls
+    audio data (either from the stream callback, or from the pushed
+    packets) on a timer-driven thread at the configured sample rate. This
+    is useful on machines without sound hardware, e.g. to run tests and
+    benchmarks for the audio path on headless CI machines.
+
+    Unlike SOKOL_DUMMY_BACKEND, the null backend is selected at runtime
+    through the nested saudio_desc.null_backend struct:
+
+        saudio_setup(&(saudio_desc){
+            .stream_cb = stream_cb,
+            .null_backend = {
+                .enabled = true,
+                .speed = 4.0f,              // run at 4x real-time
+                .wav_path = "out.wav",      // optional WAV output
+            }
+        });
+
+    - speed: the playback speed relative to real-time, default is 1.0
+    - unthrottled: if true, the timer is disabled and the stream buffer
+      is rendered back-to-back as fast as possible; note that this
+      only makes sense with the stream callback model, with the push model
+      the audio thread would mostly see an empty packet queue
+    - wav_path: if not null, the stream output is written to a WAV file
+      (32-bit float samples), the header is finalized in saudio_shutdown()
+
+    The null backend needs threads, it isn't available on emscripten (in
+    this case saudio_setup() will fail).
+
     LICENSE
     =======
 
@@ -383,17 +810,141 @@
 extern "C" {
 #endif
 
+/* sample formats for saudio_push_samples(), see SAMPLE FORMATS */
+typedef enum saudio_sample_format {
+    SAUDIO_SAMPLEFORMAT_DEFAULT,    /* same as FLOAT32 */
+    SAUDIO_SAMPLEFORMAT_FLOAT32,
+    SAUDIO_SAMPLEFORMAT_INT16,
+    SAUDIO_SAMPLEFORMAT_INT24,      /* packed 3 bytes per sample, little endian */
+    _SAUDIO_SAMPLEFORMAT_NUM,
+    _SAUDIO_SAMPLEFORMAT_FORCE_U32 = 0x7FFFFFFF
+} saudio_sample_format;
+
+/* resampler quality presets, see SAMPLE RATE CONVERSION */
+typedef enum saudio_resampler_quality {
+    SAUDIO_RESAMPLER_QUALITY_DEFAULT,   /* same as MEDIUM */
+    SAUDIO_RESAMPLER_QUALITY_LOW,
+    SAUDIO_RESAMPLER_QUALITY_MEDIUM,
+    SAUDIO_RESAMPLER_QUALITY_HIGH,
+    _SAUDIO_RESAMPLER_QUALITY_NUM,
+    _SAUDIO_RESAMPLER_QUALITY_FORCE_U32 = 0x7FFFFFFF
+} saudio_resampler_quality;
+
+/* scheduling policies for the audio thread, see REAL-TIME AUDIO THREAD */
+typedef enum saudio_sched_policy {
+    SAUDIO_SCHEDPOLICY_DEFAULT,     /* don't change the thread priority */
+    SAUDIO_SCHEDPOLICY_FIFO,
+    SAUDIO_SCHEDPOLICY_RR,
+    _SAUDIO_SCHEDPOLICY_NUM,
+    _SAUDIO_SCHEDPOLICY_FORCE_U32 = 0x7FFFFFFF
+} saudio_sched_policy;
+
+/* real-time options for the audio thread, see REAL-TIME AUDIO THREAD */
+typedef struct saudio_realtime_desc {
+    saudio_sched_policy policy;     /* scheduling policy of the audio thread */
+    int priority;                   /* real-time priority, default: middle of the allowed range */
+    bool lock_memory;               /* lock audio buffers into physical memory */
+    bool flush_denormals;           /* enable FTZ/DAZ mode while filling stream buffers */
+} saudio_realtime_desc;
+
+/* options for the null backend, see THE NULL BACKEND */
+typedef struct saudio_null_backend_desc {
+    bool enabled;           /* use the null backend instead of the platform's audio backend */
+    float speed;            /* playback speed relative to real-time, default: 1.0 */
+    bool unthrottled;       /* if true, run the stream as fast as possible */
+    const char* wav_path;   /* optional: write the stream output to a WAV file */
+} saudio_null_backend_desc;
+
 typedef struct saudio_desc {
     int sample_rate;        /* requested sample rate */
     int num_channels;       /* number of channels, default: 1 (mono) */
     int buffer_frames;      /* number of frames in streaming buffer */
+    int period_frames;      /* optional: number of frames per stream callback (low-latency mode), default: buffer_frames */
     int packet_frames;      /* number of frames in a packet */
     int num_packets;        /* number of packets in packet queue */
     void (*stream_cb)(float* buffer, int num_frames, int num_channels);  /* optional streaming callback (no user data) */
     void (*stream_userdata_cb)(float* buffer, int num_frames, int num_channels, void* user_data); /*... and with user data */
     void* user_data;        /* optional user data argument for stream_userdata_cb */
+    saudio_null_backend_desc null_backend; /* optional: use the null backend */
+    int num_voices;         /* optional: number of mixer voices, default: 0 (no mixer) */
+    int num_mixer_commands; /* size of the mixer command queue, default: 256 */
+    int source_sample_rate; /* optional: sample rate of the audio data provided by the app, default: 0 (no resampling) */
+    saudio_resampler_quality resampler_quality; /* quality preset for the resampler */
+    saudio_sample_format sample_format; /* format of pushed samples, default: FLOAT32 */
+    saudio_realtime_desc realtime; /* optional: real-time options for the audio thread */
+    int max_streams;        /* optional: max number of additional streams, default: 0 (see MULTIPLE STREAMS) */
 } saudio_desc;
 
+/* number of buckets in the saudio_stats.fill_histogram */
+#define SAUDIO_STATS_HISTOGRAM_SIZE (16)
+
+/* audio thread statistics, returned by saudio_query_stats(), see STATISTICS */
+typedef struct saudio_stats {
+    uint32_t num_buffers;           /* number of stream buffers filled */
+    uint32_t num_underruns;         /* number of underruns detected by the audio backend */
+    uint32_t num_silence_buffers;   /* number of buffers filled with silence because the push FIFO ran dry */
+    int fifo_min_frames;            /* min number of frames queued in the push FIFO */
+    int fifo_avg_frames;            /* moving average of frames queued in the push FIFO */
+    int fifo_max_frames;            /* max number of frames queued in the push FIFO */
+    float fill_avg_ms;              /* moving average of the time to fill a stream buffer */
+    float fill_max_ms;              /* max time to fill a stream buffer */
+    uint32_t fill_histogram[SAUDIO_STATS_HISTOGRAM_SIZE];   /* histogram of fill times, see STATISTICS */
+    float latency_ms;               /* output latency (measured if supported by the backend, otherwise estimated) */
+    bool latency_measured;          /* true if latency_ms was measured by the backend */
+    bool realtime_thread;           /* true if the audio thread runs with the requested scheduling policy */
+    bool memory_locked;             /* true if all audio buffers are locked into physical memory */
+} saudio_stats;
+
+/* a mixer voice handle, returned by saudio_play() */
+typedef struct saudio_voice { uint32_t id; } saudio_voice;
+
+/* parameters for playing a PCM buffer on a mixer voice */
+typedef struct saudio_voice_desc {
+    const float* samples;   /* interleaved 32-bit float samples, must remain valid while playing */
+    int num_frames;         /* number of frames in samples */
+    int num_channels;       /* 1 (mono) or 2 (stereo), default: 1 */
+    float volume;           /* default: 1.0 */
+    float pan;              /* -1.0 (left) .. +1.0 (right), default: 0.0 (center) */
+    bool loop;              /* if true, restart at the end of the buffer */
+} saudio_voice_desc;
+
+/* mixer statistics, returned by saudio_query_mixer_stats() */
+typedef struct saudio_mixer_stats {
+    int num_voices;             /* size of the voice pool */
+    int num_playing_voices;     /* number of voices mixed in the last audio callback */
+    int max_playing_voices;     /* max number of voices mixed in one audio callback */
+    uint32_t num_mix_calls;     /* number of times the mixer ran on the audio thread */
+    float last_mix_ms;          /* duration of the last mix in milliseconds */
+    float avg_mix_ms;           /* moving average of the mix duration */
+    float max_mix_ms;           /* max mix duration */
+    float cpu_load;             /* avg_mix_ms relative to the buffer duration (0.0 .. 1.0) */
+    int num_dropped_commands;   /* commands dropped because the command queue was full */
+} saudio_mixer_stats;
+
+/* max length of a stream name, including the terminating zero */
+#define SAUDIO_STREAM_NAME_SIZE (32)
+
+/* an additional stream handle, returned by saudio_make_stream() */
+typedef struct saudio_stream { uint32_t id; } saudio_stream;
+
+/* parameters for creating an additional stream, see MULTIPLE STREAMS */
+typedef struct saudio_stream_desc {
+    const char* name;       /* optional: name for saudio_find_stream() and the statistics */
+    void (*stream_cb)(float* buffer, int num_frames, int num_channels, void* user_data); /* optional: stream callback, otherwise samples are pushed */
+    void* user_data;        /* optional user data argument for stream_cb */
+    float gain;             /* default: 1.0 */
+} saudio_stream_desc;
+
+/* per-stream statistics, returned by saudio_query_stream_stats() */
+typedef struct saudio_stream_stats {
+    char name[SAUDIO_STREAM_NAME_SIZE];
+    uint32_t num_fills;             /* number of times the stream was mixed (skipped buffers not included) */
+    uint32_t num_silence_buffers;   /* number of buffers skipped because the stream's push FIFO ran dry */
+    float fill_avg_ms;              /* moving average of the time to fill and mix the stream */
+    float fill_max_ms;              /* max time to fill and mix the stream */
+    float cpu_load;                 /* fill_avg_ms relative to the buffer duration (0.0 .. 1.0) */
+} saudio_stream_stats;
+
 /* setup sokol-audio */
 SOKOL_API_DECL void saudio_setup(const saudio_desc* desc);
 /* shutdown sokol-audio */
@@ -408,18 +959,58 @@ SOKOL_API_DECL saudio_desc saudio_query_desc(void);
 SOKOL_API_DECL int saudio_sample_rate(void);
 /* return actual backend buffer size in number of frames */
 SOKOL_API_DECL int saudio_buffer_frames(void);
+/* actual number of frames per stream buffer fill (see LOW-LATENCY MODE) */
+SOKOL_API_DECL int saudio_period_frames(void);
 /* actual number of channels */
 SOKOL_API_DECL int saudio_channels(void);
 /* get current number of frames to fill packet queue */
 SOKOL_API_DECL int saudio_expect(void);
 /* push sample frames from main thread, returns number of frames actually pushed */
 SOKOL_API_DECL int saudio_push(const float* frames, int num_frames);
+/* push sample frames in the format defined by saudio_desc.sample_format, returns number of frames actually pushed */
+SOKOL_API_DECL int saudio_push_samples(const void* samples, int num_frames);
+/* start playing a PCM buffer on a free mixer voice, returns an invalid handle (id == 0) if no voice is free */
+SOKOL_API_DECL saudio_voice saudio_play(const saudio_voice_desc* desc);
+/* stop a playing voice */
+SOKOL_API_DECL void saudio_stop(saudio_voice voice);
+/* change the volume of a playing voice */
+SOKOL_API_DECL void saudio_voice_volume(saudio_voice voice, float volume);
+/* change the pan position of a playing voice */
+SOKOL_API_DECL void saudio_voice_pan(saudio_voice voice, float pan);
+/* enable or disable looping of a playing voice */
+SOKOL_API_DECL void saudio_voice_loop(saudio_voice voice, bool loop);
+/* true if the voice is still playing */
+SOKOL_API_DECL bool saudio_voice_playing(saudio_voice voice);
+/* get mixer statistics */
+SOKOL_API_DECL saudio_mixer_stats saudio_query_mixer_stats(void);
+/* get audio thread statistics */
+SOKOL_API_DECL saudio_stats saudio_query_stats(void);
+/* reset the audio thread statistics (asynchronously, on the next audio callback) */
+SOKOL_API_DECL void saudio_reset_stats(void);
+/* create an additional stream, returns an invalid handle (id == 0) if no stream slot is free */
+SOKOL_API_DECL saudio_stream saudio_make_stream(const saudio_stream_desc* desc);
+/* remove an additional stream from the mix */
+SOKOL_API_DECL void saudio_destroy_stream(saudio_stream stream);
+/* find an additional stream by name, returns an invalid handle if not found */
+SOKOL_API_DECL saudio_stream saudio_find_stream(const char* name);
+/* change the gain of an additional stream */
+SOKOL_API_DECL void saudio_stream_gain(saudio_stream stream, float gain);
+/* get current number of frames to fill the packet queue of an additional stream */
+SOKOL_API_DECL int saudio_stream_expect(saudio_stream stream);
+/* push sample frames into an additional stream, returns number of frames actually pushed */
+SOKOL_API_DECL int saudio_stream_push(saudio_stream stream, const float* frames, int num_frames);
+/* push sample frames in the format defined by saudio_desc.sample_format into an additional stream */
+SOKOL_API_DECL int saudio_stream_push_samples(saudio_stream stream, const void* samples, int num_frames);
+/* get the statistics of an additional stream */
+SOKOL_API_DECL saudio_stream_stats saudio_query_stream_stats(saudio_stream stream);
 
 #ifdef __cplusplus
 } /* extern "C" */
 
 /* reference-based equivalents for c++ */
 inline void saudio_setup(const saudio_desc& desc) { return saudio_setup(&desc); }
+inline saudio_voice saudio_play(const saudio_voice_desc& desc) { return saudio_play(&desc); }
+inline saudio_stream saudio_make_stream(const saudio_stream_desc& desc) { return saudio_make_stream(&desc); }
 
 #endif
 #endif // SOKOL_AUDIO_INCLUDED
@@ -427,7 +1018,8 @@ inline void saudio_setup(const saudio_desc& desc) { return saudio_setup(&desc);
 /*=== IMPLEMENTATION =========================================================*/
 #ifdef SOKOL_IMPL
 #define SOKOL_AUDIO_IMPL_INCLUDED (1)
-#include <string.h> /* memset, memcpy */
+#include <string.h> /* memset, memcpy, strncpy */
+#include <stdio.h>  /* FILE, fopen, fwrite (null backend WAV output) */
 
 #ifndef SOKOL_API_IMPL
     #define SOKOL_API_IMPL
@@ -467,11 +1059,18 @@ inline void saudio_setup(const saudio_desc& desc) { return saudio_setup(&desc);
     #define _SOKOL_UNUSED(x) (void)(x)
 #endif
 
-#if defined(SOKOL_DUMMY_BACKEND)
-    // No threads needed for SOKOL_DUMMY_BACKEND
-#elif (defined(__APPLE__) || defined(__linux__) || defined(__unix__)) && !defined(__EMSCRIPTEN__)
+#if defined(_MSC_VER)
+    #include <intrin.h>     /* _InterlockedOr, _InterlockedExchange */
+#endif
+
+/* threads are needed by the platform backends and the null backend */
+#if (defined(__APPLE__) || defined(__linux__) || defined(__unix__)) && !defined(__EMSCRIPTEN__)
+    #define _SAUDIO_PTHREADS (1)
     #include <pthread.h>
+    #include <time.h>   /* clock_gettime, nanosleep */
+    #include <sys/mman.h>   /* mlock, munlock */
 #elif defined(_WIN32)
+    #define _SAUDIO_WINTHREADS (1)
     #ifndef WIN32_LEAN_AND_MEAN
     #define WIN32_LEAN_AND_MEAN
     #endif
@@ -491,6 +1090,7 @@ inline void saudio_setup(const saudio_desc& desc) { return saudio_setup(&desc);
 #elif (defined(__linux__) || defined(__unix__)) && !defined(__EMSCRIPTEN__) && !defined(__ANDROID__)
     #define ALSA_PCM_NEW_HW_PARAMS_API
     #include <alsa/asoundlib.h>
+    #define _SAUDIO_LOW_LATENCY_BACKEND (1)
 #elif defined(__ANDROID__)
     #include "SLES/OpenSLES_Android.h"
 #elif defined(_WIN32)
@@ -525,6 +1125,26 @@ inline void saudio_setup(const saudio_desc& desc) { return saudio_setup(&desc);
     #include <emscripten/emscripten.h>
 #endif
 
+/* the SSE control register is needed for flush-to-zero mode, even with SAUDIO_NO_SIMD */
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1))
+    #define _SAUDIO_SSE_CSR (1)
+    #include <xmmintrin.h>
+#endif
+
+#if !defined(SAUDIO_NO_SIMD)
+    #if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1))
+        #define _SAUDIO_SSE (1)
+        #include <xmmintrin.h>
+        #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+            #define _SAUDIO_SSE2 (1)
+            #include <emmintrin.h>
+        #endif
+    #elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+        #define _SAUDIO_NEON (1)
+        #include <arm_neon.h>
+    #endif
+#endif
+
 #ifdef _MSC_VER
     #pragma warning(push)
     #pragma warning(disable:4505)   /* unreferenced local function has been removed */
@@ -537,32 +1157,14 @@ inline void saudio_setup(const saudio_desc& desc) { return saudio_setup(&desc);
 #define _SAUDIO_DEFAULT_BUFFER_FRAMES (2048)
 #define _SAUDIO_DEFAULT_PACKET_FRAMES (128)
 #define _SAUDIO_DEFAULT_NUM_PACKETS ((_SAUDIO_DEFAULT_BUFFER_FRAMES/_SAUDIO_DEFAULT_PACKET_FRAMES)*4)
+#define _SAUDIO_DEFAULT_NUM_MIXER_COMMANDS (256)
+#define _SAUDIO_MAX_VOICES (0xFFFF)
+#define _SAUDIO_MAX_STREAMS (0xFFFF)
 
 #ifndef SAUDIO_RING_MAX_SLOTS
 #define SAUDIO_RING_MAX_SLOTS (1024)
 #endif
 
-/*=== MUTEX WRAPPER DECLARATIONS =============================================*/
-#if defined(SOKOL_DUMMY_BACKEND)
-
-typedef struct { int dummy_mutex; } _saudio_mutex_t;
-
-#elif (defined(__APPLE__) || defined(__linux__) || defined(__unix__)) && !defined(__EMSCRIPTEN__)
-
-typedef struct {
-    pthread_mutex_t mutex;
-} _saudio_mutex_t;
-
-#elif defined(_WIN32)
-
-typedef struct {
-    CRITICAL_SECTION critsec;
-} _saudio_mutex_t;
-
-#else
-typedef struct { int dummy_mutex; } _saudio_mutex_t;
-#endif
-
 /*=== DUMMY BACKEND DECLARATIONS =============================================*/
 #if defined(SOKOL_DUMMY_BACKEND)
 typedef struct {
@@ -627,6 +1229,7 @@ typedef struct {
     HANDLE buffer_end_event;
     bool stop;
     UINT32 dst_buffer_frames;
+    UINT32 stream_latency_frames;   /* IAudioClient_GetStreamLatency() in frames */
     int src_buffer_frames;
     int src_buffer_byte_size;
     int src_buffer_pos;
@@ -653,29 +1256,180 @@ typedef struct {
 #else
 typedef struct { } _saudio_backend_t;
 #endif
+/*=== NULL BACKEND DECLARATIONS ==============================================*/
+typedef struct {
+    float* buffer;
+    int buffer_frames;
+    int buffer_byte_size;
+    double speed;
+    bool unthrottled;
+    FILE* wav_file;
+    uint32_t wav_data_bytes;
+    uint32_t thread_stop;       /* atomic */
+    #if defined(_SAUDIO_PTHREADS)
+    pthread_t thread;
+    #elif defined(_SAUDIO_WINTHREADS)
+    HANDLE thread;
+    #endif
+} _saudio_null_backend_t;
+
 /*=== GENERAL DECLARATIONS ===================================================*/
 
-/* a ringbuffer structure */
+/* a single-producer/single-consumer ringbuffer structure, head is only
+    written by the producer, tail is only written by the consumer
+*/
 typedef struct {
-    uint32_t head;  /* next slot to write to */
-    uint32_t tail;  /* next slot to read from */
+    uint32_t head;  /* next slot to write to (atomic) */
+    uint32_t tail;  /* next slot to read from (atomic) */
     uint32_t num;   /* number of slots in queue */
     uint32_t queue[SAUDIO_RING_MAX_SLOTS];
 } _saudio_ring_t;
 
 /* a packet FIFO structure */
 typedef struct {
-    bool valid;
+    uint32_t valid;             /* atomic, set after the fifo is initialized */
     int packet_size;            /* size of a single packets in bytes(!) */
     int num_packets;            /* number of packet in fifo */
     uint8_t* base_ptr;          /* packet memory chunk base pointer (dynamically allocated) */
     int cur_packet;             /* current write-packet */
     int cur_offset;             /* current byte-offset into current write packet */
-    _saudio_mutex_t mutex;      /* mutex for thread-safe access */
     _saudio_ring_t read_queue;  /* buffers with data, ready to be streamed */
     _saudio_ring_t write_queue; /* empty buffers, ready to be pushed to */
 } _saudio_fifo_t;
 
+/* mixer commands, sent from the main thread to the audio thread */
+typedef enum {
+    _SAUDIO_MIXER_CMD_PLAY,
+    _SAUDIO_MIXER_CMD_STOP,
+    _SAUDIO_MIXER_CMD_VOLUME,
+    _SAUDIO_MIXER_CMD_PAN,
+    _SAUDIO_MIXER_CMD_LOOP
+} _saudio_mixer_cmd_type_t;
+
+typedef struct {
+    _saudio_mixer_cmd_type_t type;
+    uint32_t voice_id;
+    const float* samples;
+    int num_frames;
+    int num_channels;
+    float volume;
+    float pan;
+    bool loop;
+} _saudio_mixer_cmd_t;
+
+/* a single-producer/single-consumer command queue */
+typedef struct {
+    uint32_t head;              /* atomic, written by main thread */
+    uint32_t tail;              /* atomic, written by audio thread */
+    uint32_t num;
+    _saudio_mixer_cmd_t* cmds;
+} _saudio_mixer_cmd_queue_t;
+
+/* a voice as seen by the audio thread */
+typedef struct {
+    uint32_t id;                /* 0 if not playing */
+    const float* samples;
+    int num_frames;
+    int num_channels;
+    int pos;                    /* current frame position */
+    float volume;
+    float pan;
+    bool loop;
+} _saudio_voice_t;
+
+typedef struct {
+    bool valid;
+    int num_voices;
+    uint32_t unique_counter;    /* main thread: for creating voice ids */
+    uint32_t* voice_ids;        /* main thread: currently assigned voice ids, 0 for free slots */
+    uint32_t* finished_ids;     /* atomic, written by audio thread when a voice stopped playing */
+    _saudio_voice_t* voices;    /* audio thread: voice state */
+    _saudio_mixer_cmd_queue_t cmd_queue;
+    int num_dropped_commands;   /* main thread */
+    /* statistics, atomic, written by audio thread */
+    struct {
+        uint32_t num_mix_calls;
+        uint32_t num_playing_voices;
+        uint32_t max_playing_voices;
+        uint32_t last_num_frames;
+        uint32_t last_mix_ns;
+        uint32_t avg_mix_ns;
+        uint32_t max_mix_ns;
+    } stats;
+} _saudio_mixer_t;
+
+/* resampler state, published to the audio thread after the backend is initialized */
+typedef enum {
+    _SAUDIO_RESAMPLER_STATE_PENDING,    /* not initialized yet, output silence */
+    _SAUDIO_RESAMPLER_STATE_BYPASS,     /* source and device sample rate are identical */
+    _SAUDIO_RESAMPLER_STATE_ACTIVE
+} _saudio_resampler_state_t;
+
+typedef struct {
+    uint32_t state;             /* atomic, _saudio_resampler_state_t */
+    int num_channels;
+    int num_taps;
+    int num_phases;
+    float* coeffs;              /* (num_phases + 1) * num_taps filter coefficients */
+    int block_frames;           /* number of source frames pulled at once */
+    float* block;               /* interleaved source block */
+    int capacity;               /* capacity of the history buffer per channel in frames */
+    float* history;             /* planar source history, num_channels * capacity */
+    int num_frames;             /* number of valid frames in history */
+    double pos;                 /* fractional read position in history */
+    double step;                /* source_rate / device_rate */
+} _saudio_resampler_t;
+
+/* an additional stream, see MULTIPLE STREAMS */
+typedef struct {
+    uint32_t id;                /* main thread: stream id, 0 if the slot is unused */
+    uint32_t active_id;         /* atomic: stream id while the audio thread may mix the stream, 0 otherwise */
+    bool retired;               /* main thread: destroyed, the slot is free after the audio thread finished retire_epoch */
+    uint32_t retire_epoch;      /* main thread: mix epoch when the stream was destroyed */
+    char name[SAUDIO_STREAM_NAME_SIZE];
+    void (*stream_cb)(float* buffer, int num_frames, int num_channels, void* user_data);
+    void* user_data;
+    _saudio_fifo_t fifo;        /* packet fifo for pushed samples */
+    uint32_t gain;              /* atomic: target gain as float bits */
+    uint32_t mixed_id;          /* audio thread: id of the stream which was last mixed from this slot */
+    float cur_gain;             /* audio thread: gain at the end of the last mix */
+    /* statistics, atomic, written by audio thread */
+    struct {
+        uint32_t num_fills;
+        uint32_t num_silence_buffers;
+        uint32_t last_num_frames;
+        uint32_t fill_avg_ns;
+        uint32_t fill_max_ns;
+    } stats;
+} _saudio_stream_t;
+
+typedef struct {
+    bool valid;
+    int num_streams;
+    uint32_t unique_counter;    /* main thread: for creating stream ids */
+    uint32_t epoch;             /* atomic, incremented by the audio thread after each mix */
+    uint32_t reset_done;        /* audio thread: last handled stats reset request */
+    _saudio_stream_t* streams;
+    int scratch_frames;
+    float* scratch;             /* audio thread: buffer for filling a single stream */
+} _saudio_streams_t;
+
+/* audio thread statistics, written by the audio thread, read by any thread */
+typedef struct {
+    uint32_t reset_request;     /* atomic, incremented by saudio_reset_stats() */
+    uint32_t reset_done;        /* audio thread private, last handled reset_request */
+    uint32_t num_buffers;
+    uint32_t num_underruns;
+    uint32_t num_silence_buffers;
+    uint32_t fifo_min_frames;   /* 0xFFFFFFFF if not sampled yet */
+    uint32_t fifo_avg_frames;
+    uint32_t fifo_max_frames;
+    uint32_t fill_avg_ns;
+    uint32_t fill_max_ns;
+    uint32_t fill_histogram[SAUDIO_STATS_HISTOGRAM_SIZE];
+    uint32_t latency_frames;    /* reported by the backend, 0 if unknown */
+} _saudio_stats_t;
+
 /* sokol-audio state */
 typedef struct {
     bool valid;
@@ -684,13 +1438,26 @@ typedef struct {
     void* user_data;
     int sample_rate;            /* sample rate */
     int buffer_frames;          /* number of frames in streaming buffer */
+    int period_frames;          /* number of frames per stream buffer fill, buffer_frames if not supported by backend */
     int bytes_per_frame;        /* filled by backend */
+    saudio_sample_format sample_format; /* format of pushed samples */
+    int push_bytes_per_frame;   /* bytes per frame of pushed samples (in the packet fifo) */
     int packet_frames;          /* number of frames in a packet */
     int num_packets;            /* number of packets in packet queue */
     int num_channels;           /* actual number of channels */
     saudio_desc desc;
     _saudio_fifo_t fifo;
+    _saudio_mixer_t mixer;
+    _saudio_streams_t streams;
+    _saudio_stats_t stats;
+    int source_sample_rate;     /* 0 if the resampler isn't used */
+    _saudio_resampler_t resampler;
+    bool use_null_backend;      /* true if the null backend is used instead of backend */
+    uint32_t setup_done;        /* atomic, set at the end of saudio_setup() */
+    uint32_t realtime_thread;   /* atomic, set by the audio thread if the scheduling policy was applied */
+    bool mem_lock_failed;       /* main thread, set if locking any audio buffer failed */
     _saudio_backend_t backend;
+    _saudio_null_backend_t null_backend;
 } _saudio_state_t;
 
 static _saudio_state_t _saudio;
@@ -708,53 +1475,133 @@ _SOKOL_PRIVATE void _saudio_stream_callback(float* buffer, int num_frames, int n
     }
 }
 
-/*=== MUTEX IMPLEMENTATION ===================================================*/
-#if defined(SOKOL_DUMMY_BACKEND)
-_SOKOL_PRIVATE void _saudio_mutex_init(_saudio_mutex_t* m) { (void)m; }
-_SOKOL_PRIVATE void _saudio_mutex_destroy(_saudio_mutex_t* m) { (void)m; }
-_SOKOL_PRIVATE void _saudio_mutex_lock(_saudio_mutex_t* m) { (void)m; }
-_SOKOL_PRIVATE void _saudio_mutex_unlock(_saudio_mutex_t* m) { (void)m; }
-#elif (defined(__APPLE__) || defined(__linux__) || defined(__unix__)) && !defined(__EMSCRIPTEN__)
-_SOKOL_PRIVATE void _saudio_mutex_init(_saudio_mutex_t* m) {
-    pthread_mutexattr_t attr;
-    pthread_mutexattr_init(&attr);
-    pthread_mutex_init(&m->mutex, &attr);
+/*=== ATOMIC WRAPPERS =======================================================*/
+/* load-acquire and store-release for the packet fifo's shared indices */
+#if defined(_MSC_VER)
+_SOKOL_PRIVATE uint32_t _saudio_atomic_load(uint32_t* ptr) {
+    return (uint32_t) _InterlockedOr((volatile long*)ptr, 0);
+}
+
+_SOKOL_PRIVATE void _saudio_atomic_store(uint32_t* ptr, uint32_t val) {
+    _InterlockedExchange((volatile long*)ptr, (long)val);
+}
+#elif defined(__GNUC__) || defined(__clang__)
+_SOKOL_PRIVATE uint32_t _saudio_atomic_load(uint32_t* ptr) {
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
 }
 
-_SOKOL_PRIVATE void _saudio_mutex_destroy(_saudio_mutex_t* m) {
-    pthread_mutex_destroy(&m->mutex);
+_SOKOL_PRIVATE void _saudio_atomic_store(uint32_t* ptr, uint32_t val) {
+    __atomic_store_n(ptr, val, __ATOMIC_RELEASE);
+}
+#elif !defined(__cplusplus) && defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+_SOKOL_PRIVATE uint32_t _saudio_atomic_load(uint32_t* ptr) {
+    return atomic_load_explicit((_Atomic uint32_t*)ptr, memory_order_acquire);
 }
 
-_SOKOL_PRIVATE void _saudio_mutex_lock(_saudio_mutex_t* m) {
-    pthread_mutex_lock(&m->mutex);
+_SOKOL_PRIVATE void _saudio_atomic_store(uint32_t* ptr, uint32_t val) {
+    atomic_store_explicit((_Atomic uint32_t*)ptr, val, memory_order_release);
 }
+#else
+#error "sokol_audio.h: no atomic load/store for this compiler (needs MSVC, GCC, clang or C11 atomics)"
+#endif
 
-_SOKOL_PRIVATE void _saudio_mutex_unlock(_saudio_mutex_t* m) {
-    pthread_mutex_unlock(&m->mutex);
+/*=== REAL-TIME THREAD SUPPORT ===============================================*/
+/* lock a buffer which is accessed by the audio thread into physical memory */
+_SOKOL_PRIVATE void _saudio_mem_lock(void* ptr, size_t num_bytes) {
+    if (!_saudio.desc.realtime.lock_memory || (0 == ptr) || (0 == num_bytes)) {
+        return;
+    }
+    #if defined(_SAUDIO_PTHREADS)
+        const bool locked = (0 == mlock(ptr, num_bytes));
+    #elif defined(_SAUDIO_WINTHREADS)
+        const bool locked = (FALSE != VirtualLock(ptr, num_bytes));
+    #else
+        const bool locked = false;
+    #endif
+    if (!locked) {
+        if (!_saudio.mem_lock_failed) {
+            SOKOL_LOG("sokol_audio.h: failed to lock audio buffers into memory (check RLIMIT_MEMLOCK)");
+        }
+        _saudio.mem_lock_failed = true;
+    }
 }
 
-#elif defined(_WIN32)
-_SOKOL_PRIVATE void _saudio_mutex_init(_saudio_mutex_t* m) {
-    InitializeCriticalSection(&m->critsec);
+/* unlock a buffer before it is freed */
+_SOKOL_PRIVATE void _saudio_mem_unlock(void* ptr, size_t num_bytes) {
+    if (!_saudio.desc.realtime.lock_memory || (0 == ptr) || (0 == num_bytes)) {
+        return;
+    }
+    #if defined(_SAUDIO_PTHREADS)
+        munlock(ptr, num_bytes);
+    #elif defined(_SAUDIO_WINTHREADS)
+        VirtualUnlock(ptr, num_bytes);
+    #endif
 }
 
-_SOKOL_PRIVATE void _saudio_mutex_destroy(_saudio_mutex_t* m) {
-    DeleteCriticalSection(&m->critsec);
+/* called at the start of audio threads created by sokol_audio.h */
+_SOKOL_PRIVATE void _saudio_thread_init(void) {
+    const saudio_realtime_desc* rt = &_saudio.desc.realtime;
+    if (SAUDIO_SCHEDPOLICY_DEFAULT == rt->policy) {
+        return;
+    }
+    #if defined(_SAUDIO_PTHREADS)
+        const int policy = (SAUDIO_SCHEDPOLICY_RR == rt->policy) ? SCHED_RR : SCHED_FIFO;
+        const int min_prio = sched_get_priority_min(policy);
+        const int max_prio = sched_get_priority_max(policy);
+        int prio = (0 == rt->priority) ? ((min_prio + max_prio) / 2) : rt->priority;
+        if (prio < min_prio) {
+            prio = min_prio;
+        }
+        else if (prio > max_prio) {
+            prio = max_prio;
+        }
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = prio;
+        const bool applied = (0 == pthread_setschedparam(pthread_self(), policy, &param));
+    #elif defined(_SAUDIO_WINTHREADS)
+        const bool applied = (FALSE != SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL));
+    #else
+        const bool applied = false;
+    #endif
+    if (applied) {
+        _saudio_atomic_store(&_saudio.realtime_thread, 1);
+    }
+    else {
+        SOKOL_LOG("sokol_audio.h: failed to set real-time priority of audio thread (check RLIMIT_RTPRIO)");
+    }
 }
 
-_SOKOL_PRIVATE void _saudio_mutex_lock(_saudio_mutex_t* m) {
-    EnterCriticalSection(&m->critsec);
+/* enable flush-to-zero (and denormals-are-zero) mode, returns the previous mode */
+_SOKOL_PRIVATE uint64_t _saudio_denormals_disable(void) {
+    #if defined(_SAUDIO_SSE_CSR)
+        const uint32_t csr = _mm_getcsr();
+        #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+            _mm_setcsr(csr | 0x8040);   /* FTZ | DAZ */
+        #else
+            _mm_setcsr(csr | 0x8000);   /* FTZ, early SSE CPUs don't have DAZ */
+        #endif
+        return csr;
+    #elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+        uint64_t fpcr;
+        __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+        __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr | (1ULL << 24)));   /* FZ */
+        return fpcr;
+    #else
+        return 0;
+    #endif
 }
 
-_SOKOL_PRIVATE void _saudio_mutex_unlock(_saudio_mutex_t* m) {
-    LeaveCriticalSection(&m->critsec);
+_SOKOL_PRIVATE void _saudio_denormals_restore(uint64_t mode) {
+    #if defined(_SAUDIO_SSE_CSR)
+        _mm_setcsr((uint32_t)mode);
+    #elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+        __asm__ __volatile__("msr fpcr, %0" : : "r"(mode));
+    #else
+        _SOKOL_UNUSED(mode);
+    #endif
 }
-#else
-_SOKOL_PRIVATE void _saudio_mutex_init(_saudio_mutex_t* m) { (void)m; }
-_SOKOL_PRIVATE void _saudio_mutex_destroy(_saudio_mutex_t* m) { (void)m; }
-_SOKOL_PRIVATE void _saudio_mutex_lock(_saudio_mutex_t* m) { (void)m; }
-_SOKOL_PRIVATE void _saudio_mutex_unlock(_saudio_mutex_t* m) { (void)m; }
-#endif
 
 /*=== RING-BUFFER QUEUE IMPLEMENTATION =======================================*/
 _SOKOL_PRIVATE uint16_t _saudio_ring_idx(_saudio_ring_t* ring, uint32_t i) {
@@ -769,56 +1616,65 @@ _SOKOL_PRIVATE void _saudio_ring_init(_saudio_ring_t* ring, uint32_t num_slots)
     ring->num = num_slots + 1;
 }
 
+/* NOTE: the following functions may only be called from the ring's
+    producer or consumer thread, one of head or tail is then stable
+*/
 _SOKOL_PRIVATE bool _saudio_ring_full(_saudio_ring_t* ring) {
-    return _saudio_ring_idx(ring, ring->head + 1) == ring->tail;
+    const uint32_t head = _saudio_atomic_load(&ring->head);
+    const uint32_t tail = _saudio_atomic_load(&ring->tail);
+    return _saudio_ring_idx(ring, head + 1) == tail;
 }
 
 _SOKOL_PRIVATE bool _saudio_ring_empty(_saudio_ring_t* ring) {
-    return ring->head == ring->tail;
+    const uint32_t head = _saudio_atomic_load(&ring->head);
+    const uint32_t tail = _saudio_atomic_load(&ring->tail);
+    return head == tail;
 }
 
 _SOKOL_PRIVATE int _saudio_ring_count(_saudio_ring_t* ring) {
+    const uint32_t head = _saudio_atomic_load(&ring->head);
+    const uint32_t tail = _saudio_atomic_load(&ring->tail);
     uint32_t count;
-    if (ring->head >= ring->tail) {
-        count = ring->head - ring->tail;
+    if (head >= tail) {
+        count = head - tail;
     }
     else {
-        count = (ring->head + ring->num) - ring->tail;
+        count = (head + ring->num) - tail;
     }
     SOKOL_ASSERT(count < ring->num);
     return count;
 }
 
+/* only called from the producer thread */
 _SOKOL_PRIVATE void _saudio_ring_enqueue(_saudio_ring_t* ring, uint32_t val) {
     SOKOL_ASSERT(!_saudio_ring_full(ring));
-    ring->queue[ring->head] = val;
-    ring->head = _saudio_ring_idx(ring, ring->head + 1);
+    const uint32_t head = _saudio_atomic_load(&ring->head);
+    ring->queue[head] = val;
+    /* publish the slot content to the consumer */
+    _saudio_atomic_store(&ring->head, _saudio_ring_idx(ring, head + 1));
 }
 
+/* only called from the consumer thread */
 _SOKOL_PRIVATE uint32_t _saudio_ring_dequeue(_saudio_ring_t* ring) {
     SOKOL_ASSERT(!_saudio_ring_empty(ring));
-    uint32_t val = ring->queue[ring->tail];
-    ring->tail = _saudio_ring_idx(ring, ring->tail + 1);
+    const uint32_t tail = _saudio_atomic_load(&ring->tail);
+    uint32_t val = ring->queue[tail];
+    /* hand the slot back to the producer */
+    _saudio_atomic_store(&ring->tail, _saudio_ring_idx(ring, tail + 1));
     return val;
 }
 
 /*---  a packet fifo for queueing audio data from main thread ----------------*/
-_SOKOL_PRIVATE void _saudio_fifo_init_mutex(_saudio_fifo_t* fifo) {
-    /* this must be called before initializing both the backend and the fifo itself! */
-    _saudio_mutex_init(&fifo->mutex);
-}
-
-_SOKOL_PRIVATE void _saudio_fifo_init(_saudio_fifo_t* fifo, int packet_size, int num_packets) {
-    /* NOTE: there's a chicken-egg situation during the init phase where the
-        streaming thread must be started before the fifo is actually initialized,
-        thus the fifo init must already be protected from access by the fifo_read() func.
-    */
-    _saudio_mutex_lock(&fifo->mutex);
-    SOKOL_ASSERT((packet_size > 0) && (num_packets > 0));
-    fifo->packet_size = packet_size;
-    fifo->num_packets = num_packets;
-    fifo->base_ptr = (uint8_t*) SOKOL_MALLOC(packet_size * num_packets);
-    SOKOL_ASSERT(fifo->base_ptr);
+/* The fifo is lock-free: packets with data travel from the main thread to
+    the audio thread through the read_queue, and empty packets travel back
+    through the write_queue. Each ring has exactly one producer and one
+    consumer, so the only shared state are the ring indices.
+*/
+/* move all packets into the write queue, must not be called while the
+    audio thread may read from the fifo
+*/
+_SOKOL_PRIVATE void _saudio_fifo_reset(_saudio_fifo_t* fifo) {
+    const int num_packets = fifo->num_packets;
     fifo->cur_packet = -1;
     fifo->cur_offset = 0;
     _saudio_ring_init(&fifo->read_queue, num_packets);
@@ -830,25 +1686,37 @@ _SOKOL_PRIVATE void _saudio_fifo_init(_saudio_fifo_t* fifo, int packet_size, int
     SOKOL_ASSERT(_saudio_ring_count(&fifo->write_queue) == num_packets);
     SOKOL_ASSERT(_saudio_ring_empty(&fifo->read_queue));
     SOKOL_ASSERT(_saudio_ring_count(&fifo->read_queue) == 0);
-    fifo->valid = true;
-    _saudio_mutex_unlock(&fifo->mutex);
+}
+
+_SOKOL_PRIVATE void _saudio_fifo_init(_saudio_fifo_t* fifo, int packet_size, int num_packets) {
+    /* NOTE: there's a chicken-egg situation during the init phase where the
+        streaming thread must be started before the fifo is actually initialized,
+        the fifo_read() func will ignore the fifo until the valid flag is published
+    */
+    SOKOL_ASSERT((packet_size > 0) && (num_packets > 0));
+    fifo->packet_size = packet_size;
+    fifo->num_packets = num_packets;
+    fifo->base_ptr = (uint8_t*) SOKOL_MALLOC(packet_size * num_packets);
+    SOKOL_ASSERT(fifo->base_ptr);
+    _saudio_mem_lock(fifo->base_ptr, packet_size * num_packets);
+    _saudio_fifo_reset(fifo);
+    _saudio_atomic_store(&fifo->valid, 1);
 }
 
 _SOKOL_PRIVATE void _saudio_fifo_shutdown(_saudio_fifo_t* fifo) {
     SOKOL_ASSERT(fifo->base_ptr);
+    _saudio_mem_unlock(fifo->base_ptr, fifo->packet_size * fifo->num_packets);
     SOKOL_FREE(fifo->base_ptr);
     fifo->base_ptr = 0;
-    fifo->valid = false;
-    _saudio_mutex_destroy(&fifo->mutex);
+    _saudio_atomic_store(&fifo->valid, 0);
 }
 
 _SOKOL_PRIVATE int _saudio_fifo_writable_bytes(_saudio_fifo_t* fifo) {
-    _saudio_mutex_lock(&fifo->mutex);
+    /* NOTE: the audio thread may return packets concurrently, so this is a lower bound */
     int num_bytes = (_saudio_ring_count(&fifo->write_queue) * fifo->packet_size);
     if (fifo->cur_packet != -1) {
         num_bytes += fifo->packet_size - fifo->cur_offset;
     }
-    _saudio_mutex_unlock(&fifo->mutex);
     SOKOL_ASSERT((num_bytes >= 0) && (num_bytes <= (fifo->num_packets * fifo->packet_size)));
     return num_bytes;
 }
@@ -862,11 +1730,9 @@ _SOKOL_PRIVATE int _saudio_fifo_write(_saudio_fifo_t* fifo, const uint8_t* ptr,
     while (all_to_copy > 0) {
         /* need to grab a new packet? */
         if (fifo->cur_packet == -1) {
-            _saudio_mutex_lock(&fifo->mutex);
             if (!_saudio_ring_empty(&fifo->write_queue)) {
                 fifo->cur_packet = _saudio_ring_dequeue(&fifo->write_queue);
             }
-            _saudio_mutex_unlock(&fifo->mutex);
             SOKOL_ASSERT(fifo->cur_offset == 0);
         }
         /* append data to current write packet */
@@ -892,9 +1758,7 @@ _SOKOL_PRIVATE int _saudio_fifo_write(_saudio_fifo_t* fifo, const uint8_t* ptr,
         }
         /* if write packet is full, push to read queue */
         if (fifo->cur_offset == fifo->packet_size) {
-            _saudio_mutex_lock(&fifo->mutex);
             _saudio_ring_enqueue(&fifo->read_queue, fifo->cur_packet);
-            _saudio_mutex_unlock(&fifo->mutex);
             fifo->cur_packet = -1;
             fifo->cur_offset = 0;
         }
@@ -906,9 +1770,8 @@ _SOKOL_PRIVATE int _saudio_fifo_write(_saudio_fifo_t* fifo, const uint8_t* ptr,
 /* read queued data, this is called form the stream callback (maybe separate thread) */
 _SOKOL_PRIVATE int _saudio_fifo_read(_saudio_fifo_t* fifo, uint8_t* ptr, int num_bytes) {
     /* NOTE: fifo_read might be called before the fifo is properly initialized */
-    _saudio_mutex_lock(&fifo->mutex);
     int num_bytes_copied = 0;
-    if (fifo->valid) {
+    if (_saudio_atomic_load(&fifo->valid)) {
         SOKOL_ASSERT(0 == (num_bytes % fifo->packet_size));
         SOKOL_ASSERT(num_bytes <= (fifo->packet_size * fifo->num_packets));
         const int num_packets_needed = num_bytes / fifo->packet_size;
@@ -917,117 +1780,1234 @@ _SOKOL_PRIVATE int _saudio_fifo_read(_saudio_fifo_t* fifo, uint8_t* ptr, int num
         if (_saudio_ring_count(&fifo->read_queue) >= num_packets_needed) {
             for (int i = 0; i < num_packets_needed; i++) {
                 int packet_index = _saudio_ring_dequeue(&fifo->read_queue);
-                _saudio_ring_enqueue(&fifo->write_queue, packet_index);
                 const uint8_t* src = fifo->base_ptr + packet_index * fifo->packet_size;
                 memcpy(dst, src, fifo->packet_size);
+                /* only hand the packet back after its content has been copied */
+                _saudio_ring_enqueue(&fifo->write_queue, packet_index);
                 dst += fifo->packet_size;
                 num_bytes_copied += fifo->packet_size;
             }
             SOKOL_ASSERT(num_bytes == num_bytes_copied);
         }
     }
-    _saudio_mutex_unlock(&fifo->mutex);
     return num_bytes_copied;
 }
 
-/*=== DUMMY BACKEND IMPLEMENTATION ===========================================*/
-#if defined(SOKOL_DUMMY_BACKEND)
-_SOKOL_PRIVATE bool _saudio_backend_init(void) {
-    _saudio.bytes_per_frame = _saudio.num_channels * sizeof(float);
-    return true;
-};
-_SOKOL_PRIVATE void _saudio_backend_shutdown(void) { };
-
-/*=== COREAUDIO BACKEND IMPLEMENTATION =======================================*/
-#elif defined(__APPLE__)
-
-/* NOTE: the buffer data callback is called on a separate thread! */
-_SOKOL_PRIVATE void _sapp_ca_callback(void* user_data, AudioQueueRef queue, AudioQueueBufferRef buffer) {
-    _SOKOL_UNUSED(user_data);
-    if (_saudio_has_callback()) {
-        const int num_frames = buffer->mAudioDataByteSize / _saudio.bytes_per_frame;
-        const int num_channels = _saudio.num_channels;
-        _saudio_stream_callback((float*)buffer->mAudioData, num_frames, num_channels);
-    }
-    else {
-        uint8_t* ptr = (uint8_t*)buffer->mAudioData;
-        int num_bytes = (int) buffer->mAudioDataByteSize;
-        if (0 == _saudio_fifo_read(&_saudio.fifo, ptr, num_bytes)) {
-            /* not enough read data available, fill the entire buffer with silence */
-            memset(ptr, 0, num_bytes);
-        }
-    }
-    AudioQueueEnqueueBuffer(queue, buffer, 0, NULL);
+/*=== TIMER ==================================================================*/
+/* current time in nanoseconds, returns 0 if no suitable timer is available */
+_SOKOL_PRIVATE uint64_t _saudio_now(void) {
+    #if defined(_WIN32)
+        LARGE_INTEGER freq, now;
+        QueryPerformanceFrequency(&freq);
+        QueryPerformanceCounter(&now);
+        return (uint64_t) ((double)now.QuadPart * 1000000000.0 / (double)freq.QuadPart);
+    #elif defined(__EMSCRIPTEN__) && !defined(SOKOL_DUMMY_BACKEND)
+        return (uint64_t) (emscripten_get_now() * 1000000.0);
+    #elif defined(CLOCK_MONOTONIC)
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec*1000000000 + (uint64_t)ts.tv_nsec;
+    #else
+        return 0;
+    #endif
 }
 
-_SOKOL_PRIVATE bool _saudio_backend_init(void) {
-    SOKOL_ASSERT(0 == _saudio.backend.ca_audio_queue);
+/*=== MIXER IMPLEMENTATION ===================================================*/
+_SOKOL_PRIVATE uint32_t _saudio_mixer_make_id(uint32_t index, uint32_t unique_counter) {
+    return (unique_counter << 16) | (index & 0xFFFF);
+}
 
-    /* create an audio queue with fp32 samples */
-    AudioStreamBasicDescription fmt;
-    memset(&fmt, 0, sizeof(fmt));
-    fmt.mSampleRate = (Float64) _saudio.sample_rate;
-    fmt.mFormatID = kAudioFormatLinearPCM;
-    fmt.mFormatFlags = kLinearPCMFormatFlagIsFloat | kAudioFormatFlagIsPacked;
-    fmt.mFramesPerPacket = 1;
-    fmt.mChannelsPerFrame = _saudio.num_channels;
-    fmt.mBytesPerFrame = sizeof(float) * _saudio.num_channels;
-    fmt.mBytesPerPacket = fmt.mBytesPerFrame;
-    fmt.mBitsPerChannel = 32;
-    OSStatus res = AudioQueueNewOutput(&fmt, _sapp_ca_callback, 0, NULL, NULL, 0, &_saudio.backend.ca_audio_queue);
-    SOKOL_ASSERT((res == 0) && _saudio.backend.ca_audio_queue);
+_SOKOL_PRIVATE uint32_t _saudio_mixer_id_index(uint32_t id) {
+    return id & 0xFFFF;
+}
 
-    /* create 2 audio buffers */
-    for (int i = 0; i < 2; i++) {
-        AudioQueueBufferRef buf = NULL;
-        const uint32_t buf_byte_size = _saudio.buffer_frames * fmt.mBytesPerFrame;
-        res = AudioQueueAllocateBuffer(_saudio.backend.ca_audio_queue, buf_byte_size, &buf);
-        SOKOL_ASSERT((res == 0) && buf);
-        buf->mAudioDataByteSize = buf_byte_size;
-        memset(buf->mAudioData, 0, buf->mAudioDataByteSize);
-        AudioQueueEnqueueBuffer(_saudio.backend.ca_audio_queue, buf, 0, NULL);
+/* the command queue, push is only called from the main thread, pop only from the audio thread */
+_SOKOL_PRIVATE bool _saudio_mixer_cmd_push(_saudio_mixer_cmd_queue_t* q, const _saudio_mixer_cmd_t* cmd) {
+    const uint32_t head = _saudio_atomic_load(&q->head);
+    const uint32_t next_head = (head + 1) % q->num;
+    if (next_head == _saudio_atomic_load(&q->tail)) {
+        /* queue is full */
+        return false;
     }
+    q->cmds[head] = *cmd;
+    _saudio_atomic_store(&q->head, next_head);
+    return true;
+}
 
-    /* init or modify actual playback parameters */
-    _saudio.bytes_per_frame = fmt.mBytesPerFrame;
-
-    /* ...and start playback */
-    res = AudioQueueStart(_saudio.backend.ca_audio_queue, NULL);
-    SOKOL_ASSERT(0 == res);
-
+_SOKOL_PRIVATE bool _saudio_mixer_cmd_pop(_saudio_mixer_cmd_queue_t* q, _saudio_mixer_cmd_t* out_cmd) {
+    const uint32_t tail = _saudio_atomic_load(&q->tail);
+    if (tail == _saudio_atomic_load(&q->head)) {
+        /* queue is empty */
+        return false;
+    }
+    *out_cmd = q->cmds[tail];
+    _saudio_atomic_store(&q->tail, (tail + 1) % q->num);
     return true;
 }
 
-_SOKOL_PRIVATE void _saudio_backend_shutdown(void) {
-    AudioQueueStop(_saudio.backend.ca_audio_queue, true);
-    AudioQueueDispose(_saudio.backend.ca_audio_queue, false);
-    _saudio.backend.ca_audio_queue = NULL;
+_SOKOL_PRIVATE void _saudio_mixer_init(_saudio_mixer_t* mixer, int num_voices, int num_cmds) {
+    SOKOL_ASSERT((num_voices > 0) && (num_voices <= _SAUDIO_MAX_VOICES));
+    SOKOL_ASSERT(num_cmds > 0);
+    mixer->num_voices = num_voices;
+    mixer->voice_ids = (uint32_t*) SOKOL_MALLOC(num_voices * sizeof(uint32_t));
+    mixer->finished_ids = (uint32_t*) SOKOL_MALLOC(num_voices * sizeof(uint32_t));
+    mixer->voices = (_saudio_voice_t*) SOKOL_MALLOC(num_voices * sizeof(_saudio_voice_t));
+    SOKOL_ASSERT(mixer->voice_ids && mixer->finished_ids && mixer->voices);
+    memset(mixer->voice_ids, 0, num_voices * sizeof(uint32_t));
+    memset(mixer->finished_ids, 0, num_voices * sizeof(uint32_t));
+    memset(mixer->voices, 0, num_voices * sizeof(_saudio_voice_t));
+    /* one slot reserved to detect 'full' vs 'empty' */
+    mixer->cmd_queue.num = num_cmds + 1;
+    mixer->cmd_queue.cmds = (_saudio_mixer_cmd_t*) SOKOL_MALLOC(mixer->cmd_queue.num * sizeof(_saudio_mixer_cmd_t));
+    SOKOL_ASSERT(mixer->cmd_queue.cmds);
+    _saudio_mem_lock(mixer->finished_ids, num_voices * sizeof(uint32_t));
+    _saudio_mem_lock(mixer->voices, num_voices * sizeof(_saudio_voice_t));
+    _saudio_mem_lock(mixer->cmd_queue.cmds, mixer->cmd_queue.num * sizeof(_saudio_mixer_cmd_t));
+    mixer->valid = true;
 }
 
-/*=== ALSA BACKEND IMPLEMENTATION ============================================*/
-#elif (defined(__linux__) || defined(__unix__)) && !defined(__EMSCRIPTEN__) && !defined(__ANDROID__)
+_SOKOL_PRIVATE void _saudio_mixer_shutdown(_saudio_mixer_t* mixer) {
+    if (mixer->valid) {
+        _saudio_mem_unlock(mixer->finished_ids, mixer->num_voices * sizeof(uint32_t));
+        _saudio_mem_unlock(mixer->voices, mixer->num_voices * sizeof(_saudio_voice_t));
+        _saudio_mem_unlock(mixer->cmd_queue.cmds, mixer->cmd_queue.num * sizeof(_saudio_mixer_cmd_t));
+        SOKOL_FREE(mixer->voice_ids);
+        SOKOL_FREE(mixer->finished_ids);
+        SOKOL_FREE(mixer->voices);
+        SOKOL_FREE(mixer->cmd_queue.cmds);
+    }
+    memset(mixer, 0, sizeof(_saudio_mixer_t));
+}
 
-/* the streaming callback runs in a separate thread */
-_SOKOL_PRIVATE void* _saudio_alsa_cb(void* param) {
+/* dst[i] += src[i] * gain, with the gain alternating between g0 and g1 (for
+    interleaved stereo), this covers mono-to-mono and stereo-to-stereo
+*/
+_SOKOL_PRIVATE void _saudio_mix_interleaved(float* dst, const float* src, int num_samples, float g0, float g1) {
+    int i = 0;
+    #if defined(_SAUDIO_SSE)
+        const __m128 g = _mm_setr_ps(g0, g1, g0, g1);
+        for (; (i + 4) <= num_samples; i += 4) {
+            _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+        }
+    #elif defined(_SAUDIO_NEON)
+        const float gains[4] = { g0, g1, g0, g1 };
+        const float32x4_t g = vld1q_f32(gains);
+        for (; (i + 4) <= num_samples; i += 4) {
+            vst1q_f32(dst + i, vmlaq_f32(vld1q_f32(dst + i), vld1q_f32(src + i), g));
+        }
+    #endif
+    for (; i < num_samples; i++) {
+        dst[i] += src[i] * ((i & 1) ? g1 : g0);
+    }
+}
+
+/* mix a mono source into an interleaved stereo destination */
+_SOKOL_PRIVATE void _saudio_mix_mono_to_stereo(float* dst, const float* src, int num_frames, float gl, float gr) {
+    int i = 0;
+    #if defined(_SAUDIO_SSE)
+        const __m128 g = _mm_setr_ps(gl, gr, gl, gr);
+        for (; (i + 4) <= num_frames; i += 4) {
+            const __m128 s = _mm_loadu_ps(src + i);
+            float* d = dst + 2 * i;
+            _mm_storeu_ps(d, _mm_add_ps(_mm_loadu_ps(d), _mm_mul_ps(_mm_unpacklo_ps(s, s), g)));
+            _mm_storeu_ps(d + 4, _mm_add_ps(_mm_loadu_ps(d + 4), _mm_mul_ps(_mm_unpackhi_ps(s, s), g)));
+        }
+    #elif defined(_SAUDIO_NEON)
+        const float gains[4] = { gl, gr, gl, gr };
+        const float32x4_t g = vld1q_f32(gains);
+        for (; (i + 4) <= num_frames; i += 4) {
+            const float32x4_t s = vld1q_f32(src + i);
+            const float32x4x2_t ss = vzipq_f32(s, s);
+            float* d = dst + 2 * i;
+            vst1q_f32(d, vmlaq_f32(vld1q_f32(d), ss.val[0], g));
+            vst1q_f32(d + 4, vmlaq_f32(vld1q_f32(d + 4), ss.val[1], g));
+        }
+    #endif
+    for (; i < num_frames; i++) {
+        dst[2 * i] += src[i] * gl;
+        dst[2 * i + 1] += src[i] * gr;
+    }
+}
+
+/* generic (slow) path for all other channel combinations */
+_SOKOL_PRIVATE void _saudio_mix_generic(float* dst, int dst_channels, const float* src, int src_channels, int num_frames, float gl, float gr) {
+    for (int i = 0; i < num_frames; i++) {
+        const float l = src[i * src_channels];
+        const float r = (src_channels > 1) ? src[i * src_channels + 1] : l;
+        float* d = dst + i * dst_channels;
+        if (dst_channels == 1) {
+            d[0] += (l + r) * 0.5f * gl;
+        }
+        else {
+            d[0] += l * gl;
+            d[1] += r * gr;
+        }
+    }
+}
+
+_SOKOL_PRIVATE void _saudio_mix_voice_frames(const _saudio_voice_t* voice, float* dst, int dst_channels, int num_frames) {
+    /* left/right gain with a simple balance control */
+    float gl = voice->volume;
+    float gr = voice->volume;
+    if (dst_channels > 1) {
+        if (voice->pan > 0.0f) {
+            gl *= 1.0f - voice->pan;
+        }
+        else {
+            gr *= 1.0f + voice->pan;
+        }
+    }
+    const float* src = voice->samples + voice->pos * voice->num_channels;
+    if ((dst_channels == voice->num_channels) && (dst_channels <= 2)) {
+        _saudio_mix_interleaved(dst, src, num_frames * dst_channels, gl, gr);
+    }
+    else if ((dst_channels == 2) && (voice->num_channels == 1)) {
+        _saudio_mix_mono_to_stereo(dst, src, num_frames, gl, gr);
+    }
+    else {
+        _saudio_mix_generic(dst, dst_channels, src, voice->num_channels, num_frames, gl, gr);
+    }
+}
+
+_SOKOL_PRIVATE void _saudio_mixer_finish_voice(_saudio_mixer_t* mixer, uint32_t index) {
+    _saudio_voice_t* voice = &mixer->voices[index];
+    _saudio_atomic_store(&mixer->finished_ids[index], voice->id);
+    voice->id = 0;
+}
+
+/* drain the command queue, called on the audio thread */
+_SOKOL_PRIVATE void _saudio_mixer_process_commands(_saudio_mixer_t* mixer) {
+    _saudio_mixer_cmd_t cmd;
+    while (_saudio_mixer_cmd_pop(&mixer->cmd_queue, &cmd)) {
+        const uint32_t index = _saudio_mixer_id_index(cmd.voice_id);
+        SOKOL_ASSERT(index < (uint32_t)mixer->num_voices);
+        _saudio_voice_t* voice = &mixer->voices[index];
+        if (cmd.type == _SAUDIO_MIXER_CMD_PLAY) {
+            /* a new voice may replace a voice which hasn't finished yet */
+            voice->id = cmd.voice_id;
+            voice->samples = cmd.samples;
+            voice->num_frames = cmd.num_frames;
+            voice->num_channels = cmd.num_channels;
+            voice->pos = 0;
+            voice->volume = cmd.volume;
+            voice->pan = cmd.pan;
+            voice->loop = cmd.loop;
+        }
+        else if (voice->id == cmd.voice_id) {
+            switch (cmd.type) {
+                case _SAUDIO_MIXER_CMD_STOP:    _saudio_mixer_finish_voice(mixer, index); break;
+                case _SAUDIO_MIXER_CMD_VOLUME:  voice->volume = cmd.volume; break;
+                case _SAUDIO_MIXER_CMD_PAN:     voice->pan = cmd.pan; break;
+                case _SAUDIO_MIXER_CMD_LOOP:    voice->loop = cmd.loop; break;
+                default: break;
+            }
+        }
+    }
+}
+
+/* mix all playing voices into the stream buffer, called on the audio thread */
+_SOKOL_PRIVATE void _saudio_mixer_process(_saudio_mixer_t* mixer, float* buffer, int num_frames, int num_channels) {
+    const uint64_t start = _saudio_now();
+    _saudio_mixer_process_commands(mixer);
+    uint32_t num_playing = 0;
+    for (int i = 0; i < mixer->num_voices; i++) {
+        _saudio_voice_t* voice = &mixer->voices[i];
+        if (0 == voice->id) {
+            continue;
+        }
+        num_playing++;
+        float* dst = buffer;
+        int frames_left = num_frames;
+        while (frames_left > 0) {
+            int n = voice->num_frames - voice->pos;
+            if (n > frames_left) {
+                n = frames_left;
+            }
+            _saudio_mix_voice_frames(voice, dst, num_channels, n);
+            voice->pos += n;
+            dst += n * num_channels;
+            frames_left -= n;
+            if (voice->pos >= voice->num_frames) {
+                if (voice->loop) {
+                    voice->pos = 0;
+                }
+                else {
+                    _saudio_mixer_finish_voice(mixer, i);
+                    break;
+                }
+            }
+        }
+    }
+
+    /* update statistics (single writer, so no atomic read-modify-write needed) */
+    const uint32_t mix_ns = (uint32_t) (_saudio_now() - start);
+    const uint32_t num_calls = _saudio_atomic_load(&mixer->stats.num_mix_calls);
+    uint32_t avg_ns = _saudio_atomic_load(&mixer->stats.avg_mix_ns);
+    avg_ns = (0 == num_calls) ? mix_ns : (avg_ns - (avg_ns >> 4) + (mix_ns >> 4));
+    _saudio_atomic_store(&mixer->stats.avg_mix_ns, avg_ns);
+    _saudio_atomic_store(&mixer->stats.last_mix_ns, mix_ns);
+    if (mix_ns > _saudio_atomic_load(&mixer->stats.max_mix_ns)) {
+        _saudio_atomic_store(&mixer->stats.max_mix_ns, mix_ns);
+    }
+    _saudio_atomic_store(&mixer->stats.num_playing_voices, num_playing);
+    if (num_playing > _saudio_atomic_load(&mixer->stats.max_playing_voices)) {
+        _saudio_atomic_store(&mixer->stats.max_playing_voices, num_playing);
+    }
+    _saudio_atomic_store(&mixer->stats.last_num_frames, (uint32_t)num_frames);
+    _saudio_atomic_store(&mixer->stats.num_mix_calls, num_calls + 1);
+}
+
+/* send a command to the audio thread, called on the main thread */
+_SOKOL_PRIVATE bool _saudio_mixer_send(_saudio_mixer_t* mixer, const _saudio_mixer_cmd_t* cmd) {
+    if (_saudio_mixer_cmd_push(&mixer->cmd_queue, cmd)) {
+        return true;
+    }
+    else {
+        mixer->num_dropped_commands++;
+        return false;
+    }
+}
+
+/* lookup the slot index of a voice which is still playing, or -1 */
+_SOKOL_PRIVATE int _saudio_mixer_lookup(_saudio_mixer_t* mixer, uint32_t voice_id) {
+    if (mixer->valid && (0 != voice_id)) {
+        const uint32_t index = _saudio_mixer_id_index(voice_id);
+        if ((index < (uint32_t)mixer->num_voices) &&
+            (mixer->voice_ids[index] == voice_id) &&
+            (_saudio_atomic_load(&mixer->finished_ids[index]) != voice_id))
+        {
+            return (int)index;
+        }
+    }
+    return -1;
+}
+
+_SOKOL_PRIVATE void _saudio_mixer_send_voice_cmd(saudio_voice voice, _saudio_mixer_cmd_type_t type, float volume, float pan, bool loop) {
+    _saudio_mixer_t* mixer = &_saudio.mixer;
+    if (_saudio_mixer_lookup(mixer, voice.id) >= 0) {
+        _saudio_mixer_cmd_t cmd;
+        memset(&cmd, 0, sizeof(cmd));
+        cmd.type = type;
+        cmd.voice_id = voice.id;
+        cmd.volume = volume;
+        cmd.pan = pan;
+        cmd.loop = loop;
+        if (_saudio_mixer_send(mixer, &cmd) && (type == _SAUDIO_MIXER_CMD_STOP)) {
+            /* the slot can be reused right away, commands are processed in order */
+            mixer->voice_ids[_saudio_mixer_id_index(voice.id)] = 0;
+        }
+    }
+}
+
+/*=== STATISTICS =============================================================*/
+/* NOTE: all stats counters have a single writer (the audio thread), so
+    a separate atomic load and store is enough to update them
+*/
+_SOKOL_PRIVATE void _saudio_stats_inc(uint32_t* counter) {
+    _saudio_atomic_store(counter, _saudio_atomic_load(counter) + 1);
+}
+
+_SOKOL_PRIVATE void _saudio_stats_max(uint32_t* val, uint32_t new_val) {
+    if (new_val > _saudio_atomic_load(val)) {
+        _saudio_atomic_store(val, new_val);
+    }
+}
+
+/* exponential moving average with a weight of 1/16 */
+_SOKOL_PRIVATE void _saudio_stats_avg(uint32_t* avg, uint32_t new_val, bool first) {
+    const uint32_t cur = _saudio_atomic_load(avg);
+    _saudio_atomic_store(avg, first ? new_val : (cur - (cur >> 4) + (new_val >> 4)));
+}
+
+_SOKOL_PRIVATE void _saudio_stats_reset(_saudio_stats_t* stats) {
+    _saudio_atomic_store(&stats->num_buffers, 0);
+    _saudio_atomic_store(&stats->num_underruns, 0);
+    _saudio_atomic_store(&stats->num_silence_buffers, 0);
+    _saudio_atomic_store(&stats->fifo_min_frames, 0xFFFFFFFF);
+    _saudio_atomic_store(&stats->fifo_avg_frames, 0);
+    _saudio_atomic_store(&stats->fifo_max_frames, 0);
+    _saudio_atomic_store(&stats->fill_avg_ns, 0);
+    _saudio_atomic_store(&stats->fill_max_ns, 0);
+    for (int i = 0; i < SAUDIO_STATS_HISTOGRAM_SIZE; i++) {
+        _saudio_atomic_store(&stats->fill_histogram[i], 0);
+    }
+}
+
+/* called by the backends when an underrun was detected */
+_SOKOL_PRIVATE void _saudio_stats_underrun(void) {
+    _saudio_stats_inc(&_saudio.stats.num_underruns);
+}
+
+/* called by the backends which can measure the output latency */
+_SOKOL_PRIVATE void _saudio_stats_latency(uint32_t num_frames) {
+    _saudio_atomic_store(&_saudio.stats.latency_frames, num_frames);
+}
+
+/* sample the push FIFO fill level before reading from it */
+_SOKOL_PRIVATE void _saudio_stats_fifo(_saudio_stats_t* stats, _saudio_fifo_t* fifo) {
+    if (_saudio_atomic_load(&fifo->valid)) {
+        const uint32_t num_frames = (uint32_t) _saudio_ring_count(&fifo->read_queue) * (uint32_t)_saudio.packet_frames;
+        const uint32_t min_frames = _saudio_atomic_load(&stats->fifo_min_frames);
+        if (num_frames < min_frames) {
+            _saudio_atomic_store(&stats->fifo_min_frames, num_frames);
+        }
+        _saudio_stats_max(&stats->fifo_max_frames, num_frames);
+        _saudio_stats_avg(&stats->fifo_avg_frames, num_frames, 0xFFFFFFFF == min_frames);
+    }
+}
+
+/* record the time it took to fill one stream buffer */
+_SOKOL_PRIVATE void _saudio_stats_fill(_saudio_stats_t* stats, uint64_t start, uint64_t end) {
+    const uint32_t fill_ns = (end > start) ? (uint32_t)(end - start) : 0;
+    const uint32_t num_buffers = _saudio_atomic_load(&stats->num_buffers);
+    _saudio_stats_avg(&stats->fill_avg_ns, fill_ns, 0 == num_buffers);
+    _saudio_stats_max(&stats->fill_max_ns, fill_ns);
+    /* bucket 0: < 16us, bucket i: [8us << i, 16us << i) */
+    uint32_t us = fill_ns / 16000;
+    int bucket = 0;
+    while ((us > 0) && (bucket < (SAUDIO_STATS_HISTOGRAM_SIZE - 1))) {
+        us >>= 1;
+        bucket++;
+    }
+    _saudio_stats_inc(&stats->fill_histogram[bucket]);
+    _saudio_atomic_store(&stats->num_buffers, num_buffers + 1);
+}
+
+/*=== SAMPLE FORMAT CONVERSION ===============================================*/
+_SOKOL_PRIVATE int _saudio_sample_size(saudio_sample_format fmt) {
+    switch (fmt) {
+        case SAUDIO_SAMPLEFORMAT_INT16: return 2;
+        case SAUDIO_SAMPLEFORMAT_INT24: return 3;
+        default: return 4;
+    }
+}
+
+/* convert int16 samples to float, dst and src may overlap as long as
+    src is located at the end of the dst range
+*/
+_SOKOL_PRIVATE void _saudio_s16_to_f32(float* dst, const uint8_t* src, int num_samples) {
+    const float scale = 1.0f / 32768.0f;
+    int i = 0;
+    #if defined(_SAUDIO_SSE2)
+        const __m128 s = _mm_set1_ps(scale);
+        for (; (i + 4) <= num_samples; i += 4) {
+            const __m128i v = _mm_loadl_epi64((const __m128i*)(src + i * 2));
+            /* sign-extend to 32 bits */
+            const __m128i v32 = _mm_srai_epi32(_mm_unpacklo_epi16(_mm_setzero_si128(), v), 16);
+            _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(v32), s));
+        }
+    #elif defined(_SAUDIO_NEON)
+        for (; (i + 4) <= num_samples; i += 4) {
+            const int32x4_t v32 = vmovl_s16(vreinterpret_s16_u8(vld1_u8(src + i * 2)));
+            vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(v32), scale));
+        }
+    #endif
+    for (; i < num_samples; i++) {
+        int16_t v;
+        memcpy(&v, src + i * 2, sizeof(v));
+        dst[i] = (float)v * scale;
+    }
+}
+
+/* convert packed little-endian int24 samples to float, same overlap rules as above */
+_SOKOL_PRIVATE void _saudio_s24_to_f32(float* dst, const uint8_t* src, int num_samples) {
+    const float scale = 1.0f / 2147483648.0f;
+    for (int i = 0; i < num_samples; i++) {
+        const uint8_t* p = src + i * 3;
+        /* shift into the top 24 bits of an int32 to get the sign right */
+        const int32_t v = (int32_t) (((uint32_t)p[0] << 8) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 24));
+        dst[i] = (float)v * scale;
+    }
+}
+
+/* convert float samples to int16 with clamping, used by backends which need int16,
+   this is the exact inverse of _saudio_s16_to_f32() (same scale factor), so that
+   pushed int16 samples arrive unchanged at the audio device
+*/
+_SOKOL_PRIVATE void _saudio_f32_to_s16(int16_t* dst, const float* src, int num_samples) {
+    /* all code paths clamp to [-1, 1], round half away from zero,
+       and saturate +1.0 (32768) to 32767
+    */
+    int i = 0;
+    #if defined(_SAUDIO_SSE2)
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 neg_one = _mm_set1_ps(-1.0f);
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 sign = _mm_set1_ps(-0.0f);
+        const __m128 s = _mm_set1_ps(32768.0f);
+        for (; (i + 8) <= num_samples; i += 8) {
+            __m128 v0 = _mm_mul_ps(_mm_max_ps(_mm_min_ps(_mm_loadu_ps(src + i), one), neg_one), s);
+            __m128 v1 = _mm_mul_ps(_mm_max_ps(_mm_min_ps(_mm_loadu_ps(src + i + 4), one), neg_one), s);
+            /* add 0.5 with the sign of the sample, then truncate */
+            v0 = _mm_add_ps(v0, _mm_or_ps(_mm_and_ps(v0, sign), half));
+            v1 = _mm_add_ps(v1, _mm_or_ps(_mm_and_ps(v1, sign), half));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(_mm_cvttps_epi32(v0), _mm_cvttps_epi32(v1)));
+        }
+    #elif defined(_SAUDIO_NEON)
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        const float32x4_t neg_one = vdupq_n_f32(-1.0f);
+        const float32x4_t half = vdupq_n_f32(0.5f);
+        const uint32x4_t sign = vdupq_n_u32(0x80000000);
+        for (; (i + 4) <= num_samples; i += 4) {
+            float32x4_t v = vmulq_n_f32(vmaxq_f32(vminq_f32(vld1q_f32(src + i), one), neg_one), 32768.0f);
+            /* add 0.5 with the sign of the sample, then truncate */
+            v = vaddq_f32(v, vbslq_f32(sign, v, half));
+            vst1_s16(dst + i, vqmovn_s32(vcvtq_s32_f32(v)));
+        }
+    #endif
+    for (; i < num_samples; i++) {
+        float v = src[i];
+        v = (v < 1.0f) ? v : 1.0f;
+        v = (v > -1.0f) ? v : -1.0f;
+        v *= 32768.0f;
+        const int32_t r = (int32_t) (v + ((v < 0.0f) ? -0.5f : 0.5f));
+        dst[i] = (int16_t) ((r > 32767) ? 32767 : r);
+    }
+}
+
+/* read pushed samples from a packet fifo into a float buffer, returns false
+    if the fifo doesn't have enough data (the buffer content is undefined then)
+*/
+_SOKOL_PRIVATE bool _saudio_fifo_fill(_saudio_fifo_t* fifo, float* buffer, int num_frames) {
+    /* pushed samples which aren't floats are read into the end of the
+       buffer, and then expanded in-place into floats
+    */
+    const int num_bytes = num_frames * _saudio.push_bytes_per_frame;
+    const int num_samples = num_frames * _saudio.num_channels;
+    uint8_t* ptr = ((uint8_t*)buffer) + (num_samples * sizeof(float) - num_bytes);
+    if (0 == _saudio_fifo_read(fifo, ptr, num_bytes)) {
+        return false;
+    }
+    if (_saudio.sample_format == SAUDIO_SAMPLEFORMAT_INT16) {
+        _saudio_s16_to_f32(buffer, ptr, num_samples);
+    }
+    else if (_saudio.sample_format == SAUDIO_SAMPLEFORMAT_INT24) {
+        _saudio_s24_to_f32(buffer, ptr, num_samples);
+    }
+    return true;
+}
+
+/*=== ADDITIONAL STREAMS =====================================================*/
+_SOKOL_PRIVATE uint32_t _saudio_float_bits(float val) {
+    uint32_t bits;
+    memcpy(&bits, &val, sizeof(bits));
+    return bits;
+}
+
+_SOKOL_PRIVATE float _saudio_bits_float(uint32_t bits) {
+    float val;
+    memcpy(&val, &bits, sizeof(val));
+    return val;
+}
+
+_SOKOL_PRIVATE void _saudio_streams_init(_saudio_streams_t* st, int num_streams, int packet_size, int num_packets, int scratch_frames, int num_channels) {
+    SOKOL_ASSERT((num_streams > 0) && (num_streams <= _SAUDIO_MAX_STREAMS));
+    SOKOL_ASSERT(scratch_frames > 0);
+    st->num_streams = num_streams;
+    st->streams = (_saudio_stream_t*) SOKOL_MALLOC(num_streams * sizeof(_saudio_stream_t));
+    SOKOL_ASSERT(st->streams);
+    memset(st->streams, 0, num_streams * sizeof(_saudio_stream_t));
+    for (int i = 0; i < num_streams; i++) {
+        _saudio_fifo_init(&st->streams[i].fifo, packet_size, num_packets);
+    }
+    st->scratch_frames = scratch_frames;
+    st->scratch = (float*) SOKOL_MALLOC(scratch_frames * num_channels * sizeof(float));
+    SOKOL_ASSERT(st->scratch);
+    memset(st->scratch, 0, scratch_frames * num_channels * sizeof(float));
+    _saudio_mem_lock(st->streams, num_streams * sizeof(_saudio_stream_t));
+    _saudio_mem_lock(st->scratch, scratch_frames * num_channels * sizeof(float));
+    st->valid = true;
+}
+
+/* NOTE: must be called after the audio thread has been stopped */
+_SOKOL_PRIVATE void _saudio_streams_shutdown(_saudio_streams_t* st) {
+    if (st->valid) {
+        for (int i = 0; i < st->num_streams; i++) {
+            _saudio_fifo_shutdown(&st->streams[i].fifo);
+        }
+        _saudio_mem_unlock(st->streams, st->num_streams * sizeof(_saudio_stream_t));
+        _saudio_mem_unlock(st->scratch, st->scratch_frames * _saudio.num_channels * sizeof(float));
+        SOKOL_FREE(st->streams);
+        SOKOL_FREE(st->scratch);
+    }
+    memset(st, 0, sizeof(_saudio_streams_t));
+}
+
+/* lookup a live stream by id, called on the main thread (or the pushing thread),
+   this checks the atomic active_id, because the main thread may destroy
+   the stream (or reuse the slot) while another thread pushes samples
+*/
+_SOKOL_PRIVATE _saudio_stream_t* _saudio_streams_lookup(_saudio_streams_t* st, uint32_t stream_id) {
+    if (st->valid && (0 != stream_id)) {
+        const uint32_t index = _saudio_mixer_id_index(stream_id);
+        if ((index < (uint32_t)st->num_streams) && (_saudio_atomic_load(&st->streams[index].active_id) == stream_id)) {
+            return &st->streams[index];
+        }
+    }
+    return 0;
+}
+
+_SOKOL_PRIVATE void _saudio_stream_set_name(_saudio_stream_t* s, const char* name) {
+    memset(s->name, 0, sizeof(s->name));
+    if (name) {
+        #if defined(_MSC_VER)
+        strncpy_s(s->name, SAUDIO_STREAM_NAME_SIZE, name, (SAUDIO_STREAM_NAME_SIZE-1));
+        #else
+        strncpy(s->name, name, SAUDIO_STREAM_NAME_SIZE-1);
+        #endif
+    }
+}
+
+/* a destroyed stream's slot can only be reused after the audio thread
+    has finished the mix which might still have been using it
+*/
+_SOKOL_PRIVATE bool _saudio_streams_slot_free(_saudio_streams_t* st, _saudio_stream_t* s) {
+    if (0 != s->id) {
+        return false;
+    }
+    if (s->retired && (_saudio_atomic_load(&st->epoch) != s->retire_epoch)) {
+        s->retired = false;
+    }
+    return !s->retired;
+}
+
+/* dst += src * gain, with the gain ramped linearly from g0 to g1 to avoid zipper noise */
+_SOKOL_PRIVATE void _saudio_mix_ramp(float* dst, const float* src, int num_frames, int num_channels, float g0, float g1) {
+    if (g0 == g1) {
+        _saudio_mix_interleaved(dst, src, num_frames * num_channels, g0, g0);
+        return;
+    }
+    const float step = (g1 - g0) / (float)num_frames;
+    float gain = g0;
+    for (int i = 0; i < num_frames; i++) {
+        gain += step;
+        for (int ch = 0; ch < num_channels; ch++) {
+            dst[ch] += src[ch] * gain;
+        }
+        dst += num_channels;
+        src += num_channels;
+    }
+}
+
+_SOKOL_PRIVATE void _saudio_stream_stats_reset(_saudio_stream_t* s) {
+    _saudio_atomic_store(&s->stats.num_fills, 0);
+    _saudio_atomic_store(&s->stats.num_silence_buffers, 0);
+    _saudio_atomic_store(&s->stats.last_num_frames, 0);
+    _saudio_atomic_store(&s->stats.fill_avg_ns, 0);
+    _saudio_atomic_store(&s->stats.fill_max_ns, 0);
+}
+
+/* fill and mix all live streams into the buffer, called on the audio thread */
+_SOKOL_PRIVATE void _saudio_streams_process(_saudio_streams_t* st, float* buffer, int num_frames, int num_channels) {
+    SOKOL_ASSERT(num_frames <= st->scratch_frames);
+    const uint32_t reset_request = _saudio_atomic_load(&_saudio.stats.reset_request);
+    const bool reset_stats = (reset_request != st->reset_done);
+    st->reset_done = reset_request;
+    for (int i = 0; i < st->num_streams; i++) {
+        _saudio_stream_t* s = &st->streams[i];
+        const uint32_t id = _saudio_atomic_load(&s->active_id);
+        if (0 == id) {
+            continue;
+        }
+        if (reset_stats) {
+            _saudio_stream_stats_reset(s);
+        }
+        const uint64_t start = _saudio_now();
+        const float gain = _saudio_bits_float(_saudio_atomic_load(&s->gain));
+        if (s->mixed_id != id) {
+            /* a new stream starts right at its gain */
+            s->mixed_id = id;
+            s->cur_gain = gain;
+        }
+        bool has_data = true;
+        if (s->stream_cb) {
+            s->stream_cb(st->scratch, num_frames, num_channels, s->user_data);
+        }
+        else if (!_saudio_fifo_fill(&s->fifo, st->scratch, num_frames)) {
+            /* a starving stream doesn't contribute to the mix */
+            has_data = false;
+            _saudio_stats_inc(&s->stats.num_silence_buffers);
+        }
+        if (has_data) {
+            _saudio_mix_ramp(buffer, st->scratch, num_frames, num_channels, s->cur_gain, gain);
+        }
+        s->cur_gain = gain;
+
+        /* per-stream statistics, skipped buffers are only counted in num_silence_buffers */
+        _saudio_atomic_store(&s->stats.last_num_frames, (uint32_t)num_frames);
+        if (has_data) {
+            const uint64_t end = _saudio_now();
+            const uint32_t fill_ns = (end > start) ? (uint32_t)(end - start) : 0;
+            const uint32_t num_fills = _saudio_atomic_load(&s->stats.num_fills);
+            _saudio_stats_avg(&s->stats.fill_avg_ns, fill_ns, 0 == num_fills);
+            _saudio_stats_max(&s->stats.fill_max_ns, fill_ns);
+            _saudio_atomic_store(&s->stats.num_fills, num_fills + 1);
+        }
+    }
+    /* tell the main thread that destroyed streams are no longer in use */
+    _saudio_atomic_store(&st->epoch, _saudio_atomic_load(&st->epoch) + 1);
+}
+
+/* fill a buffer with audio data at the source sample rate */
+_SOKOL_PRIVATE void _saudio_fill_source(float* buffer, int num_frames) {
+    if (_saudio_has_callback()) {
+        _saudio_stream_callback(buffer, num_frames, _saudio.num_channels);
+    }
+    else {
+        _saudio_stats_fifo(&_saudio.stats, &_saudio.fifo);
+        if (!_saudio_fifo_fill(&_saudio.fifo, buffer, num_frames)) {
+            /* not enough read data available, fill the entire buffer with silence */
+            memset(buffer, 0, num_frames * _saudio.num_channels * sizeof(float));
+            _saudio_stats_inc(&_saudio.stats.num_silence_buffers);
+        }
+    }
+    /* the additional streams are initialized after the backend, and
+       published together with the setup_done flag
+    */
+    if (_saudio_atomic_load(&_saudio.setup_done) && _saudio.streams.valid) {
+        _saudio_streams_process(&_saudio.streams, buffer, num_frames, _saudio.num_channels);
+    }
+    if (_saudio.mixer.valid) {
+        _saudio_mixer_process(&_saudio.mixer, buffer, num_frames, _saudio.num_channels);
+    }
+}
+
+/*=== RESAMPLER IMPLEMENTATION ===============================================*/
+#define _SAUDIO_PI (3.14159265358979323846)
+
+/* private math helpers for the filter design to avoid a libm dependency,
+    these only run once in saudio_setup(), so precision matters more than speed
+*/
+_SOKOL_PRIVATE double _saudio_fabs(double x) {
+    return (x < 0.0) ? -x : x;
+}
+
+/* sin(pi * x), reduces x to [-0.5, 0.5] and evaluates a Taylor series */
+_SOKOL_PRIVATE double _saudio_sinpi(double x) {
+    const double n = (double)(int64_t)(x + ((x < 0.0) ? -0.5 : 0.5));
+    const double y = _SAUDIO_PI * (x - n);
+    const double y2 = y * y;
+    double sum = y;
+    double term = y;
+    for (int k = 1; k < 16; k++) {
+        term *= -y2 / (double)((2 * k) * (2 * k + 1));
+        sum += term;
+    }
+    /* sin(pi * (r + n)) == (-1)^n * sin(pi * r) */
+    return (((int64_t)n) & 1) ? -sum : sum;
+}
+
+/* square root by Newton iteration, x is first scaled into [0.25, 4] by
+    powers of 4, and the start value is above the result so that the
+    estimate decreases monotonically until it converges
+*/
+_SOKOL_PRIVATE double _saudio_sqrt(double x) {
+    if (x <= 0.0) {
+        return 0.0;
+    }
+    double scale = 1.0;
+    while (x < 0.25) {
+        x *= 4.0;
+        scale *= 0.5;
+    }
+    while (x > 4.0) {
+        x *= 0.25;
+        scale *= 2.0;
+    }
+    double g = (x > 1.0) ? x : 1.0;
+    for (int i = 0; i < 16; i++) {
+        const double next = 0.5 * (g + x / g);
+        if (next >= g) {
+            break;
+        }
+        g = next;
+    }
+    return g * scale;
+}
+
+/* zeroth-order modified Bessel function of the first kind (for the Kaiser window) */
+_SOKOL_PRIVATE double _saudio_bessel_i0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 32; k++) {
+        const double t = x / (2.0 * k);
+        term *= t * t;
+        sum += term;
+        if (term < (sum * 1.0e-12)) {
+            break;
+        }
+    }
+    return sum;
+}
+
+/* compute the windowed-sinc filter table, one row of num_taps coefficients
+    for each of the (num_phases + 1) fractional positions
+*/
+_SOKOL_PRIVATE void _saudio_resampler_make_filter(_saudio_resampler_t* rs, double cutoff, double beta) {
+    const int num_taps = rs->num_taps;
+    const double half = (double)(num_taps / 2);
+    const double i0_beta = _saudio_bessel_i0(beta);
+    for (int p = 0; p <= rs->num_phases; p++) {
+        const double frac = (double)p / (double)rs->num_phases;
+        float* h = rs->coeffs + p * num_taps;
+        double sum = 0.0;
+        for (int k = 0; k < num_taps; k++) {
+            /* distance of the tap to the interpolated position */
+            const double x = ((double)k - (half - 1.0)) - frac;
+            const double sx = x * cutoff;
+            const double sinc = (_saudio_fabs(sx) < 1.0e-9) ? 1.0 : (_saudio_sinpi(sx) / (_SAUDIO_PI * sx));
+            const double t = x / half;
+            const double win = (_saudio_fabs(t) < 1.0) ? (_saudio_bessel_i0(beta * _saudio_sqrt(1.0 - t * t)) / i0_beta) : 0.0;
+            const double c = cutoff * sinc * win;
+            h[k] = (float)c;
+            sum += c;
+        }
+        /* normalize to unity gain at DC */
+        for (int k = 0; k < num_taps; k++) {
+            h[k] = (float)(h[k] / sum);
+        }
+    }
+}
+
+_SOKOL_PRIVATE void _saudio_resampler_init(_saudio_resampler_t* rs, int src_rate, int dst_rate, int num_channels, int block_frames, saudio_resampler_quality quality) {
+    SOKOL_ASSERT((src_rate > 0) && (dst_rate > 0) && (num_channels > 0) && (block_frames > 0));
+    if (src_rate == dst_rate) {
+        _saudio_atomic_store(&rs->state, _SAUDIO_RESAMPLER_STATE_BYPASS);
+        return;
+    }
+    double cutoff_scale, beta;
+    switch (quality) {
+        case SAUDIO_RESAMPLER_QUALITY_LOW:
+            rs->num_taps = 8; rs->num_phases = 64; cutoff_scale = 0.85; beta = 5.0;
+            break;
+        case SAUDIO_RESAMPLER_QUALITY_HIGH:
+            rs->num_taps = 32; rs->num_phases = 1024; cutoff_scale = 0.96; beta = 9.0;
+            break;
+        default:
+            rs->num_taps = 16; rs->num_phases = 256; cutoff_scale = 0.92; beta = 7.0;
+            break;
+    }
+    rs->num_channels = num_channels;
+    rs->block_frames = block_frames;
+    rs->step = (double)src_rate / (double)dst_rate;
+    rs->coeffs = (float*) SOKOL_MALLOC((rs->num_phases + 1) * rs->num_taps * sizeof(float));
+    rs->block = (float*) SOKOL_MALLOC(block_frames * num_channels * sizeof(float));
+    rs->capacity = rs->num_taps + block_frames;
+    rs->history = (float*) SOKOL_MALLOC(rs->capacity * num_channels * sizeof(float));
+    SOKOL_ASSERT(rs->coeffs && rs->block && rs->history);
+    _saudio_mem_lock(rs->coeffs, (rs->num_phases + 1) * rs->num_taps * sizeof(float));
+    _saudio_mem_lock(rs->block, block_frames * num_channels * sizeof(float));
+    _saudio_mem_lock(rs->history, rs->capacity * num_channels * sizeof(float));
+    memset(rs->history, 0, rs->capacity * num_channels * sizeof(float));
+    rs->num_frames = 0;
+    rs->pos = 0.0;
+    /* when downsampling, the cutoff must move below the device's Nyquist frequency */
+    const double ratio = (dst_rate < src_rate) ? ((double)dst_rate / (double)src_rate) : 1.0;
+    _saudio_resampler_make_filter(rs, ratio * cutoff_scale, beta);
+    _saudio_atomic_store(&rs->state, _SAUDIO_RESAMPLER_STATE_ACTIVE);
+}
+
+_SOKOL_PRIVATE void _saudio_resampler_shutdown(_saudio_resampler_t* rs) {
+    if (rs->coeffs) {
+        _saudio_mem_unlock(rs->coeffs, (rs->num_phases + 1) * rs->num_taps * sizeof(float));
+        SOKOL_FREE(rs->coeffs);
+    }
+    if (rs->block) {
+        _saudio_mem_unlock(rs->block, rs->block_frames * rs->num_channels * sizeof(float));
+        SOKOL_FREE(rs->block);
+    }
+    if (rs->history) {
+        _saudio_mem_unlock(rs->history, rs->capacity * rs->num_channels * sizeof(float));
+        SOKOL_FREE(rs->history);
+    }
+    memset(rs, 0, sizeof(_saudio_resampler_t));
+}
+
+_SOKOL_PRIVATE float _saudio_dot(const float* a, const float* b, int n) {
+    int i = 0;
+    float sum = 0.0f;
+    #if defined(_SAUDIO_SSE)
+        __m128 acc = _mm_setzero_ps();
+        for (; (i + 4) <= n; i += 4) {
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        }
+        acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+        acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+        sum = _mm_cvtss_f32(acc);
+    #elif defined(_SAUDIO_NEON)
+        float32x4_t acc = vdupq_n_f32(0.0f);
+        for (; (i + 4) <= n; i += 4) {
+            acc = vmlaq_f32(acc, vld1q_f32(a + i), vld1q_f32(b + i));
+        }
+        const float32x2_t acc2 = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+        sum = vget_lane_f32(vpadd_f32(acc2, acc2), 0);
+    #endif
+    for (; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+/* make room in the history buffer and pull a new block of source frames */
+_SOKOL_PRIVATE void _saudio_resampler_refill(_saudio_resampler_t* rs) {
+    const int ipos = (int)rs->pos;
+    if (ipos >= rs->num_frames) {
+        rs->pos -= rs->num_frames;
+        rs->num_frames = 0;
+    }
+    else {
+        /* keep the frames which are still needed by the filter */
+        const int keep = rs->num_frames - ipos;
+        for (int c = 0; c < rs->num_channels; c++) {
+            float* plane = rs->history + c * rs->capacity;
+            memmove(plane, plane + ipos, keep * sizeof(float));
+        }
+        rs->pos -= ipos;
+        rs->num_frames = keep;
+    }
+    SOKOL_ASSERT((rs->num_frames + rs->block_frames) <= rs->capacity);
+    _saudio_fill_source(rs->block, rs->block_frames);
+    /* de-interleave into the planar history buffer */
+    for (int c = 0; c < rs->num_channels; c++) {
+        float* dst = rs->history + c * rs->capacity + rs->num_frames;
+        const float* src = rs->block + c;
+        for (int i = 0; i < rs->block_frames; i++) {
+            dst[i] = src[i * rs->num_channels];
+        }
+    }
+    rs->num_frames += rs->block_frames;
+}
+
+_SOKOL_PRIVATE void _saudio_resampler_process(_saudio_resampler_t* rs, float* buffer, int num_frames) {
+    const int num_channels = rs->num_channels;
+    const int num_taps = rs->num_taps;
+    for (int i = 0; i < num_frames; i++) {
+        while (((int)rs->pos + num_taps) > rs->num_frames) {
+            _saudio_resampler_refill(rs);
+        }
+        const int ipos = (int)rs->pos;
+        const int phase = (int)((rs->pos - ipos) * rs->num_phases + 0.5);
+        const float* h = rs->coeffs + phase * num_taps;
+        for (int c = 0; c < num_channels; c++) {
+            buffer[i * num_channels + c] = _saudio_dot(rs->history + c * rs->capacity + ipos, h, num_taps);
+        }
+        rs->pos += rs->step;
+    }
+}
+
+/* fill a stream buffer with new data, called by the backends (usually on the audio thread) */
+_SOKOL_PRIVATE void _saudio_fill_buffer(float* buffer, int num_frames) {
+    _saudio_stats_t* stats = &_saudio.stats;
+    const uint32_t reset_request = _saudio_atomic_load(&stats->reset_request);
+    if (reset_request != stats->reset_done) {
+        _saudio_stats_reset(stats);
+        stats->reset_done = reset_request;
+    }
+    const bool flush_denormals = _saudio.desc.realtime.flush_denormals;
+    const uint64_t fp_mode = flush_denormals ? _saudio_denormals_disable() : 0;
+    const uint64_t start = _saudio_now();
+    if (0 == _saudio.source_sample_rate) {
+        _saudio_fill_source(buffer, num_frames);
+    }
+    else {
+        switch (_saudio_atomic_load(&_saudio.resampler.state)) {
+            case _SAUDIO_RESAMPLER_STATE_BYPASS:
+                _saudio_fill_source(buffer, num_frames);
+                break;
+            case _SAUDIO_RESAMPLER_STATE_ACTIVE:
+                _saudio_resampler_process(&_saudio.resampler, buffer, num_frames);
+                break;
+            default:
+                /* the audio thread may run before saudio_setup() is complete */
+                memset(buffer, 0, num_frames * _saudio.bytes_per_frame);
+                break;
+        }
+    }
+    _saudio_stats_fill(stats, start, _saudio_now());
+    if (flush_denormals) {
+        _saudio_denormals_restore(fp_mode);
+    }
+}
+
+/*=== NULL BACKEND IMPLEMENTATION ============================================*/
+/* NOTE: CLOCK_MONOTONIC is missing in strict ANSI mode without _POSIX_C_SOURCE */
+#if defined(_SAUDIO_WINTHREADS) || (defined(_SAUDIO_PTHREADS) && defined(CLOCK_MONOTONIC))
+
+_SOKOL_PRIVATE void _saudio_null_sleep_until(uint64_t deadline) {
+    const uint64_t now = _saudio_now();
+    if (deadline > now) {
+        const uint64_t dur = deadline - now;
+        #if defined(_SAUDIO_WINTHREADS)
+            Sleep((DWORD)(dur / 1000000));
+        #else
+            struct timespec ts;
+            ts.tv_sec = (time_t) (dur / 1000000000);
+            ts.tv_nsec = (long) (dur % 1000000000);
+            nanosleep(&ts, 0);
+        #endif
+    }
+}
+
+/* write a little-endian RIFF/WAVE header for 32-bit float samples */
+_SOKOL_PRIVATE void _saudio_wav_put_u32(uint8_t* dst, uint32_t val) {
+    dst[0] = (uint8_t) val;
+    dst[1] = (uint8_t) (val >> 8);
+    dst[2] = (uint8_t) (val >> 16);
+    dst[3] = (uint8_t) (val >> 24);
+}
+
+_SOKOL_PRIVATE void _saudio_wav_put_u16(uint8_t* dst, uint16_t val) {
+    dst[0] = (uint8_t) val;
+    dst[1] = (uint8_t) (val >> 8);
+}
+
+_SOKOL_PRIVATE bool _saudio_wav_write_header(FILE* fp, int sample_rate, int num_channels, uint32_t data_bytes) {
+    uint8_t hdr[44];
+    const uint32_t bytes_per_frame = num_channels * sizeof(float);
+    memcpy(&hdr[0], "RIFF", 4);
+    _saudio_wav_put_u32(&hdr[4], 36 + data_bytes);
+    memcpy(&hdr[8], "WAVE", 4);
+    memcpy(&hdr[12], "fmt ", 4);
+    _saudio_wav_put_u32(&hdr[16], 16);
+    _saudio_wav_put_u16(&hdr[20], 3);     /* WAVE_FORMAT_IEEE_FLOAT */
+    _saudio_wav_put_u16(&hdr[22], (uint16_t)num_channels);
+    _saudio_wav_put_u32(&hdr[24], (uint32_t)sample_rate);
+    _saudio_wav_put_u32(&hdr[28], (uint32_t)sample_rate * bytes_per_frame);
+    _saudio_wav_put_u16(&hdr[32], (uint16_t)bytes_per_frame);
+    _saudio_wav_put_u16(&hdr[34], 32);
+    memcpy(&hdr[36], "data", 4);
+    _saudio_wav_put_u32(&hdr[40], data_bytes);
+    if (0 != fseek(fp, 0, SEEK_SET)) {
+        return false;
+    }
+    return 1 == fwrite(hdr, sizeof(hdr), 1, fp);
+}
+
+/* render one stream buffer, this is called on the null backend thread */
+_SOKOL_PRIVATE void _saudio_null_render(void) {
+    _saudio_null_backend_t* nb = &_saudio.null_backend;
+    _saudio_fill_buffer(nb->buffer, nb->buffer_frames);
+    if (nb->wav_file) {
+        if (1 == fwrite(nb->buffer, nb->buffer_byte_size, 1, nb->wav_file)) {
+            nb->wav_data_bytes += nb->buffer_byte_size;
+        }
+    }
+}
+
+_SOKOL_PRIVATE void _saudio_null_thread_loop(void) {
+    _saudio_null_backend_t* nb = &_saudio.null_backend;
+    _saudio_thread_init();
+    /* start streaming only after saudio_setup() has completed, so that
+       the output doesn't depend on how fast the rest of the setup runs
+    */
+    while (!_saudio_atomic_load(&_saudio.setup_done) && !_saudio_atomic_load(&nb->thread_stop)) {
+        _saudio_null_sleep_until(_saudio_now() + 1000000);
+    }
+    const uint64_t start = _saudio_now();
+    const double ns_per_frame = 1000000000.0 / ((double)_saudio.sample_rate * nb->speed);
+    uint64_t num_frames = 0;
+    while (!_saudio_atomic_load(&nb->thread_stop)) {
+        _saudio_null_render();
+        num_frames += nb->buffer_frames;
+        if (!nb->unthrottled) {
+            /* wait until the 'device' has played the rendered frames,
+               the deadline is absolute so that timer errors don't accumulate
+            */
+            const uint64_t deadline = start + (uint64_t)((double)num_frames * ns_per_frame);
+            if (_saudio_now() > deadline) {
+                /* the buffer was rendered too late, a real device would have run dry */
+                _saudio_stats_underrun();
+            }
+            _saudio_null_sleep_until(deadline);
+        }
+    }
+}
+
+#if defined(_SAUDIO_WINTHREADS)
+_SOKOL_PRIVATE DWORD WINAPI _saudio_null_thread_fn(LPVOID param) {
+    _SOKOL_UNUSED(param);
+    _saudio_null_thread_loop();
+    return 0;
+}
+#else
+_SOKOL_PRIVATE void* _saudio_null_thread_fn(void* param) {
+    _SOKOL_UNUSED(param);
+    _saudio_null_thread_loop();
+    return 0;
+}
+#endif
+
+_SOKOL_PRIVATE void _saudio_null_backend_release(void) {
+    _saudio_null_backend_t* nb = &_saudio.null_backend;
+    if (nb->wav_file) {
+        if (!_saudio_wav_write_header(nb->wav_file, _saudio.sample_rate, _saudio.num_channels, nb->wav_data_bytes)) {
+            SOKOL_LOG("sokol_audio.h: failed to finalize null backend WAV file");
+        }
+        fclose(nb->wav_file);
+        nb->wav_file = 0;
+    }
+    if (nb->buffer) {
+        _saudio_mem_unlock(nb->buffer, (size_t)nb->buffer_byte_size);
+        SOKOL_FREE(nb->buffer);
+        nb->buffer = 0;
+    }
+}
+
+_SOKOL_PRIVATE bool _saudio_null_backend_init(void) {
+    _saudio_null_backend_t* nb = &_saudio.null_backend;
+    const saudio_null_backend_desc* desc = &_saudio.desc.null_backend;
+    SOKOL_ASSERT(desc->speed >= 0.0f);
+    nb->speed = _saudio_def_flt(desc->speed, 1.0f);
+    nb->unthrottled = desc->unthrottled;
+    _saudio.bytes_per_frame = _saudio.num_channels * (int)sizeof(float);
+
+    /* allocate the streaming buffer */
+    nb->buffer_frames = _saudio.period_frames;
+    nb->buffer_byte_size = nb->buffer_frames * _saudio.bytes_per_frame;
+    nb->buffer = (float*) SOKOL_MALLOC((size_t)nb->buffer_byte_size);
+    if (0 == nb->buffer) {
+        SOKOL_LOG("sokol_audio.h: failed to allocate null backend buffer");
+        goto error;
+    }
+    memset(nb->buffer, 0, (size_t)nb->buffer_byte_size);
+    _saudio_mem_lock(nb->buffer, (size_t)nb->buffer_byte_size);
+
+    /* optional WAV output, the header is rewritten with the final size at shutdown */
+    if (desc->wav_path) {
+        nb->wav_file = fopen(desc->wav_path, "wb");
+        if (!nb->wav_file || !_saudio_wav_write_header(nb->wav_file, _saudio.sample_rate, _saudio.num_channels, 0)) {
+            SOKOL_LOG("sokol_audio.h: failed to create null backend WAV file");
+            goto error;
+        }
+    }
+
+    /* create the streaming thread */
+    #if defined(_SAUDIO_WINTHREADS)
+        nb->thread = CreateThread(NULL, 0, _saudio_null_thread_fn, 0, 0, 0);
+        if (0 == nb->thread) {
+            goto error;
+        }
+    #else
+        if (0 != pthread_create(&nb->thread, 0, _saudio_null_thread_fn, 0)) {
+            goto error;
+        }
+    #endif
+    return true;
+error:
+    _saudio_null_backend_release();
+    return false;
+}
+
+_SOKOL_PRIVATE void _saudio_null_backend_shutdown(void) {
+    _saudio_null_backend_t* nb = &_saudio.null_backend;
+    _saudio_atomic_store(&nb->thread_stop, 1);
+    #if defined(_SAUDIO_WINTHREADS)
+        WaitForSingleObject(nb->thread, INFINITE);
+        CloseHandle(nb->thread);
+    #else
+        pthread_join(nb->thread, 0);
+    #endif
+    _saudio_null_backend_release();
+}
+
+#else /* no threads, null backend not supported */
+_SOKOL_PRIVATE bool _saudio_null_backend_init(void) {
+    SOKOL_LOG("sokol_audio.h: null backend not supported on this platform");
+    return false;
+}
+_SOKOL_PRIVATE void _saudio_null_backend_shutdown(void) { }
+#endif
+
+/*=== DUMMY BACKEND IMPLEMENTATION ===========================================*/
+#if defined(SOKOL_DUMMY_BACKEND)
+_SOKOL_PRIVATE bool _saudio_backend_init(void) {
+    _saudio.bytes_per_frame = _saudio.num_channels * sizeof(float);
+    return true;
+};
+_SOKOL_PRIVATE void _saudio_backend_shutdown(void) { };
+
+/*=== COREAUDIO BACKEND IMPLEMENTATION =======================================*/
+#elif defined(__APPLE__)
+
+/* NOTE: the buffer data callback is called on a separate thread! */
+_SOKOL_PRIVATE void _sapp_ca_callback(void* user_data, AudioQueueRef queue, AudioQueueBufferRef buffer) {
+    _SOKOL_UNUSED(user_data);
+    const int num_frames = buffer->mAudioDataByteSize / _saudio.bytes_per_frame;
+    _saudio_fill_buffer((float*)buffer->mAudioData, num_frames);
+    AudioQueueEnqueueBuffer(queue, buffer, 0, NULL);
+}
+
+_SOKOL_PRIVATE bool _saudio_backend_init(void) {
+    SOKOL_ASSERT(0 == _saudio.backend.ca_audio_queue);
+    /* low-latency mode isn't supported */
+    _saudio.period_frames = _saudio.buffer_frames;
+
+    /* create an audio queue with fp32 samples */
+    AudioStreamBasicDescription fmt;
+    memset(&fmt, 0, sizeof(fmt));
+    fmt.mSampleRate = (Float64) _saudio.sample_rate;
+    fmt.mFormatID = kAudioFormatLinearPCM;
+    fmt.mFormatFlags = kLinearPCMFormatFlagIsFloat | kAudioFormatFlagIsPacked;
+    fmt.mFramesPerPacket = 1;
+    fmt.mChannelsPerFrame = _saudio.num_channels;
+    fmt.mBytesPerFrame = sizeof(float) * _saudio.num_channels;
+    fmt.mBytesPerPacket = fmt.mBytesPerFrame;
+    fmt.mBitsPerChannel = 32;
+    OSStatus res = AudioQueueNewOutput(&fmt, _sapp_ca_callback, 0, NULL, NULL, 0, &_saudio.backend.ca_audio_queue);
+    SOKOL_ASSERT((res == 0) && _saudio.backend.ca_audio_queue);
+
+    /* create 2 audio buffers */
+    for (int i = 0; i < 2; i++) {
+        AudioQueueBufferRef buf = NULL;
+        const uint32_t buf_byte_size = _saudio.buffer_frames * fmt.mBytesPerFrame;
+        res = AudioQueueAllocateBuffer(_saudio.backend.ca_audio_queue, buf_byte_size, &buf);
+        SOKOL_ASSERT((res == 0) && buf);
+        buf->mAudioDataByteSize = buf_byte_size;
+        memset(buf->mAudioData, 0, buf->mAudioDataByteSize);
+        AudioQueueEnqueueBuffer(_saudio.backend.ca_audio_queue, buf, 0, NULL);
+    }
+
+    /* init or modify actual playback parameters */
+    _saudio.bytes_per_frame = fmt.mBytesPerFrame;
+
+    /* ...and start playback */
+    res = AudioQueueStart(_saudio.backend.ca_audio_queue, NULL);
+    SOKOL_ASSERT(0 == res);
+
+    return true;
+}
+
+_SOKOL_PRIVATE void _saudio_backend_shutdown(void) {
+    AudioQueueStop(_saudio.backend.ca_audio_queue, true);
+    AudioQueueDispose(_saudio.backend.ca_audio_queue, false);
+    _saudio.backend.ca_audio_queue = NULL;
+}
+
+/*=== ALSA BACKEND IMPLEMENTATION ============================================*/
+#elif (defined(__linux__) || defined(__unix__)) && !defined(__EMSCRIPTEN__) && !defined(__ANDROID__)
+
+/* the streaming callback runs in a separate thread */
+_SOKOL_PRIVATE void* _saudio_alsa_cb(void* param) {
     _SOKOL_UNUSED(param);
+    _saudio_thread_init();
     while (!_saudio.backend.thread_stop) {
         /* snd_pcm_writei() will be blocking until it needs data */
         int write_res = snd_pcm_writei(_saudio.backend.device, _saudio.backend.buffer, _saudio.backend.buffer_frames);
         if (write_res < 0) {
-            /* underrun occurred */
-            snd_pcm_prepare(_saudio.backend.device);
+            /* underrun occurred (or the device was suspended) */
+            _saudio_stats_underrun();
+            if (0 > snd_pcm_recover(_saudio.backend.device, write_res, 1)) {
+                snd_pcm_prepare(_saudio.backend.device);
+            }
         }
         else {
-            /* fill the streaming buffer with new data */
-            if (_saudio_has_callback()) {
-                _saudio_stream_callback(_saudio.backend.buffer, _saudio.backend.buffer_frames, _saudio.num_channels);
-            }
-            else {
-                if (0 == _saudio_fifo_read(&_saudio.fifo, (uint8_t*)_saudio.backend.buffer, _saudio.backend.buffer_byte_size)) {
-                    /* not enough read data available, fill the entire buffer with silence */
-                    memset(_saudio.backend.buffer, 0, _saudio.backend.buffer_byte_size);
-                }
+            /* number of frames between the write position and the speaker */
+            snd_pcm_sframes_t delay = 0;
+            if ((0 == snd_pcm_delay(_saudio.backend.device, &delay)) && (delay >= 0)) {
+                _saudio_stats_latency((uint32_t)delay);
             }
+            /* fill the streaming buffer with new data */
+            _saudio_fill_buffer(_saudio.backend.buffer, _saudio.backend.buffer_frames);
         }
     }
     return 0;
@@ -1045,6 +3025,14 @@ _SOKOL_PRIVATE bool _saudio_backend_init(void) {
     snd_pcm_hw_params_set_access(_saudio.backend.device, params, SND_PCM_ACCESS_RW_INTERLEAVED);
     snd_pcm_hw_params_set_channels(_saudio.backend.device, params, _saudio.num_channels);
     snd_pcm_hw_params_set_buffer_size(_saudio.backend.device, params, _saudio.buffer_frames);
+    if (_saudio.period_frames < _saudio.buffer_frames) {
+        /* low-latency mode: the device wakes up the audio thread once per period */
+        snd_pcm_uframes_t period_frames = _saudio.period_frames;
+        dir = 0;
+        if (0 > snd_pcm_hw_params_set_period_size_near(_saudio.backend.device, params, &period_frames, &dir)) {
+            SOKOL_LOG("sokol_audio.h: ALSA failed to set period size");
+        }
+    }
     if (0 > snd_pcm_hw_params_test_format(_saudio.backend.device, params, SND_PCM_FORMAT_FLOAT_LE)) {
         goto error;
     }
@@ -1067,11 +3055,36 @@ _SOKOL_PRIVATE bool _saudio_backend_init(void) {
     SOKOL_ASSERT((int)val == _saudio.num_channels);
     _saudio.bytes_per_frame = _saudio.num_channels * sizeof(float);
 
-    /* allocate the streaming buffer */
-    _saudio.backend.buffer_byte_size = _saudio.buffer_frames * _saudio.bytes_per_frame;
-    _saudio.backend.buffer_frames = _saudio.buffer_frames;
+    /* read back the period size the device actually picked, in the push
+       model this is rounded down to a multiple of packet_frames so that
+       packets are never split
+    */
+    if (_saudio.period_frames < _saudio.buffer_frames) {
+        snd_pcm_uframes_t period_frames = 0;
+        dir = 0;
+        if ((0 == snd_pcm_hw_params_get_period_size(params, &period_frames, &dir)) && (period_frames > 0)) {
+            int actual_period_frames = (int)period_frames;
+            if (actual_period_frames > _saudio.buffer_frames) {
+                actual_period_frames = _saudio.buffer_frames;
+            }
+            if (!_saudio_has_callback()) {
+                actual_period_frames -= actual_period_frames % _saudio.packet_frames;
+                if (actual_period_frames < _saudio.packet_frames) {
+                    actual_period_frames = _saudio.packet_frames;
+                }
+            }
+            _saudio.period_frames = actual_period_frames;
+        }
+    }
+
+    /* allocate the streaming buffer, this is written to the device one
+       period at a time
+    */
+    _saudio.backend.buffer_byte_size = _saudio.period_frames * _saudio.bytes_per_frame;
+    _saudio.backend.buffer_frames = _saudio.period_frames;
     _saudio.backend.buffer = (float*) SOKOL_MALLOC(_saudio.backend.buffer_byte_size);
     memset(_saudio.backend.buffer, 0, _saudio.backend.buffer_byte_size);
+    _saudio_mem_lock(_saudio.backend.buffer, _saudio.backend.buffer_byte_size);
 
     /* create the buffer-streaming start thread */
     if (0 != pthread_create(&_saudio.backend.thread, 0, _saudio_alsa_cb, 0)) {
@@ -1093,6 +3106,7 @@ _SOKOL_PRIVATE void _saudio_backend_shutdown(void) {
     pthread_join(_saudio.backend.thread, 0);
     snd_pcm_drain(_saudio.backend.device);
     snd_pcm_close(_saudio.backend.device);
+    _saudio_mem_unlock(_saudio.backend.buffer, _saudio.backend.buffer_byte_size);
     SOKOL_FREE(_saudio.backend.buffer);
 };
 
@@ -1101,15 +3115,7 @@ _SOKOL_PRIVATE void _saudio_backend_shutdown(void) {
 
 /* fill intermediate buffer with new data and reset buffer_pos */
 _SOKOL_PRIVATE void _saudio_wasapi_fill_buffer(void) {
-    if (_saudio_has_callback()) {
-        _saudio_stream_callback(_saudio.backend.thread.src_buffer, _saudio.backend.thread.src_buffer_frames, _saudio.num_channels);
-    }
-    else {
-        if (0 == _saudio_fifo_read(&_saudio.fifo, (uint8_t*)_saudio.backend.thread.src_buffer, _saudio.backend.thread.src_buffer_byte_size)) {
-            /* not enough read data available, fill the entire buffer with silence */
-            memset(_saudio.backend.thread.src_buffer, 0, _saudio.backend.thread.src_buffer_byte_size);
-        }
-    }
+    _saudio_fill_buffer(_saudio.backend.thread.src_buffer, _saudio.backend.thread.src_buffer_frames);
 }
 
 _SOKOL_PRIVATE void _saudio_wasapi_submit_buffer(UINT32 num_frames) {
@@ -1120,17 +3126,23 @@ _SOKOL_PRIVATE void _saudio_wasapi_submit_buffer(UINT32 num_frames) {
     SOKOL_ASSERT(wasapi_buffer);
 
     /* convert float samples to int16_t, refill float buffer if needed */
-    const int num_samples = num_frames * _saudio.num_channels;
+    int num_samples = num_frames * _saudio.num_channels;
     int16_t* dst = (int16_t*) wasapi_buffer;
     uint32_t buffer_pos = _saudio.backend.thread.src_buffer_pos;
     const uint32_t buffer_float_size = _saudio.backend.thread.src_buffer_byte_size / sizeof(float);
-    float* src = _saudio.backend.thread.src_buffer;
-    for (int i = 0; i < num_samples; i++) {
+    const float* src = _saudio.backend.thread.src_buffer;
+    while (num_samples > 0) {
         if (0 == buffer_pos) {
             _saudio_wasapi_fill_buffer();
         }
-        dst[i] = (int16_t) (src[buffer_pos] * 0x7FFF);
-        buffer_pos += 1;
+        int n = (int) (buffer_float_size - buffer_pos);
+        if (n > num_samples) {
+            n = num_samples;
+        }
+        _saudio_f32_to_s16(dst, src + buffer_pos, n);
+        dst += n;
+        num_samples -= n;
+        buffer_pos += n;
         if (buffer_pos == buffer_float_size) {
             buffer_pos = 0;
         }
@@ -1142,6 +3154,7 @@ _SOKOL_PRIVATE void _saudio_wasapi_submit_buffer(UINT32 num_frames) {
 
 _SOKOL_PRIVATE DWORD WINAPI _saudio_wasapi_thread_fn(LPVOID param) {
     (void)param;
+    _saudio_thread_init();
     _saudio_wasapi_submit_buffer(_saudio.backend.thread.src_buffer_frames);
     IAudioClient_Start(_saudio.backend.audio_client);
     while (!_saudio.backend.thread.stop) {
@@ -1151,16 +3164,27 @@ _SOKOL_PRIVATE DWORD WINAPI _saudio_wasapi_thread_fn(LPVOID param) {
             continue;
         }
         SOKOL_ASSERT(_saudio.backend.thread.dst_buffer_frames >= padding);
+        if (0 == padding) {
+            /* the device has played all queued frames before we could refill */
+            _saudio_stats_underrun();
+        }
         UINT32 num_frames = _saudio.backend.thread.dst_buffer_frames - padding;
         if (num_frames > 0) {
             _saudio_wasapi_submit_buffer(num_frames);
         }
+        /* the frames queued in the device buffer after the refill, plus
+           the latency of the audio engine itself
+        */
+        if (SUCCEEDED(IAudioClient_GetCurrentPadding(_saudio.backend.audio_client, &padding))) {
+            _saudio_stats_latency(padding + _saudio.backend.thread.stream_latency_frames);
+        }
     }
     return 0;
 }
 
 _SOKOL_PRIVATE void _saudio_wasapi_release(void) {
     if (_saudio.backend.thread.src_buffer) {
+        _saudio_mem_unlock(_saudio.backend.thread.src_buffer, _saudio.backend.thread.src_buffer_byte_size);
         SOKOL_FREE(_saudio.backend.thread.src_buffer);
         _saudio.backend.thread.src_buffer = 0;
     }
@@ -1188,6 +3212,8 @@ _SOKOL_PRIVATE void _saudio_wasapi_release(void) {
 
 _SOKOL_PRIVATE bool _saudio_backend_init(void) {
     REFERENCE_TIME dur;
+    /* low-latency mode isn't supported */
+    _saudio.period_frames = _saudio.buffer_frames;
     if (FAILED(CoInitializeEx(0, COINIT_MULTITHREADED))) {
         SOKOL_LOG("sokol_audio wasapi: CoInitializeEx failed");
         return false;
@@ -1242,6 +3268,11 @@ _SOKOL_PRIVATE bool _saudio_backend_init(void) {
         SOKOL_LOG("sokol_audio wasapi: audio client get buffer size failed");
         goto error;
     }
+    REFERENCE_TIME stream_latency = 0;
+    if (SUCCEEDED(IAudioClient_GetStreamLatency(_saudio.backend.audio_client, &stream_latency))) {
+        /* REFERENCE_TIME is in 100-nanosecond units */
+        _saudio.backend.thread.stream_latency_frames = (UINT32) ((stream_latency * _saudio.sample_rate) / 10000000);
+    }
     if (FAILED(IAudioClient_GetService(_saudio.backend.audio_client,
         _SOKOL_AUDIO_WIN32COM_ID(_saudio_IID_IAudioRenderClient),
         (void**)&_saudio.backend.render_client)))
@@ -1261,6 +3292,7 @@ _SOKOL_PRIVATE bool _saudio_backend_init(void) {
     /* allocate an intermediate buffer for sample format conversion */
     _saudio.backend.thread.src_buffer = (float*) SOKOL_MALLOC(_saudio.backend.thread.src_buffer_byte_size);
     SOKOL_ASSERT(_saudio.backend.thread.src_buffer);
+    _saudio_mem_lock(_saudio.backend.thread.src_buffer, _saudio.backend.thread.src_buffer_byte_size);
 
     /* create streaming thread */
     _saudio.backend.thread.thread_handle = CreateThread(NULL, 0, _saudio_wasapi_thread_fn, 0, 0, 0);
@@ -1299,16 +3331,7 @@ extern "C" {
 EMSCRIPTEN_KEEPALIVE int _saudio_emsc_pull(int num_frames) {
     SOKOL_ASSERT(_saudio.backend.buffer);
     if (num_frames == _saudio.buffer_frames) {
-        if (_saudio_has_callback()) {
-            _saudio_stream_callback((float*)_saudio.backend.buffer, num_frames, _saudio.num_channels);
-        }
-        else {
-            const int num_bytes = num_frames * _saudio.bytes_per_frame;
-            if (0 == _saudio_fifo_read(&_saudio.fifo, _saudio.backend.buffer, num_bytes)) {
-                /* not enough read data available, fill the entire buffer with silence */
-                memset(_saudio.backend.buffer, 0, num_bytes);
-            }
-        }
+        _saudio_fill_buffer((float*)_saudio.backend.buffer, num_frames);
         int res = (int) _saudio.backend.buffer;
         return res;
     }
@@ -1414,6 +3437,8 @@ _SOKOL_PRIVATE bool _saudio_backend_init(void) {
         _saudio.bytes_per_frame = sizeof(float) * _saudio.num_channels;
         _saudio.sample_rate = saudio_js_sample_rate();
         _saudio.buffer_frames = saudio_js_buffer_frames();
+        /* low-latency mode isn't supported */
+        _saudio.period_frames = _saudio.buffer_frames;
         const int buf_size = _saudio.buffer_frames * _saudio.bytes_per_frame;
         _saudio.backend.buffer = (uint8_t*) SOKOL_MALLOC(buf_size);
         return true;
@@ -1492,17 +3517,7 @@ _SOKOL_PRIVATE bool _saudio_semaphore_wait(_saudio_semaphore_t* sem)
 
 /* fill intermediate buffer with new data and reset buffer_pos */
 _SOKOL_PRIVATE void _saudio_opensles_fill_buffer(void) {
-    int src_buffer_frames = _saudio.buffer_frames;
-    if (_saudio_has_callback()) {
-        _saudio_stream_callback(_saudio.backend.src_buffer, src_buffer_frames, _saudio.num_channels);
-    }
-    else {
-        const int src_buffer_byte_size = src_buffer_frames * _saudio.num_channels * sizeof(float);
-        if (0 == _saudio_fifo_read(&_saudio.fifo, (uint8_t*)_saudio.backend.src_buffer, src_buffer_byte_size)) {
-            /* not enough read data available, fill the entire buffer with silence */
-            memset(_saudio.backend.src_buffer, 0x0, src_buffer_byte_size);
-        }
-    }
+    _saudio_fill_buffer(_saudio.backend.src_buffer, _saudio.buffer_frames);
 }
 
 _SOKOL_PRIVATE void SLAPIENTRY _saudio_opensles_play_cb(SLPlayItf player, void *context, SLuint32 event) {
@@ -1515,6 +3530,7 @@ _SOKOL_PRIVATE void SLAPIENTRY _saudio_opensles_play_cb(SLPlayItf player, void *
 }
 
 _SOKOL_PRIVATE void* _saudio_opensles_thread_fn(void* param) {
+    _saudio_thread_init();
     while (!_saudio.backend.thread_stop)  {
         /* get next output buffer, advance, next buffer. */
         int16_t* out_buffer = _saudio.backend.output_buffers[_saudio.backend.active_buffer];
@@ -1528,9 +3544,7 @@ _SOKOL_PRIVATE void* _saudio_opensles_thread_fn(void* param) {
         /* fill the next buffer */
         _saudio_opensles_fill_buffer();
         const int num_samples = _saudio.num_channels * _saudio.buffer_frames;
-        for (int i = 0; i < num_samples; ++i) {
-            next_buffer[i] = (int16_t) (_saudio.backend.src_buffer[i] * 0x7FFF);
-        }
+        _saudio_f32_to_s16(next_buffer, _saudio.backend.src_buffer, num_samples);
 
         _saudio_semaphore_wait(&_saudio.backend.buffer_sem);
     }
@@ -1555,19 +3569,24 @@ _SOKOL_PRIVATE void _saudio_backend_shutdown(void) {
     }
 
     for (int i = 0; i < SAUDIO_NUM_BUFFERS; i++) {
+        _saudio_mem_unlock(_saudio.backend.output_buffers[i], sizeof(int16_t) * _saudio.num_channels * _saudio.buffer_frames);
         SOKOL_FREE(_saudio.backend.output_buffers[i]);
     }
+    _saudio_mem_unlock(_saudio.backend.src_buffer, _saudio.bytes_per_frame * _saudio.buffer_frames);
     SOKOL_FREE(_saudio.backend.src_buffer);
 }
 
 _SOKOL_PRIVATE bool _saudio_backend_init(void) {
     _saudio.bytes_per_frame = sizeof(float) * _saudio.num_channels;
+    /* low-latency mode isn't supported */
+    _saudio.period_frames = _saudio.buffer_frames;
 
     for (int i = 0; i < SAUDIO_NUM_BUFFERS; ++i) {
         const int buffer_size_bytes = sizeof(int16_t) * _saudio.num_channels * _saudio.buffer_frames;
         _saudio.backend.output_buffers[i] = (int16_t*) SOKOL_MALLOC(buffer_size_bytes);
         SOKOL_ASSERT(_saudio.backend.output_buffers[i]);
         memset(_saudio.backend.output_buffers[i], 0x0, buffer_size_bytes);
+        _saudio_mem_lock(_saudio.backend.output_buffers[i], buffer_size_bytes);
     }
 
     {
@@ -1575,6 +3594,7 @@ _SOKOL_PRIVATE bool _saudio_backend_init(void) {
         _saudio.backend.src_buffer = (float*) SOKOL_MALLOC(buffer_size_bytes);
         SOKOL_ASSERT(_saudio.backend.src_buffer);
         memset(_saudio.backend.src_buffer, 0x0, buffer_size_bytes);
+        _saudio_mem_lock(_saudio.backend.src_buffer, buffer_size_bytes);
     }
 
 
@@ -1695,23 +3715,82 @@ SOKOL_API_IMPL void saudio_setup(const saudio_desc* desc) {
     _saudio.stream_userdata_cb = desc->stream_userdata_cb;
     _saudio.user_data = desc->user_data;
     _saudio.sample_rate = _saudio_def(_saudio.desc.sample_rate, _SAUDIO_DEFAULT_SAMPLE_RATE);
-    _saudio.buffer_frames = _saudio_def(_saudio.desc.buffer_frames, _SAUDIO_DEFAULT_BUFFER_FRAMES);
+    /* low-latency mode is only supported by the ALSA and null backends */
+    #if defined(_SAUDIO_LOW_LATENCY_BACKEND)
+    const bool low_latency = (_saudio.desc.period_frames > 0);
+    #else
+    const bool low_latency = (_saudio.desc.period_frames > 0) && _saudio.desc.null_backend.enabled;
+    #endif
+    if (low_latency) {
+        /* by default, the device buffer holds 3 periods */
+        _saudio.period_frames = _saudio.desc.period_frames;
+        _saudio.buffer_frames = _saudio_def(_saudio.desc.buffer_frames, 3 * _saudio.period_frames);
+        SOKOL_ASSERT(_saudio.period_frames <= _saudio.buffer_frames);
+    }
+    else {
+        _saudio.buffer_frames = _saudio_def(_saudio.desc.buffer_frames, _SAUDIO_DEFAULT_BUFFER_FRAMES);
+        _saudio.period_frames = _saudio.buffer_frames;
+    }
     _saudio.packet_frames = _saudio_def(_saudio.desc.packet_frames, _SAUDIO_DEFAULT_PACKET_FRAMES);
     _saudio.num_packets = _saudio_def(_saudio.desc.num_packets, _SAUDIO_DEFAULT_NUM_PACKETS);
     _saudio.num_channels = _saudio_def(_saudio.desc.num_channels, 1);
-    _saudio_fifo_init_mutex(&_saudio.fifo);
-    if (_saudio_backend_init()) {
+    /* the state is touched by the audio thread (ring queues, stats, voices) */
+    _saudio_mem_lock(&_saudio, sizeof(_saudio));
+    if (_saudio.desc.num_voices > 0) {
+        /* the mixer must be ready before the backend starts the audio thread */
+        _saudio_mixer_init(&_saudio.mixer, _saudio.desc.num_voices, _saudio_def(_saudio.desc.num_mixer_commands, _SAUDIO_DEFAULT_NUM_MIXER_COMMANDS));
+    }
+    _saudio_stats_reset(&_saudio.stats);
+    _saudio.source_sample_rate = _saudio.desc.source_sample_rate;
+    _saudio.sample_format = _saudio_def(_saudio.desc.sample_format, SAUDIO_SAMPLEFORMAT_FLOAT32);
+    _saudio.push_bytes_per_frame = _saudio.num_channels * _saudio_sample_size(_saudio.sample_format);
+    _saudio.use_null_backend = _saudio.desc.null_backend.enabled;
+    const bool backend_valid = _saudio.use_null_backend ? _saudio_null_backend_init() : _saudio_backend_init();
+    if (backend_valid) {
         SOKOL_ASSERT(0 == (_saudio.buffer_frames % _saudio.packet_frames));
+        SOKOL_ASSERT(_saudio_has_callback() || (0 == (_saudio.period_frames % _saudio.packet_frames)));
         SOKOL_ASSERT(_saudio.bytes_per_frame > 0);
-        _saudio_fifo_init(&_saudio.fifo, _saudio.packet_frames * _saudio.bytes_per_frame, _saudio.num_packets);
+        _saudio_fifo_init(&_saudio.fifo, _saudio.packet_frames * _saudio.push_bytes_per_frame, _saudio.num_packets);
+        if (_saudio.source_sample_rate > 0) {
+            /* the device sample rate is only known after the backend is initialized */
+            _saudio_resampler_init(&_saudio.resampler,
+                _saudio.source_sample_rate,
+                _saudio.sample_rate,
+                _saudio.num_channels,
+                _saudio.period_frames,
+                _saudio.desc.resampler_quality);
+        }
+        if (_saudio.desc.max_streams > 0) {
+            SOKOL_ASSERT(0 == (_saudio.period_frames % _saudio.packet_frames));
+            _saudio_streams_init(&_saudio.streams,
+                _saudio.desc.max_streams,
+                _saudio.packet_frames * _saudio.push_bytes_per_frame,
+                _saudio.num_packets,
+                _saudio.buffer_frames,
+                _saudio.num_channels);
+        }
         _saudio.valid = true;
+        _saudio_atomic_store(&_saudio.setup_done, 1);
+    }
+    else {
+        _saudio_mixer_shutdown(&_saudio.mixer);
+        _saudio_mem_unlock(&_saudio, sizeof(_saudio));
     }
 }
 
 SOKOL_API_IMPL void saudio_shutdown(void) {
     if (_saudio.valid) {
-        _saudio_backend_shutdown();
+        if (_saudio.use_null_backend) {
+            _saudio_null_backend_shutdown();
+        }
+        else {
+            _saudio_backend_shutdown();
+        }
         _saudio_fifo_shutdown(&_saudio.fifo);
+        _saudio_mixer_shutdown(&_saudio.mixer);
+        _saudio_streams_shutdown(&_saudio.streams);
+        _saudio_resampler_shutdown(&_saudio.resampler);
+        _saudio_mem_unlock(&_saudio, sizeof(_saudio));
         _saudio.valid = false;
     }
 }
@@ -1736,13 +3815,17 @@ SOKOL_API_IMPL int saudio_buffer_frames(void) {
     return _saudio.buffer_frames;
 }
 
+SOKOL_API_IMPL int saudio_period_frames(void) {
+    return _saudio.period_frames;
+}
+
 SOKOL_API_IMPL int saudio_channels(void) {
     return _saudio.num_channels;
 }
 
 SOKOL_API_IMPL int saudio_expect(void) {
     if (_saudio.valid) {
-        const int num_frames = _saudio_fifo_writable_bytes(&_saudio.fifo) / _saudio.bytes_per_frame;
+        const int num_frames = _saudio_fifo_writable_bytes(&_saudio.fifo) / _saudio.push_bytes_per_frame;
         return num_frames;
     }
     else {
@@ -1750,18 +3833,258 @@ SOKOL_API_IMPL int saudio_expect(void) {
     }
 }
 
+SOKOL_API_IMPL int saudio_push_samples(const void* samples, int num_frames) {
+    SOKOL_ASSERT(samples && (num_frames > 0));
+    if (_saudio.valid) {
+        const int num_bytes = num_frames * _saudio.push_bytes_per_frame;
+        const int num_written = _saudio_fifo_write(&_saudio.fifo, (const uint8_t*)samples, num_bytes);
+        return num_written / _saudio.push_bytes_per_frame;
+    }
+    else {
+        return 0;
+    }
+}
+
 SOKOL_API_IMPL int saudio_push(const float* frames, int num_frames) {
-    SOKOL_ASSERT(frames && (num_frames > 0));
+    /* use saudio_push_samples() for other sample formats */
+    SOKOL_ASSERT(_saudio.sample_format == SAUDIO_SAMPLEFORMAT_FLOAT32);
+    return saudio_push_samples(frames, num_frames);
+}
+
+SOKOL_API_IMPL saudio_voice saudio_play(const saudio_voice_desc* desc) {
+    SOKOL_ASSERT(desc && desc->samples && (desc->num_frames > 0));
+    SOKOL_ASSERT((desc->num_channels >= 0) && (desc->num_channels <= 2));
+    saudio_voice voice = { 0 };
+    _saudio_mixer_t* mixer = &_saudio.mixer;
+    if (!(_saudio.valid && mixer->valid)) {
+        return voice;
+    }
+    /* find a free voice slot, a slot is free when it was never used,
+       explicitly stopped, or the audio thread has finished playing it
+    */
+    for (int i = 0; i < mixer->num_voices; i++) {
+        const uint32_t id = mixer->voice_ids[i];
+        if ((0 == id) || (_saudio_atomic_load(&mixer->finished_ids[i]) == id)) {
+            mixer->unique_counter = (mixer->unique_counter + 1) & 0xFFFF;
+            if (0 == mixer->unique_counter) {
+                mixer->unique_counter = 1;
+            }
+            _saudio_mixer_cmd_t cmd;
+            memset(&cmd, 0, sizeof(cmd));
+            cmd.type = _SAUDIO_MIXER_CMD_PLAY;
+            cmd.voice_id = _saudio_mixer_make_id((uint32_t)i, mixer->unique_counter);
+            cmd.samples = desc->samples;
+            cmd.num_frames = desc->num_frames;
+            cmd.num_channels = _saudio_def(desc->num_channels, 1);
+            cmd.volume = _saudio_def_flt(desc->volume, 1.0f);
+            cmd.pan = desc->pan;
+            cmd.loop = desc->loop;
+            if (_saudio_mixer_send(mixer, &cmd)) {
+                mixer->voice_ids[i] = cmd.voice_id;
+                voice.id = cmd.voice_id;
+            }
+            break;
+        }
+    }
+    return voice;
+}
+
+SOKOL_API_IMPL void saudio_stop(saudio_voice voice) {
+    _saudio_mixer_send_voice_cmd(voice, _SAUDIO_MIXER_CMD_STOP, 0.0f, 0.0f, false);
+}
+
+SOKOL_API_IMPL void saudio_voice_volume(saudio_voice voice, float volume) {
+    _saudio_mixer_send_voice_cmd(voice, _SAUDIO_MIXER_CMD_VOLUME, volume, 0.0f, false);
+}
+
+SOKOL_API_IMPL void saudio_voice_pan(saudio_voice voice, float pan) {
+    SOKOL_ASSERT((pan >= -1.0f) && (pan <= 1.0f));
+    _saudio_mixer_send_voice_cmd(voice, _SAUDIO_MIXER_CMD_PAN, 0.0f, pan, false);
+}
+
+SOKOL_API_IMPL void saudio_voice_loop(saudio_voice voice, bool loop) {
+    _saudio_mixer_send_voice_cmd(voice, _SAUDIO_MIXER_CMD_LOOP, 0.0f, 0.0f, loop);
+}
+
+SOKOL_API_IMPL bool saudio_voice_playing(saudio_voice voice) {
+    return _saudio_mixer_lookup(&_saudio.mixer, voice.id) >= 0;
+}
+
+SOKOL_API_IMPL saudio_mixer_stats saudio_query_mixer_stats(void) {
+    saudio_mixer_stats stats;
+    memset(&stats, 0, sizeof(stats));
+    _saudio_mixer_t* mixer = &_saudio.mixer;
+    if (mixer->valid) {
+        stats.num_voices = mixer->num_voices;
+        stats.num_playing_voices = (int) _saudio_atomic_load(&mixer->stats.num_playing_voices);
+        stats.max_playing_voices = (int) _saudio_atomic_load(&mixer->stats.max_playing_voices);
+        stats.num_mix_calls = _saudio_atomic_load(&mixer->stats.num_mix_calls);
+        stats.last_mix_ms = (float) _saudio_atomic_load(&mixer->stats.last_mix_ns) / 1000000.0f;
+        stats.avg_mix_ms = (float) _saudio_atomic_load(&mixer->stats.avg_mix_ns) / 1000000.0f;
+        stats.max_mix_ms = (float) _saudio_atomic_load(&mixer->stats.max_mix_ns) / 1000000.0f;
+        const uint32_t num_frames = _saudio_atomic_load(&mixer->stats.last_num_frames);
+        /* the mixer runs at the source sample rate */
+        const int sample_rate = (_saudio.source_sample_rate > 0) ? _saudio.source_sample_rate : _saudio.sample_rate;
+        if ((num_frames > 0) && (sample_rate > 0)) {
+            const float buffer_ms = ((float)num_frames * 1000.0f) / (float)sample_rate;
+            stats.cpu_load = stats.avg_mix_ms / buffer_ms;
+        }
+        stats.num_dropped_commands = mixer->num_dropped_commands;
+    }
+    return stats;
+}
+
+SOKOL_API_IMPL saudio_stats saudio_query_stats(void) {
+    saudio_stats res;
+    memset(&res, 0, sizeof(res));
     if (_saudio.valid) {
-        const int num_bytes = num_frames * _saudio.bytes_per_frame;
-        const int num_written = _saudio_fifo_write(&_saudio.fifo, (const uint8_t*)frames, num_bytes);
-        return num_written / _saudio.bytes_per_frame;
+        _saudio_stats_t* stats = &_saudio.stats;
+        res.num_buffers = _saudio_atomic_load(&stats->num_buffers);
+        res.num_underruns = _saudio_atomic_load(&stats->num_underruns);
+        res.num_silence_buffers = _saudio_atomic_load(&stats->num_silence_buffers);
+        const uint32_t fifo_min_frames = _saudio_atomic_load(&stats->fifo_min_frames);
+        res.fifo_min_frames = (0xFFFFFFFF == fifo_min_frames) ? 0 : (int)fifo_min_frames;
+        res.fifo_avg_frames = (int) _saudio_atomic_load(&stats->fifo_avg_frames);
+        res.fifo_max_frames = (int) _saudio_atomic_load(&stats->fifo_max_frames);
+        res.fill_avg_ms = (float) _saudio_atomic_load(&stats->fill_avg_ns) / 1000000.0f;
+        res.fill_max_ms = (float) _saudio_atomic_load(&stats->fill_max_ns) / 1000000.0f;
+        for (int i = 0; i < SAUDIO_STATS_HISTOGRAM_SIZE; i++) {
+            res.fill_histogram[i] = _saudio_atomic_load(&stats->fill_histogram[i]);
+        }
+        /* if the backend doesn't report the latency, estimate it from the buffer size */
+        uint32_t latency_frames = _saudio_atomic_load(&stats->latency_frames);
+        res.latency_measured = (latency_frames > 0);
+        if (0 == latency_frames) {
+            latency_frames = (uint32_t)_saudio.buffer_frames;
+        }
+        res.latency_ms = ((float)latency_frames * 1000.0f) / (float)_saudio.sample_rate;
+        if (_SAUDIO_RESAMPLER_STATE_ACTIVE == _saudio_atomic_load(&_saudio.resampler.state)) {
+            res.latency_ms += ((float)(_saudio.resampler.num_taps / 2) * 1000.0f) / (float)_saudio.source_sample_rate;
+        }
+        res.realtime_thread = (0 != _saudio_atomic_load(&_saudio.realtime_thread));
+        res.memory_locked = _saudio.desc.realtime.lock_memory && !_saudio.mem_lock_failed;
+    }
+    return res;
+}
+
+SOKOL_API_IMPL void saudio_reset_stats(void) {
+    _saudio_atomic_store(&_saudio.stats.reset_request, _saudio_atomic_load(&_saudio.stats.reset_request) + 1);
+}
+
+SOKOL_API_IMPL saudio_stream saudio_make_stream(const saudio_stream_desc* desc) {
+    SOKOL_ASSERT(desc);
+    saudio_stream stream = { 0 };
+    _saudio_streams_t* st = &_saudio.streams;
+    if (!(_saudio.valid && st->valid)) {
+        return stream;
+    }
+    for (int i = 0; i < st->num_streams; i++) {
+        _saudio_stream_t* s = &st->streams[i];
+        if (_saudio_streams_slot_free(st, s)) {
+            st->unique_counter = (st->unique_counter + 1) & 0xFFFF;
+            if (0 == st->unique_counter) {
+                st->unique_counter = 1;
+            }
+            s->id = _saudio_mixer_make_id((uint32_t)i, st->unique_counter);
+            _saudio_stream_set_name(s, desc->name);
+            s->stream_cb = desc->stream_cb;
+            s->user_data = desc->user_data;
+            _saudio_fifo_reset(&s->fifo);
+            _saudio_stream_stats_reset(s);
+            _saudio_atomic_store(&s->gain, _saudio_float_bits(_saudio_def_flt(desc->gain, 1.0f)));
+            /* publish the stream to the audio thread */
+            _saudio_atomic_store(&s->active_id, s->id);
+            stream.id = s->id;
+            break;
+        }
+    }
+    return stream;
+}
+
+SOKOL_API_IMPL void saudio_destroy_stream(saudio_stream stream) {
+    _saudio_streams_t* st = &_saudio.streams;
+    _saudio_stream_t* s = _saudio_streams_lookup(st, stream.id);
+    if (s) {
+        _saudio_atomic_store(&s->active_id, 0);
+        s->retire_epoch = _saudio_atomic_load(&st->epoch);
+        s->retired = true;
+        s->id = 0;
+    }
+}
+
+SOKOL_API_IMPL saudio_stream saudio_find_stream(const char* name) {
+    SOKOL_ASSERT(name);
+    saudio_stream stream = { 0 };
+    _saudio_streams_t* st = &_saudio.streams;
+    if (st->valid) {
+        for (int i = 0; i < st->num_streams; i++) {
+            const _saudio_stream_t* s = &st->streams[i];
+            if ((0 != s->id) && (0 != s->name[0]) && (0 == strncmp(s->name, name, SAUDIO_STREAM_NAME_SIZE - 1))) {
+                stream.id = s->id;
+                break;
+            }
+        }
+    }
+    return stream;
+}
+
+SOKOL_API_IMPL void saudio_stream_gain(saudio_stream stream, float gain) {
+    _saudio_stream_t* s = _saudio_streams_lookup(&_saudio.streams, stream.id);
+    if (s) {
+        _saudio_atomic_store(&s->gain, _saudio_float_bits(gain));
+    }
+}
+
+SOKOL_API_IMPL int saudio_stream_expect(saudio_stream stream) {
+    _saudio_stream_t* s = _saudio_streams_lookup(&_saudio.streams, stream.id);
+    if (s && !s->stream_cb) {
+        return _saudio_fifo_writable_bytes(&s->fifo) / _saudio.push_bytes_per_frame;
     }
     else {
         return 0;
     }
 }
 
+SOKOL_API_IMPL int saudio_stream_push_samples(saudio_stream stream, const void* samples, int num_frames) {
+    SOKOL_ASSERT(samples && (num_frames > 0));
+    _saudio_stream_t* s = _saudio_streams_lookup(&_saudio.streams, stream.id);
+    if (s && !s->stream_cb) {
+        const int num_bytes = num_frames * _saudio.push_bytes_per_frame;
+        const int num_written = _saudio_fifo_write(&s->fifo, (const uint8_t*)samples, num_bytes);
+        return num_written / _saudio.push_bytes_per_frame;
+    }
+    else {
+        return 0;
+    }
+}
+
+SOKOL_API_IMPL int saudio_stream_push(saudio_stream stream, const float* frames, int num_frames) {
+    /* use saudio_stream_push_samples() for other sample formats */
+    SOKOL_ASSERT(_saudio.sample_format == SAUDIO_SAMPLEFORMAT_FLOAT32);
+    return saudio_stream_push_samples(stream, frames, num_frames);
+}
+
+SOKOL_API_IMPL saudio_stream_stats saudio_query_stream_stats(saudio_stream stream) {
+    saudio_stream_stats stats;
+    memset(&stats, 0, sizeof(stats));
+    _saudio_stream_t* s = _saudio_streams_lookup(&_saudio.streams, stream.id);
+    if (s) {
+        memcpy(stats.name, s->name, sizeof(stats.name));
+        stats.num_fills = _saudio_atomic_load(&s->stats.num_fills);
+        stats.num_silence_buffers = _saudio_atomic_load(&s->stats.num_silence_buffers);
+        stats.fill_avg_ms = (float) _saudio_atomic_load(&s->stats.fill_avg_ns) / 1000000.0f;
+        stats.fill_max_ms = (float) _saudio_atomic_load(&s->stats.fill_max_ns) / 1000000.0f;
+        const uint32_t num_frames = _saudio_atomic_load(&s->stats.last_num_frames);
+        /* the streams are mixed at the source sample rate */
+        const int sample_rate = (_saudio.source_sample_rate > 0) ? _saudio.source_sample_rate : _saudio.sample_rate;
+        if ((num_frames > 0) && (sample_rate > 0)) {
+            const float buffer_ms = ((float)num_frames * 1000.0f) / (float)sample_rate;
+            stats.cpu_load = stats.fill_avg_ms / buffer_ms;
+        }
+    }
+    return stats;
+}
+
 #undef _saudio_def
 #undef _saudio_def_flt
 
@@ -23,6 +23,8 @@
                                   will be copied into an 8-byte aligned memory region associated
                                   with each in-flight request, default value is 16 (== 128 bytes)
     SFETCH_MAX_CHANNELS         - max number of IO channels (default is 16, also see sfetch_desc_t.num_channels)
+    SFETCH_MAX_READ_AHEAD       - max number of chunks a streaming request can read ahead (default is 4,
+                                  also see sfetch_request_t.read_ahead)
 
     If sokol_fetch.h is compiled as a DLL, define the following before
     including the declaration or implementation:
@@ -54,7 +56,8 @@
       "context" can live on any thread, and multiple contexts
       can operate side-by-side on different threads.
 
-    - Memory management for data buffers is under full control of user code.
+    - Memory management for data buffers is under full control of user code,
+      or optionally handled by a built-in pool of size-classed buffers.
       sokol_fetch.h won't allocate memory after it has been setup.
 
     - Automatic rate-limiting guarantees that only a maximum number of
@@ -157,6 +160,28 @@
             (search below for CHANNELS AND LANES for more details). The
             default number of lanes is 1.
 
+        - buffer_pool (sfetch_buffer_class_t[SFETCH_MAX_BUFFER_CLASSES]):
+            An optional set of buffer size classes (each with a buffer size
+            and a number of buffers) for the built-in buffer pool. Search
+            below for BUFFER POOL for details. By default, no buffer pool
+            is created.
+
+        - work_sharing (bool):
+            If true, IO threads which have nothing to do will help out
+            with requests waiting on other channels (search below
+            for WORK SHARING). The default is false.
+
+        - file_backend (sfetch_file_backend_t):
+            Optional callbacks which replace the platform's file functions
+            on the IO threads (search below for FILE BACKEND). By default
+            the platform's native file functions are used.
+
+        - access_log_size (uint32_t):
+            The max number of entries in the access log, which records
+            the files that have been loaded (search below for ACCESS LOG
+            AND PRELOADING). The default is 0, which disables the access
+            log.
+
     For example, to setup sokol-fetch for max 1024 active requests, 4 channels,
     and 8 lanes per channel in C99:
 
@@ -234,6 +259,20 @@
             important information how streaming works if the web server
             is serving compressed data.
 
+        - min_chunk_size, max_chunk_size, chunk_latency_ms (uint32_t, optional)
+            If max_chunk_size is not zero, the request is streamed with
+            an adaptive chunk size between min_chunk_size and max_chunk_size,
+            chunk_size is only used for the first chunk (the default is
+            min_chunk_size). Search below for ADAPTIVE CHUNK SIZE for
+            details.
+
+        - read_ahead (uint32_t, optional)
+            The number of chunks a streaming request reads ahead into
+            internal buffers while the response callback processes earlier
+            chunks. The read-ahead buffers are taken from the buffer pool, and
+            the number of chunks is clamped to the SFETCH_MAX_READ_AHEAD config
+            define (default: 4). Search below for READ-AHEAD for details.
+
         - buffer_ptr, buffer_size (void*, uint64_t, optional)
             This is a optional pointer/size pair describing a chunk of memory where
             data will be loaded into (if no buffer is provided upfront, this
@@ -242,6 +281,12 @@
             is zero), or the *uncompressed* data for one downloaded chunk
             (if chunk_size is > 0).
 
+            If only a buffer_size but no buffer_ptr is provided, a buffer
+            of at least that size will be taken from the built-in buffer pool
+            when the request is dispatched (search below for BUFFER POOL).
+            Without a buffer pool, the buffer_size is ignored in that case,
+            and the buffer must be bound in the response callback.
+
         - user_data_ptr, user_data_size (const void*, uint32_t, both optional)
             user_data_ptr and user_data_size describe an optional POD (plain-old-data)
             associated with the request which will be copied(!) into an internal
@@ -256,6 +301,25 @@
     within the thread the handle was created on, and all function calls
     involving a request handle must happen on that same thread.
 
+    int sfetch_send_batch(const sfetch_request_t* requests, int num_requests, sfetch_handle_t* out_handles)
+    -------------------------------------------------------------------------------------------------------
+    Sends an array of requests at once, this is cheaper than calling
+    sfetch_send() for each request when thousands of requests need to be
+    sent (for instance when loading a level). The function returns
+    the number of requests that have been sent successfully. If out_handles
+    is not null, it must point to an array of num_requests handles
+    which will be filled with the request handles (an invalid handle
+    for each request that couldn't be sent).
+
+    The requests are processed in groups of up to 256: all requests of a
+    group are validated first, then the request items for the accepted
+    requests are taken from the pool in one go, and each channel's
+    request queue is updated only once per group. All requests in a
+    batch have the same 'sent' timestamp.
+
+    Note that IO threads are only woken up once per channel in the
+    next call to sfetch_dowork(), no matter how many requests have been sent.
+
     bool sfetch_handle_valid(sfetch_handle_t request)
     -------------------------------------------------
     This checks if the provided request handle is valid, and is associated with
@@ -349,6 +413,10 @@
     a pointer to the previous buffer (useful if the buffer was dynamically
     allocated and it must be freed).
 
+    If the buffer is owned by the built-in buffer pool, it will be returned
+    to the pool, and the returned pointer is only valid until the response
+    callback returns (don't free it!).
+
     sfetch_unbind_buffer() *must* be called from inside the response callback.
 
     The usual code sequence to bind a different buffer in the response
@@ -391,6 +459,58 @@
     -------------------------
     Returns the value of the SFETCH_MAX_PATH config define.
 
+    sfetch_channel_stats_t sfetch_query_stats(uint32_t channel)
+    -----------------------------------------------------------
+    Returns aggregated statistics of an IO channel which are useful for
+    tuning the number of channels and lanes:
+
+        - queue_depth, max_queue_depth: the current and maximum number of
+          requests waiting for a free lane on the channel
+        - num_inflight: the number of currently occupied lanes
+        - num_dispatched, num_finished, num_failed: the number of requests
+          that have been dispatched to a lane, have finished, or have failed
+          (or have been cancelled)
+        - queue_time: the accumulated time in nanoseconds requests were waiting
+          for a free lane (divide by num_dispatched for the average)
+        - io_time: the accumulated time in nanoseconds spent in IO operations
+        - bytes_fetched: the overall number of bytes fetched on the channel
+        - bytes_per_sec: the average throughput since sfetch_setup()
+        - io_bytes_per_sec: a moving average of the throughput of the most
+          recent IO operations
+        - latency_histogram: the distribution of the time between
+          sfetch_send() and the last response callback of a request, bucket
+          0 counts requests which took less than 1 millisecond, bucket
+          i counts requests which took less than 2^i milliseconds (and
+          at least 2^(i-1) milliseconds), the last bucket also counts all
+          requests which took longer
+
+    Additionally, the response callback gets per-request timestamps in
+    response->timings (all in nanoseconds since sfetch_setup()):
+
+        - sent: when sfetch_send() was called
+        - dispatched: when the request was assigned a lane
+        - io_start, io_end: the start and end of the IO operation for the
+          current chunk (or the entire file)
+        - callback: when the current response callback was invoked
+
+    NOTE: on POSIX platforms the timer needs CLOCK_MONOTONIC, which is
+    missing when compiling in strict ANSI mode without _POSIX_C_SOURCE,
+    in that case all timestamps and durations will be reported as 1.
+
+    int sfetch_query_access_log(sfetch_access_log_entry_t* out_entries, int max_entries)
+    ------------------------------------------------------------------------------------
+    Copies up to max_entries entries of the access log into out_entries
+    (oldest entries first) and returns the number of copied entries. The
+    path pointers in the copied entries point into sokol-fetch's internal
+    access log, and are only valid until the next call to sfetch_dowork().
+
+    int sfetch_preload(uint32_t channel, sfetch_access_log_entry_t* entries, int num_entries)
+    ----------------------------------------------------------------------------------------
+    Sorts and merges a list of file ranges in place, and sends one
+    preload request for each merged range on the given channel. Returns
+    the number of preload requests that have been sent. Search below
+    for ACCESS LOG AND PRELOADING for details.
+
 
     REQUEST STATES AND THE RESPONSE CALLBACK
     ========================================
@@ -616,6 +736,32 @@
     the request will fail with error code SFETCH_ERROR_BUFFER_TOO_SMALL.
 
 
+    ADAPTIVE CHUNK SIZE
+    ===================
+    With a fixed chunk size, a streaming request either wastes response
+    callbacks on tiny chunks when the data source is fast, or stalls
+    on big chunks when the data source is slow. When a request is sent
+    with a max_chunk_size, sokol-fetch will pick the size of each chunk
+    from the channel's recently measured IO throughput (see
+    sfetch_channel_stats_t.io_bytes_per_sec), so that loading a chunk takes
+    roughly chunk_latency_ms milliseconds (16 by default):
+
+        sfetch_send(&(sfetch_request_t){
+            .path = "music.ogg",
+            .callback = response_callback,
+            .buffer_size = 256 * 1024,
+            .min_chunk_size = 16 * 1024,
+            .max_chunk_size = 256 * 1024,
+            .chunk_latency_ms = 10
+        });
+
+    The chunk size is clamped between min_chunk_size and max_chunk_size
+    (and the buffer size), and rounded down to a multiple of 4 KBytes.
+    The provided buffer must be big enough to hold max_chunk_size bytes.
+    The chunk size that was used to fetch the current chunk is available
+    in the response callback as response->chunk_size.
+
+
     CHANNELS AND LANES
     ==================
     Channels and lanes are (somewhat artificial) concepts to manage
@@ -642,7 +788,7 @@
     cannot be changed afterwards.
 
     Channels are completely separate from each other, and a request will
-    never "hop" from one channel to another.
+    never "hop" from one channel to another (but see WORK SHARING below).
 
     Each channel consists of a fixed number of "lanes" for automatic rate
     limiting:
@@ -679,6 +825,169 @@
         }
 
 
+    BUFFER POOL
+    ===========
+    Instead of providing buffers upfront or binding them in the response
+    callback, sokol-fetch can manage buffers in a built-in buffer pool. The
+    pool is configured in sfetch_setup() as up to SFETCH_MAX_BUFFER_CLASSES
+    'size classes', each with a buffer size and number of buffers. All
+    memory for the buffer pool is allocated in sfetch_setup():
+
+        sfetch_setup(&(sfetch_desc_t){
+            .num_channels = 2,
+            .num_lanes = 4,
+            .buffer_pool = {
+                [0] = { .size = 64 * 1024, .count = 8 },
+                [1] = { .size = 1024 * 1024, .count = 2 }
+            }
+        });
+
+    A request makes use of the buffer pool by providing a buffer_size,
+    but no buffer_ptr:
+
+        sfetch_send(&(sfetch_request_t){
+            .path = "my_file.txt",
+            .callback = response_callback,
+            .buffer_size = 16 * 1024
+        });
+
+    When the request is dispatched, a free buffer from the smallest size
+    class that fits is bound to the request (if that size class is
+    exhausted, bigger size classes are tried). If no matching buffer is
+    available, the request will wait in its channel until a buffer is
+    returned to the pool, this bounds memory usage in the same way as lanes
+    bound the number of requests in flight. A waiting request doesn't
+    block the requests which were sent after it into the same channel,
+    those will be dispatched to free lanes if they don't need a pooled
+    buffer (or a buffer of a different size class is available), and
+    cancelled requests never wait for a buffer. sfetch_send() fails if no size
+    class is big enough for the requested buffer_size.
+
+    Pooled buffers are owned by sokol-fetch (response->buffer_pooled will
+    be true), and are automatically returned to the pool after the response
+    callback has been called with response->finished. Calling
+    sfetch_unbind_buffer() on a pooled buffer also returns the buffer
+    to the pool immediately.
+
+    NOTE that the data in a pooled buffer must be consumed (or copied
+    somewhere else) in the response callback.
+
+    Pooled buffers are aligned to 4 KBytes.
+
+
+    LOADING DATA INTO SOKOL-GFX RESOURCES
+    =====================================
+    sokol-fetch doesn't know about sokol_gfx.h, and sokol_gfx.h doesn't
+    expose mapped staging memory (all resource data is passed by pointer
+    and copied by the 3D backend API), so a file can't be loaded straight
+    into GPU-visible memory. The one copy which can be avoided is the copy
+    from a load buffer into a separate 'resource data' buffer: if the file
+    content can be used as-is (for instance raw or GPU-compressed pixel
+    data without a container format, or vertex and index data), create the
+    resource directly from the fetched data inside the response callback:
+
+        void response_callback(const sfetch_response_t* response) {
+            if (response->fetched) {
+                sg_image img = *(sg_image*)response->user_data;
+                sg_init_image(img, &(sg_image_desc){
+                    .width = 1024,
+                    .height = 1024,
+                    .pixel_format = SG_PIXELFORMAT_BC1_RGBA,
+                    .content.subimage[0][0] = {
+                        .ptr = response->buffer_ptr,
+                        .size = (int) response->fetched_size,
+                    }
+                });
+            }
+        }
+
+    This works with pooled buffers too, since the data only needs to stay
+    valid until sg_init_image() (or sg_make_image(), sg_make_buffer())
+    has returned. Texture data in a container format can be fetched into
+    a pooled buffer and decoded in the response callback, so that the
+    only other copy is the one into the decoded image data.
+
+
+    READ-AHEAD
+    ==========
+    Without read-ahead, a streaming request reads exactly one chunk, then
+    waits for the response callback to be called on the user thread, and
+    only reads the next chunk after the request has been fed back into
+    the IO thread, so the disk sits idle during each roundtrip.
+
+    When a streaming request is sent with a non-zero read_ahead, the
+    request's IO thread uses its idle time to read up to read_ahead chunks
+    ahead into a small ring of internal buffers. When the request comes
+    back for the next chunk, and that chunk has already been read ahead,
+    it is simply copied into the request's buffer:
+
+        sfetch_send(&(sfetch_request_t){
+            .path = "movie.mpg",
+            .callback = response_callback,
+            .buffer_size = 64 * 1024,
+            .chunk_size = 64 * 1024,
+            .read_ahead = 4
+        });
+
+    The read-ahead buffers are taken from the buffer pool (search above
+    for BUFFER POOL) when the request is dispatched, and returned to the
+    pool when the request is finished or paused (a paused request takes
+    new read-ahead buffers when it is continued, and chunks which have
+    already been read ahead are read again). The buffers must be big enough
+    to hold chunk_size (or max_chunk_size) bytes. Since read-ahead is only
+    an optimization, it never takes more than half of the buffers of a size
+    class, so that other requests using the buffer pool can't be starved by
+    streaming requests, reading ahead is skipped (or uses fewer buffers)
+    if not enough buffers are available. Without a buffer pool, read_ahead
+    is ignored (with a log message in sfetch_send()).
+
+    Read-ahead is only supported on platforms with threads (so not
+    on the web platform, where it is silently ignored).
+
+
+    DIRECT IO
+    =========
+    Streaming very big files through the operating system's file cache
+    evicts cached data which other requests (or other processes) depend on,
+    even though each streamed chunk is only read once. Requests with the
+    direct_io flag bypass the file cache where possible:
+
+        sfetch_send(&(sfetch_request_t){
+            .path = "movie.mpg",
+            .callback = response_callback,
+            .buffer_size = 256 * 1024,
+            .chunk_size = 256 * 1024,
+            .direct_io = true
+        });
+
+    - on Linux, the file is opened with O_DIRECT (which needs _GNU_SOURCE
+      to be defined before any system headers are included), on file
+      systems without O_DIRECT support the read data is dropped from the
+      file cache with posix_fadvise(POSIX_FADV_DONTNEED) instead
+    - on macOS and iOS, caching is disabled with fcntl(F_NOCACHE)
+    - on Windows, the file is opened with FILE_FLAG_NO_BUFFERING
+
+    Unbuffered reads require that the buffer address, the file offset and
+    the number of bytes to read are aligned to the storage block size.
+    Pooled buffers (search above for BUFFER POOL) are always aligned to
+    4 KBytes, and if the chunk_size (or min_chunk_size and max_chunk_size)
+    is a multiple of 4 KBytes, all reads except the final chunk at the
+    end of the file will be aligned. Reads which are not aligned don't fail,
+    direct IO is an optimization hint, never an error:
+
+    - on Linux, an unaligned number of bytes to read (usually the final
+      chunk) is handled by reading the last block through an aligned
+      bounce buffer, if the file offset or buffer address isn't aligned,
+      this one read is done with regular buffered IO (and the read data
+      is dropped from the file cache afterward), following reads of
+      the same request still use O_DIRECT
+    - on Windows, unaligned reads are done through a temporary buffered
+      file handle
+
+    The direct_io flag is ignored with a custom file backend (search
+    below for FILE BACKEND) and on the web platform.
+
+
     NOTES ON OPTIMIZING PIPELINE LATENCY AND THROUGHPUT
     ===================================================
     With the default configuration of 1 channel and 1 lane per channel,
@@ -782,6 +1091,129 @@
     the blocking traditional file IO functions, not for performance reasons.
 
 
+    WORK SHARING
+    ============
+    By default, a channel's requests are only processed by the channel's
+    own IO thread. If one channel is busy loading big files, the IO threads
+    of other channels sit idle even though the waiting requests could be
+    processed in parallel.
+
+    With sfetch_desc_t.work_sharing enabled, an IO thread which has
+    nothing to do will take requests from the incoming queues of other
+    channels. When requests are waiting in a channel, sfetch_dowork() wakes
+    up at most one idle IO thread of another channel, which then keeps
+    taking requests from other channels until there's nothing left to do. Channels still work as scheduling and prioritization domains
+    (requests are still assigned to a channel, occupy one of its lanes, and
+    the response callback is invoked as part of that channel), only the
+    actual IO work may happen on another channel's thread.
+
+    Streaming requests with read-ahead are never taken over by other
+    threads, since the read-ahead state is owned by the channel's thread.
+
+    Work sharing has no effect on the web platform.
+
+
+    ACCESS LOG AND PRELOADING
+    =========================
+    Files are usually requested in the order in which the application
+    code needs them, which leads to a mostly random IO pattern during
+    startup. With a non-zero sfetch_desc_t.access_log_size, sokol-fetch
+    records which file ranges have been loaded (the path, the offset and
+    size of the fetched data, and when the request was sent) in a ring
+    buffer of access_log_size entries (if the access log is full, the
+    oldest entries are overwritten):
+
+        sfetch_setup(&(sfetch_desc_t){
+            .num_channels = 2,
+            .access_log_size = 1024
+        });
+
+    At a suitable time (for instance when startup has finished), the access
+    log can be copied with sfetch_query_access_log() and stored somewhere
+    (sokol-fetch itself doesn't write files):
+
+        sfetch_access_log_entry_t entries[1024];
+        int num_entries = sfetch_query_access_log(entries, 1024);
+        for (int i = 0; i < num_entries; i++) {
+            // serialize entries[i].path, .offset, .size, .time...
+        }
+
+    On the next run, the stored list is passed to sfetch_preload() as early
+    as possible, ideally on a separate channel so that preloading doesn't
+    delay regular requests:
+
+        int num_preloads = sfetch_preload(1, entries, num_entries);
+
+    sfetch_preload() sorts the entries in place by path and offset (files
+    in the same directory, and ranges in the same pack file, end up next
+    to each other), merges overlapping ranges in the same file, and sends
+    one preload request for each merged range. A zero size means 'the
+    entire file'. The path strings must only be valid during the call.
+
+    Preload requests don't have a response callback and don't load data
+    into a buffer, instead they ask the operating system to read the file
+    range into the file cache in the background (posix_fadvise() with
+    POSIX_FADV_WILLNEED on Linux, fcntl() with F_RDADVISE on macOS and
+    iOS), or on other platforms and with a custom file backend (search
+    below for FILE BACKEND) read the range in small pieces and discard
+    the data. Preload requests occupy lanes and request pool items like
+    regular requests, if the request pool is exhausted, sfetch_preload()
+    stops and returns the number of preload requests sent so far.
+
+    Preload requests are not recorded in the access log. Preloading
+    has no effect on the web platform.
+
+
+    FILE BACKEND
+    ============
+    On native platforms, the IO threads access the filesystem through four
+    functions: open, size, read and close. These can be replaced with
+    user-provided callbacks in sfetch_desc_t.file_backend, for instance
+    to load data from a custom archive format, or to simulate slow storage
+    when testing and benchmarking how an application behaves under high
+    IO latency or limited bandwidth:
+
+        static void* slow_open(const char* path, void* user_data) {
+            return fopen(path, "rb");
+        }
+        static void slow_close(void* file, void* user_data) {
+            fclose((FILE*)file);
+        }
+        static uint32_t slow_size(void* file, void* user_data) {
+            fseek((FILE*)file, 0, SEEK_END);
+            return (uint32_t) ftell((FILE*)file);
+        }
+        static bool slow_read(void* file, uint32_t offset, uint32_t num_bytes, void* ptr, void* user_data) {
+            // 5ms latency per read plus 50 MB/s bandwidth
+            usleep(5000 + num_bytes / 50);
+            fseek((FILE*)file, offset, SEEK_SET);
+            return num_bytes == fread(ptr, 1, num_bytes, (FILE*)file);
+        }
+
+        sfetch_setup(&(sfetch_desc_t){
+            .file_backend = {
+                .open_cb = slow_open,
+                .close_cb = slow_close,
+                .size_cb = slow_size,
+                .read_cb = slow_read
+            }
+        });
+
+    Together with the per-request timings in sfetch_response_t and
+    sfetch_query_stats() this can be used to measure throughput and
+    latency distribution under different storage conditions.
+
+    Either all four callbacks must be provided, or none. The file pointer
+    returned by open_cb is opaque to sokol-fetch, a null pointer means
+    that the file couldn't be opened. Each opened file is only accessed
+    from one IO thread at a time, but different files may be accessed
+    from different IO threads concurrently, so the callbacks must be
+    thread-safe.
+
+    The file backend is not used on the web platform (where data is loaded
+    via HTTP).
+
+
     FUTURE PLANS / V2.0 IDEA DUMP
     =============================
     - An optional polling API (as alternative to callback API)
@@ -843,12 +1275,36 @@
 extern "C" {
 #endif
 
+enum {
+    SFETCH_MAX_BUFFER_CLASSES = 8,
+    SFETCH_NUM_LATENCY_BUCKETS = 16,
+};
+
+/* a size class of the optional built-in buffer pool */
+typedef struct sfetch_buffer_class_t {
+    uint32_t size;                  /* size of each buffer in this class in bytes */
+    uint32_t count;                 /* number of buffers in this class */
+} sfetch_buffer_class_t;
+
+/* optional file IO callbacks, called on the IO threads (see FILE BACKEND) */
+typedef struct sfetch_file_backend_t {
+    void* (*open_cb)(const char* path, void* user_data);       /* return 0 if the file can't be opened */
+    void (*close_cb)(void* file, void* user_data);
+    uint32_t (*size_cb)(void* file, void* user_data);
+    bool (*read_cb)(void* file, uint32_t offset, uint32_t num_bytes, void* ptr, void* user_data);
+    void* user_data;
+} sfetch_file_backend_t;
+
 /* configuration values for sfetch_setup() */
 typedef struct sfetch_desc_t {
     uint32_t _start_canary;
     uint32_t max_requests;          /* max number of active requests across all channels, default is 128 */
     uint32_t num_channels;          /* number of channels to fetch requests in parallel, default is 1 */
     uint32_t num_lanes;             /* max number of requests active on the same channel, default is 1 */
+    sfetch_buffer_class_t buffer_pool[SFETCH_MAX_BUFFER_CLASSES];   /* optional built-in buffer pool (default: no buffer pool) */
+    bool work_sharing;              /* idle IO threads process requests of other channels (default: false) */
+    sfetch_file_backend_t file_backend;     /* optional file IO callbacks (default: the platform's file functions) */
+    uint32_t access_log_size;       /* max number of entries in the access log (default: 0, no access log) */
     uint32_t _end_canary;
 } sfetch_desc_t;
 
@@ -866,6 +1322,15 @@ typedef enum {
     SFETCH_ERROR_CANCELLED
 } sfetch_error_t;
 
+/* per-request timestamps in nanoseconds since sfetch_setup(), zero if not reached yet */
+typedef struct sfetch_timings_t {
+    uint64_t sent;                  /* sfetch_send() was called */
+    uint64_t dispatched;            /* request was assigned a lane on its channel */
+    uint64_t io_start;              /* IO operation for the current chunk has started */
+    uint64_t io_end;                /* IO operation for the current chunk has finished */
+    uint64_t callback;              /* current invocation of the response callback */
+} sfetch_timings_t;
+
 /* the response struct passed to the response callback */
 typedef struct sfetch_response_t {
     sfetch_handle_t handle;         /* request handle this response belongs to */
@@ -882,10 +1347,29 @@ typedef struct sfetch_response_t {
     void* user_data;                /* pointer to read/write user-data area (FIXME: this is unsafe, wrap in API call?) */
     uint32_t fetched_offset;        /* current offset of fetched data chunk in file data */
     uint32_t fetched_size;          /* size of fetched data chunk in number of bytes */
+    uint32_t chunk_size;            /* the chunk size that was used to fetch the data chunk (0 if not streaming) */
     void* buffer_ptr;               /* pointer to buffer with fetched data */
     uint32_t buffer_size;           /* overall buffer size (may be >= than fetched_size!) */
+    bool buffer_pooled;             /* true if buffer_ptr is owned by the built-in buffer pool */
+    sfetch_timings_t timings;       /* timestamps of the request's lifecycle events */
 } sfetch_response_t;
 
+/* aggregated per-channel statistics, returned by sfetch_query_stats() */
+typedef struct sfetch_channel_stats_t {
+    uint32_t queue_depth;           /* current number of requests waiting for a free lane */
+    uint32_t max_queue_depth;       /* max number of requests that were waiting for a free lane */
+    uint32_t num_inflight;          /* current number of occupied lanes */
+    uint64_t num_dispatched;        /* number of requests that have been assigned a lane */
+    uint64_t num_finished;          /* number of finished requests (including failed requests) */
+    uint64_t num_failed;            /* number of failed or cancelled requests */
+    uint64_t queue_time;            /* accumulated time between sfetch_send() and dispatch in nanoseconds */
+    uint64_t io_time;               /* accumulated time spent in IO operations in nanoseconds */
+    uint64_t bytes_fetched;         /* number of bytes fetched */
+    uint64_t bytes_per_sec;         /* average throughput since sfetch_setup() */
+    uint64_t io_bytes_per_sec;      /* moving average of the throughput of recent IO operations */
+    uint32_t latency_histogram[SFETCH_NUM_LATENCY_BUCKETS];    /* sent-to-finished latency, bucket i counts requests < 2^i milliseconds */
+} sfetch_channel_stats_t;
+
 /* response callback function signature */
 typedef void(*sfetch_callback_t)(const sfetch_response_t*);
 
@@ -896,13 +1380,26 @@ typedef struct sfetch_request_t {
     const char* path;               /* filesystem path or HTTP URL (required) */
     sfetch_callback_t callback;     /* response callback function pointer (required) */
     void* buffer_ptr;               /* buffer pointer where data will be loaded into (optional) */
-    uint32_t buffer_size;           /* buffer size in number of bytes (optional) */
+    uint32_t buffer_size;           /* buffer size in number of bytes (optional, without buffer_ptr: size of pooled buffer) */
     uint32_t chunk_size;            /* number of bytes to load per stream-block (optional) */
+    uint32_t min_chunk_size;        /* adaptive streaming: min number of bytes per stream-block (optional) */
+    uint32_t max_chunk_size;        /* adaptive streaming: max number of bytes per stream-block (optional) */
+    uint32_t chunk_latency_ms;      /* adaptive streaming: target IO time per stream-block (default: 16) */
+    uint32_t read_ahead;            /* streaming: number of stream-blocks to read ahead into pooled buffers (optional) */
+    bool direct_io;                 /* bypass the OS file cache (optional, see DIRECT IO) */
     const void* user_data_ptr;      /* pointer to a POD user-data block which will be memcpy'd(!) (optional) */
     uint32_t user_data_size;        /* size of user-data block (optional) */
     uint32_t _end_canary;
 } sfetch_request_t;
 
+/* an entry in the access log, or in a preload list passed to sfetch_preload() */
+typedef struct sfetch_access_log_entry_t {
+    const char* path;
+    uint32_t offset;                /* file offset of the first fetched byte */
+    uint32_t size;                  /* number of fetched bytes */
+    uint64_t time;                  /* when the request was sent, in nanoseconds since sfetch_setup() */
+} sfetch_access_log_entry_t;
+
 /* setup sokol-fetch (can be called on multiple threads) */
 SOKOL_API_DECL void sfetch_setup(const sfetch_desc_t* desc);
 /* discard a sokol-fetch context */
@@ -918,6 +1415,8 @@ SOKOL_API_DECL int sfetch_max_path(void);
 
 /* send a fetch-request, get handle to request back */
 SOKOL_API_DECL sfetch_handle_t sfetch_send(const sfetch_request_t* request);
+/* send an array of fetch-requests, optionally get handles back, returns number of successfully sent requests */
+SOKOL_API_DECL int sfetch_send_batch(const sfetch_request_t* requests, int num_requests, sfetch_handle_t* out_handles);
 /* return true if a handle is valid *and* the request is alive */
 SOKOL_API_DECL bool sfetch_handle_valid(sfetch_handle_t h);
 /* do per-frame work, moves requests into and out of IO threads, and invokes response-callbacks */
@@ -933,6 +1432,12 @@ SOKOL_API_DECL void sfetch_cancel(sfetch_handle_t h);
 SOKOL_API_DECL void sfetch_pause(sfetch_handle_t h);
 /* continue a paused request */
 SOKOL_API_DECL void sfetch_continue(sfetch_handle_t h);
+/* get aggregated statistics of an IO channel */
+SOKOL_API_DECL sfetch_channel_stats_t sfetch_query_stats(uint32_t channel);
+/* copy the recorded access log (oldest entries first), returns number of copied entries */
+SOKOL_API_DECL int sfetch_query_access_log(sfetch_access_log_entry_t* out_entries, int max_entries);
+/* sort and merge a preload list in place, and send preload requests on a channel, returns number of sent preload requests */
+SOKOL_API_DECL int sfetch_preload(uint32_t channel, sfetch_access_log_entry_t* entries, int num_entries);
 
 #ifdef __cplusplus
 } /* extern "C" */
@@ -947,7 +1452,8 @@ inline sfetch_handle_t sfetch_send(const sfetch_request_t& request) { return sfe
 /*--- IMPLEMENTATION ---------------------------------------------------------*/
 #ifdef SOKOL_IMPL
 #define SOKOL_FETCH_IMPL_INCLUDED (1)
-#include <string.h> /* memset, memcpy */
+#include <string.h> /* memset, memcpy, strcmp */
+#include <stdlib.h> /* qsort */
 
 #ifndef SFETCH_MAX_PATH
 #define SFETCH_MAX_PATH (1024)
@@ -958,6 +1464,9 @@ inline sfetch_handle_t sfetch_send(const sfetch_request_t& request) { return sfe
 #ifndef SFETCH_MAX_CHANNELS
 #define SFETCH_MAX_CHANNELS (16)
 #endif
+#ifndef SFETCH_MAX_READ_AHEAD
+#define SFETCH_MAX_READ_AHEAD (4)
+#endif
 
 #ifndef SOKOL_API_IMPL
     #define SOKOL_API_IMPL
@@ -1017,7 +1526,22 @@ inline sfetch_handle_t sfetch_send(const sfetch_request_t& request) { return sfe
     #define _SFETCH_HAS_THREADS (1)
 #else
     #include <pthread.h>
-    #include <stdio.h>  /* fopen, fread, fseek, fclose */
+    #include <fcntl.h>      /* open, fcntl, posix_fadvise */
+    #include <unistd.h>     /* pread, lseek, read, close */
+    #include <sys/stat.h>   /* fstat */
+    #include <errno.h>
+    /* NOTE: pread() is missing in strict ANSI mode without _POSIX_C_SOURCE or _XOPEN_SOURCE */
+    #if defined(__APPLE__) || defined(__ANDROID__) || defined(__FreeBSD__) || defined(_GNU_SOURCE) || defined(_DEFAULT_SOURCE) || \
+        (defined(_POSIX_C_SOURCE) && (_POSIX_C_SOURCE >= 200809L)) || (defined(_XOPEN_SOURCE) && (_XOPEN_SOURCE >= 500))
+    #define _SFETCH_HAS_PREAD (1)
+    #else
+    #define _SFETCH_HAS_PREAD (0)
+    #endif
+    #if defined(__APPLE__)
+    #include <mach/mach_time.h>
+    #else
+    #include <time.h>   /* clock_gettime */
+    #endif
     #define _SFETCH_PLATFORM_POSIX (1)
     #define _SFETCH_PLATFORM_EMSCRIPTEN (0)
     #define _SFETCH_PLATFORM_WINDOWS (0)
@@ -1034,6 +1558,21 @@ typedef struct _sfetch_buffer_t {
     uint32_t size;
 } _sfetch_buffer_t;
 
+/* a monotonic timer, read-only after setup so it can be used from IO threads */
+typedef struct {
+    #if _SFETCH_PLATFORM_WINDOWS
+    LARGE_INTEGER freq;
+    LARGE_INTEGER start;
+    #elif _SFETCH_PLATFORM_EMSCRIPTEN
+    double start;
+    #elif defined(__APPLE__)
+    mach_timebase_info_data_t timebase;
+    uint64_t start;
+    #else
+    uint64_t start;
+    #endif
+} _sfetch_timer_t;
+
 /* a thread with incoming and outgoing message queue syncing */
 #if _SFETCH_PLATFORM_POSIX
 typedef struct {
@@ -1044,6 +1583,8 @@ typedef struct {
     pthread_mutex_t running_mutex;
     pthread_mutex_t stop_mutex;
     bool stop_requested;
+    bool wakeup_requested;
+    bool idle;              /* thread is blocked waiting for incoming items */
     bool valid;
 } _sfetch_thread_t;
 #elif _SFETCH_PLATFORM_WINDOWS
@@ -1055,18 +1596,20 @@ typedef struct {
     CRITICAL_SECTION running_critsec;
     CRITICAL_SECTION stop_critsec;
     bool stop_requested;
+    bool wakeup_requested;
+    bool idle;              /* thread is blocked waiting for incoming items */
     bool valid;
 } _sfetch_thread_t;
 #endif
 
-/* file handle abstraction */
-#if _SFETCH_PLATFORM_POSIX
-typedef FILE* _sfetch_file_handle_t;
+/* file handle abstraction, files are accessed through the
+   file backend callbacks, the native handle type is opaque
+*/
+typedef void* _sfetch_file_handle_t;
 #define _SFETCH_INVALID_FILE_HANDLE (0)
+#if _SFETCH_PLATFORM_POSIX
 typedef void*(*_sfetch_thread_func_t)(void*);
 #elif _SFETCH_PLATFORM_WINDOWS
-typedef HANDLE _sfetch_file_handle_t;
-#define _SFETCH_INVALID_FILE_HANDLE (INVALID_HANDLE_VALUE)
 typedef LPTHREAD_START_ROUTINE _sfetch_thread_func_t;
 #endif
 
@@ -1078,9 +1621,11 @@ typedef struct {
     /* transfer IO => user thread */
     uint32_t fetched_offset;    /* number of bytes fetched so far */
     uint32_t fetched_size;      /* size of last fetched chunk */
+    uint32_t chunk_size;        /* chunk size the last chunk was read with */
     sfetch_error_t error_code;
     bool finished;
     /* user thread only */
+    sfetch_timings_t timings;
     uint32_t user_data_size;
     uint64_t user_data[SFETCH_MAX_USERDATA_UINT64];
 } _sfetch_item_user_t;
@@ -1090,9 +1635,12 @@ typedef struct {
     /* transfer IO => user thread */
     uint32_t fetched_offset;
     uint32_t fetched_size;
+    uint32_t chunk_size;
     sfetch_error_t error_code;
     bool failed;
     bool finished;
+    uint64_t io_start;
+    uint64_t io_end;
     /* IO thread only */
     #if _SFETCH_PLATFORM_EMSCRIPTEN
     uint32_t http_range_offset;
@@ -1121,8 +1669,21 @@ typedef struct {
     uint32_t channel;
     uint32_t lane;
     uint32_t chunk_size;
+    uint32_t min_chunk_size;    /* adaptive chunk size if max_chunk_size != 0 */
+    uint32_t max_chunk_size;
+    uint64_t chunk_latency;     /* target IO time per chunk in nanoseconds */
     sfetch_callback_t callback;
     _sfetch_buffer_t buffer;
+    uint32_t pool_buffer_size;  /* if != 0, a pooled buffer of this size is bound at dispatch */
+    bool buffer_pooled;         /* true if 'buffer' is owned by the buffer pool */
+    uint32_t read_ahead;        /* requested number of read-ahead chunks */
+    bool direct_io;             /* bypass the OS file cache if possible */
+    bool preload;               /* a preload request, only warms up the file cache */
+    uint32_t preload_offset;
+    uint32_t preload_size;      /* 0 means 'to end of file' */
+    uint64_t access_log_pos;    /* 1 + position of the request's access log entry, 0 if none */
+    uint32_t num_read_ahead_bufs;
+    _sfetch_buffer_t read_ahead_bufs[SFETCH_MAX_READ_AHEAD];    /* pooled read-ahead buffers */
 
     /* updated by IO-thread, off-limits to user thread */
     _sfetch_item_thread_t thread;
@@ -1144,6 +1705,28 @@ typedef struct {
     bool valid;
 } _sfetch_pool_t;
 
+/* max number of requests validated and allocated together in sfetch_send_batch() */
+#define _SFETCH_SEND_BATCH_CHUNK (256)
+
+/* a size class of the built-in buffer pool, all buffers live in one memory block */
+#define _SFETCH_BUFFER_ALIGN (4096)
+#define _SFETCH_DIRECT_IO_ALIGN (4096)
+typedef struct {
+    uint32_t size;              /* usable size of each buffer */
+    uint32_t stride;            /* distance between buffers, multiple of _SFETCH_BUFFER_ALIGN */
+    uint32_t count;
+    uint32_t free_top;
+    uint32_t* free_slots;
+    uint8_t* raw;               /* the actual allocation */
+    uint8_t* base;              /* start of the first buffer, aligned to _SFETCH_BUFFER_ALIGN */
+} _sfetch_buffer_class_t;
+
+/* the built-in buffer pool, classes are sorted by ascending size */
+typedef struct {
+    uint32_t num_classes;
+    _sfetch_buffer_class_t classes[SFETCH_MAX_BUFFER_CLASSES];
+} _sfetch_buffer_pool_t;
+
 /* a ringbuffer for pool-slot ids */
 typedef struct {
     uint32_t head;
@@ -1152,6 +1735,27 @@ typedef struct {
     uint32_t* buf;
 } _sfetch_ring_t;
 
+/* IO-thread-side read-ahead state of a streaming request, one per lane,
+   this is only accessed by the channel's IO thread
+*/
+typedef struct {
+    uint32_t slot_id;           /* the request which currently owns the read-ahead state, 0 if unused */
+    _sfetch_file_handle_t file_handle;
+    bool direct_io;
+    uint32_t content_size;
+    uint32_t read_offset;       /* file offset of the next chunk to read ahead */
+    uint32_t chunk_size;
+    bool failed;                /* reading ahead has failed, fall back to regular reads */
+    uint32_t num_bufs;
+    uint32_t head;              /* next ring buffer to read into */
+    uint32_t count;             /* number of chunks that have been read ahead */
+    _sfetch_buffer_t bufs[SFETCH_MAX_READ_AHEAD];
+    uint32_t sizes[SFETCH_MAX_READ_AHEAD];
+    uint32_t chunk_sizes[SFETCH_MAX_READ_AHEAD];  /* chunk size each chunk was read ahead with */
+    uint64_t io_start[SFETCH_MAX_READ_AHEAD];
+    uint64_t io_end[SFETCH_MAX_READ_AHEAD];
+} _sfetch_read_ahead_t;
+
 /* an IO channel with its own IO thread */
 struct _sfetch_t;
 typedef struct {
@@ -1165,18 +1769,39 @@ typedef struct {
     _sfetch_ring_t thread_incoming;
     _sfetch_ring_t thread_outgoing;
     _sfetch_thread_t thread;
+    uint32_t num_lanes;
+    _sfetch_read_ahead_t* read_ahead;   /* one per lane, IO thread only */
     #endif
     void (*request_handler)(struct _sfetch_t* ctx, uint32_t slot_id);
+    sfetch_channel_stats_t stats;   /* user thread only */
     bool valid;
 } _sfetch_channel_t;
 
+/* the access log, a ring buffer which overwrites the oldest entries */
+typedef struct {
+    _sfetch_path_t path;
+    uint32_t offset;
+    uint32_t size;
+    uint64_t time;
+} _sfetch_access_log_entry_t;
+
+typedef struct {
+    uint32_t size;
+    uint64_t num_recorded;      /* overall number of recorded entries */
+    _sfetch_access_log_entry_t* entries;
+} _sfetch_access_log_t;
+
 /* the sfetch global state */
 typedef struct _sfetch_t {
     bool setup;
     bool valid;
     bool in_callback;
     sfetch_desc_t desc;
+    _sfetch_timer_t timer;
     _sfetch_pool_t pool;
+    _sfetch_buffer_pool_t buffers;
+    sfetch_file_backend_t file_backend;
+    _sfetch_access_log_t access_log;
     _sfetch_channel_t chn[SFETCH_MAX_CHANNELS];
 } _sfetch_t;
 #if _SFETCH_HAS_THREADS
@@ -1196,27 +1821,18 @@ _SOKOL_PRIVATE _sfetch_t* _sfetch_ctx(void) {
     return _sfetch;
 }
 
+/* NOTE: only copies the string including the 0-terminator, not the entire buffer */
 _SOKOL_PRIVATE void _sfetch_path_copy(_sfetch_path_t* dst, const char* src) {
     SOKOL_ASSERT(dst);
-    if (src && (strlen(src) < SFETCH_MAX_PATH)) {
-        #if defined(_MSC_VER)
-        strncpy_s(dst->buf, SFETCH_MAX_PATH, src, (SFETCH_MAX_PATH-1));
-        #else
-        strncpy(dst->buf, src, SFETCH_MAX_PATH);
-        #endif
-        dst->buf[SFETCH_MAX_PATH-1] = 0;
+    const size_t len = src ? strlen(src) : SFETCH_MAX_PATH;
+    if (len < SFETCH_MAX_PATH) {
+        memcpy(dst->buf, src, len + 1);
     }
     else {
         memset(dst->buf, 0, SFETCH_MAX_PATH);
     }
 }
 
-_SOKOL_PRIVATE _sfetch_path_t _sfetch_path_make(const char* str) {
-    _sfetch_path_t res;
-    _sfetch_path_copy(&res, str);
-    return res;
-}
-
 _SOKOL_PRIVATE uint32_t _sfetch_make_id(uint32_t index, uint32_t gen_ctr) {
     return (gen_ctr<<16) | (index & 0xFFFF);
 }
@@ -1231,6 +1847,60 @@ _SOKOL_PRIVATE uint32_t _sfetch_slot_index(uint32_t slot_id) {
     return slot_id & 0xFFFF;
 }
 
+/*=== timer functions ========================================================*/
+#if _SFETCH_PLATFORM_WINDOWS || defined(__APPLE__)
+/* prevent 64-bit overflow when computing relative timestamp (same as in sokol_time.h) */
+_SOKOL_PRIVATE int64_t _sfetch_int64_muldiv(int64_t value, int64_t numer, int64_t denom) {
+    int64_t q = value / denom;
+    int64_t r = value % denom;
+    return q * numer + r * numer / denom;
+}
+#endif
+
+_SOKOL_PRIVATE void _sfetch_timer_init(_sfetch_timer_t* timer) {
+    SOKOL_ASSERT(timer);
+    #if _SFETCH_PLATFORM_WINDOWS
+        QueryPerformanceFrequency(&timer->freq);
+        QueryPerformanceCounter(&timer->start);
+    #elif _SFETCH_PLATFORM_EMSCRIPTEN
+        timer->start = emscripten_get_now();
+    #elif defined(__APPLE__)
+        mach_timebase_info(&timer->timebase);
+        timer->start = mach_absolute_time();
+    #elif defined(CLOCK_MONOTONIC)
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        timer->start = (uint64_t)ts.tv_sec*1000000000 + (uint64_t)ts.tv_nsec;
+    #else
+        timer->start = 0;
+    #endif
+}
+
+/* return nanoseconds since _sfetch_timer_init(), never returns zero */
+_SOKOL_PRIVATE uint64_t _sfetch_timer_now(const _sfetch_timer_t* timer) {
+    SOKOL_ASSERT(timer);
+    uint64_t now;
+    #if _SFETCH_PLATFORM_WINDOWS
+        LARGE_INTEGER qpc_t;
+        QueryPerformanceCounter(&qpc_t);
+        now = (uint64_t) _sfetch_int64_muldiv(qpc_t.QuadPart - timer->start.QuadPart, 1000000000, timer->freq.QuadPart);
+    #elif _SFETCH_PLATFORM_EMSCRIPTEN
+        now = (uint64_t) ((emscripten_get_now() - timer->start) * 1000000.0);
+    #elif defined(__APPLE__)
+        const uint64_t mach_now = mach_absolute_time() - timer->start;
+        now = (uint64_t) _sfetch_int64_muldiv((int64_t)mach_now, timer->timebase.numer, timer->timebase.denom);
+    #elif defined(CLOCK_MONOTONIC)
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        now = ((uint64_t)ts.tv_sec*1000000000 + (uint64_t)ts.tv_nsec) - timer->start;
+    #else
+        /* NOTE: CLOCK_MONOTONIC is missing in strict ANSI mode without _POSIX_C_SOURCE */
+        (void)timer;
+        now = 0;
+    #endif
+    return (now > 0) ? now : 1;
+}
+
 /*=== a circular message queue ===============================================*/
 _SOKOL_PRIVATE uint32_t _sfetch_ring_wrap(const _sfetch_ring_t* rb, uint32_t i) {
     return i % rb->num;
@@ -1314,6 +1984,23 @@ _SOKOL_PRIVATE uint32_t _sfetch_ring_peek(const _sfetch_ring_t* rb, uint32_t ind
     return rb->buf[rb_index];
 }
 
+_SOKOL_PRIVATE uint32_t _sfetch_ring_num_free(const _sfetch_ring_t* rb) {
+    return (rb->num - 1) - _sfetch_ring_count(rb);
+}
+
+/* enqueue an array of slot ids with (at most) two memcpy's */
+_SOKOL_PRIVATE void _sfetch_ring_enqueue_n(_sfetch_ring_t* rb, const uint32_t* slot_ids, uint32_t num) {
+    SOKOL_ASSERT(rb && rb->buf && slot_ids);
+    SOKOL_ASSERT(num <= _sfetch_ring_num_free(rb));
+    const uint32_t num_to_end = rb->num - rb->head;
+    const uint32_t num_first = (num < num_to_end) ? num : num_to_end;
+    memcpy(&rb->buf[rb->head], slot_ids, num_first * sizeof(uint32_t));
+    if (num > num_first) {
+        memcpy(rb->buf, &slot_ids[num_first], (num - num_first) * sizeof(uint32_t));
+    }
+    rb->head = _sfetch_ring_wrap(rb, rb->head + num);
+}
+
 /*=== request pool implementation ============================================*/
 _SOKOL_PRIVATE void _sfetch_item_init(_sfetch_item_t* item, uint32_t slot_id, const sfetch_request_t* request) {
     SOKOL_ASSERT(item && (0 == item->handle.id));
@@ -1323,11 +2010,26 @@ _SOKOL_PRIVATE void _sfetch_item_init(_sfetch_item_t* item, uint32_t slot_id, co
     item->state = _SFETCH_STATE_INITIAL;
     item->channel = request->channel;
     item->chunk_size = request->chunk_size;
+    item->direct_io = request->direct_io;
+    item->read_ahead = (request->read_ahead < SFETCH_MAX_READ_AHEAD) ? request->read_ahead : SFETCH_MAX_READ_AHEAD;
+    if (request->max_chunk_size > 0) {
+        item->min_chunk_size = request->min_chunk_size;
+        item->max_chunk_size = request->max_chunk_size;
+        item->chunk_latency = (uint64_t)_sfetch_def(request->chunk_latency_ms, 16) * 1000000;
+        if (0 == item->chunk_size) {
+            item->chunk_size = item->min_chunk_size;
+        }
+    }
     item->lane = _SFETCH_INVALID_LANE;
     item->callback = request->callback;
-    item->buffer.ptr = (uint8_t*) request->buffer_ptr;
-    item->buffer.size = request->buffer_size;
-    item->path = _sfetch_path_make(request->path);
+    if (request->buffer_ptr) {
+        item->buffer.ptr = (uint8_t*) request->buffer_ptr;
+        item->buffer.size = request->buffer_size;
+    }
+    else {
+        item->pool_buffer_size = request->buffer_size;
+    }
+    _sfetch_path_copy(&item->path, request->path);
     #if !_SFETCH_PLATFORM_EMSCRIPTEN
     item->thread.file_handle = _SFETCH_INVALID_FILE_HANDLE;
     #endif
@@ -1395,15 +2097,31 @@ _SOKOL_PRIVATE bool _sfetch_pool_init(_sfetch_pool_t* pool, uint32_t num_items)
     return pool->valid;
 }
 
+/* initialize the item in a slot taken from the free-slots stack, returns the new slot id */
+_SOKOL_PRIVATE uint32_t _sfetch_pool_item_init_at(_sfetch_pool_t* pool, uint32_t slot_index, const sfetch_request_t* request) {
+    SOKOL_ASSERT(pool && pool->valid);
+    SOKOL_ASSERT((slot_index > 0) && (slot_index < pool->size));
+    uint32_t slot_id = _sfetch_make_id(slot_index, ++pool->gen_ctrs[slot_index]);
+    _sfetch_item_init(&pool->items[slot_index], slot_id, request);
+    pool->items[slot_index].state = _SFETCH_STATE_ALLOCATED;
+    return slot_id;
+}
+
+/* pop num slot indices from the free-slots stack in one go, the caller must
+   check that enough slots are free, and initialize the items with
+   _sfetch_pool_item_init_at()
+*/
+_SOKOL_PRIVATE void _sfetch_pool_reserve(_sfetch_pool_t* pool, uint32_t num, uint32_t* out_slot_indices) {
+    SOKOL_ASSERT(pool && pool->valid && out_slot_indices);
+    SOKOL_ASSERT(num <= pool->free_top);
+    pool->free_top -= num;
+    memcpy(out_slot_indices, &pool->free_slots[pool->free_top], num * sizeof(uint32_t));
+}
+
 _SOKOL_PRIVATE uint32_t _sfetch_pool_item_alloc(_sfetch_pool_t* pool, const sfetch_request_t* request) {
     SOKOL_ASSERT(pool && pool->valid);
     if (pool->free_top > 0) {
-        uint32_t slot_index = pool->free_slots[--pool->free_top];
-        SOKOL_ASSERT((slot_index > 0) && (slot_index < pool->size));
-        uint32_t slot_id = _sfetch_make_id(slot_index, ++pool->gen_ctrs[slot_index]);
-        _sfetch_item_init(&pool->items[slot_index], slot_id, request);
-        pool->items[slot_index].state = _SFETCH_STATE_ALLOCATED;
-        return slot_id;
+        return _sfetch_pool_item_init_at(pool, pool->free_slots[--pool->free_top], request);
     }
     else {
         /* pool exhausted, return the 'invalid handle' */
@@ -1447,130 +2165,577 @@ _SOKOL_PRIVATE _sfetch_item_t* _sfetch_pool_item_lookup(_sfetch_pool_t* pool, ui
     return 0;
 }
 
-/*=== PLATFORM WRAPPER FUNCTIONS =============================================*/
-#if _SFETCH_PLATFORM_POSIX
-_SOKOL_PRIVATE _sfetch_file_handle_t _sfetch_file_open(const _sfetch_path_t* path) {
-    return fopen(path->buf, "rb");
-}
-
-_SOKOL_PRIVATE void _sfetch_file_close(_sfetch_file_handle_t h) {
-    fclose(h);
+/*=== buffer pool implementation =============================================*/
+_SOKOL_PRIVATE void _sfetch_buffer_pool_discard(_sfetch_buffer_pool_t* bp) {
+    SOKOL_ASSERT(bp);
+    for (uint32_t i = 0; i < bp->num_classes; i++) {
+        _sfetch_buffer_class_t* cls = &bp->classes[i];
+        if (cls->free_slots) {
+            SOKOL_FREE(cls->free_slots);
+        }
+        if (cls->raw) {
+            SOKOL_FREE(cls->raw);
+        }
+    }
+    memset(bp, 0, sizeof(_sfetch_buffer_pool_t));
 }
 
-_SOKOL_PRIVATE bool _sfetch_file_handle_valid(_sfetch_file_handle_t h) {
-    return h != _SFETCH_INVALID_FILE_HANDLE;
+_SOKOL_PRIVATE bool _sfetch_buffer_pool_init(_sfetch_buffer_pool_t* bp, const sfetch_buffer_class_t* desc_classes) {
+    SOKOL_ASSERT(bp && desc_classes);
+    SOKOL_ASSERT(0 == bp->num_classes);
+    /* gather the non-empty size classes sorted by size (insertion sort) */
+    for (uint32_t i = 0; i < SFETCH_MAX_BUFFER_CLASSES; i++) {
+        const sfetch_buffer_class_t* src = &desc_classes[i];
+        if ((src->size == 0) || (src->count == 0)) {
+            continue;
+        }
+        uint32_t dst_index = bp->num_classes++;
+        while ((dst_index > 0) && (bp->classes[dst_index-1].size > src->size)) {
+            bp->classes[dst_index] = bp->classes[dst_index-1];
+            dst_index--;
+        }
+        memset(&bp->classes[dst_index], 0, sizeof(_sfetch_buffer_class_t));
+        bp->classes[dst_index].size = src->size;
+        bp->classes[dst_index].count = src->count;
+    }
+    /* allocate one memory block per size class */
+    bool valid = true;
+    for (uint32_t i = 0; i < bp->num_classes; i++) {
+        _sfetch_buffer_class_t* cls = &bp->classes[i];
+        cls->stride = (cls->size + (_SFETCH_BUFFER_ALIGN-1)) & ~(uint32_t)(_SFETCH_BUFFER_ALIGN-1);
+        const size_t block_size = (size_t)cls->stride * cls->count + _SFETCH_BUFFER_ALIGN;
+        cls->raw = (uint8_t*) SOKOL_MALLOC(block_size);
+        cls->free_slots = (uint32_t*) SOKOL_MALLOC(cls->count * sizeof(uint32_t));
+        if (cls->raw && cls->free_slots) {
+            const uintptr_t addr = ((uintptr_t)cls->raw + (_SFETCH_BUFFER_ALIGN-1)) & ~(uintptr_t)(_SFETCH_BUFFER_ALIGN-1);
+            cls->base = (uint8_t*) addr;
+            for (uint32_t slot = cls->count; slot > 0; slot--) {
+                cls->free_slots[cls->free_top++] = slot - 1;
+            }
+        }
+        else {
+            valid = false;
+        }
+    }
+    if (!valid) {
+        SOKOL_LOG("sfetch_setup: failed to allocate buffer pool");
+        _sfetch_buffer_pool_discard(bp);
+    }
+    return valid;
 }
 
-_SOKOL_PRIVATE uint32_t _sfetch_file_size(_sfetch_file_handle_t h) {
-    fseek(h, 0, SEEK_END);
-    return (uint32_t) ftell(h);
+/* return true if a buffer pool has been configured in sfetch_setup() */
+_SOKOL_PRIVATE bool _sfetch_buffer_pool_valid(const _sfetch_buffer_pool_t* bp) {
+    SOKOL_ASSERT(bp);
+    return bp->num_classes > 0;
 }
 
-_SOKOL_PRIVATE bool _sfetch_file_read(_sfetch_file_handle_t h, uint32_t offset, uint32_t num_bytes, void* ptr) {
-    fseek(h, offset, SEEK_SET);
-    return num_bytes == fread(ptr, 1, num_bytes, h);
+/* return true if the buffer pool has a size class which can hold num_bytes */
+_SOKOL_PRIVATE bool _sfetch_buffer_pool_fits(const _sfetch_buffer_pool_t* bp, uint32_t num_bytes) {
+    SOKOL_ASSERT(bp);
+    return (bp->num_classes > 0) && (bp->classes[bp->num_classes-1].size >= num_bytes);
 }
 
-_SOKOL_PRIVATE bool _sfetch_thread_init(_sfetch_thread_t* thread, _sfetch_thread_func_t thread_func, void* thread_arg) {
-    SOKOL_ASSERT(thread && !thread->valid && !thread->stop_requested);
-
-    pthread_mutexattr_t attr;
-    pthread_mutexattr_init(&attr);
-    pthread_mutex_init(&thread->incoming_mutex, &attr);
-    pthread_mutexattr_destroy(&attr);
-
-    pthread_mutexattr_init(&attr);
-    pthread_mutex_init(&thread->outgoing_mutex, &attr);
-    pthread_mutexattr_destroy(&attr);
-
-    pthread_mutexattr_init(&attr);
-    pthread_mutex_init(&thread->running_mutex, &attr);
-    pthread_mutexattr_destroy(&attr);
-
-    pthread_mutexattr_init(&attr);
-    pthread_mutex_init(&thread->stop_mutex, &attr);
-    pthread_mutexattr_destroy(&attr);
-
-    pthread_condattr_t cond_attr;
-    pthread_condattr_init(&cond_attr);
-    pthread_cond_init(&thread->incoming_cond, &cond_attr);
-    pthread_condattr_destroy(&cond_attr);
-
-    /* FIXME: in debug mode, the threads should be named */
-    pthread_mutex_lock(&thread->running_mutex);
-    int res = pthread_create(&thread->thread, 0, thread_func, thread_arg);
-    thread->valid = (0 == res);
-    pthread_mutex_unlock(&thread->running_mutex);
-    return thread->valid;
+/* grab a free buffer from the smallest size class that fits, falls back to bigger classes,
+   with spare_only, a buffer is only taken if at least half of the size class remains free
+*/
+_SOKOL_PRIVATE bool _sfetch_buffer_pool_alloc_from(_sfetch_buffer_pool_t* bp, uint32_t num_bytes, bool spare_only, _sfetch_buffer_t* out_buf) {
+    SOKOL_ASSERT(bp && out_buf && (num_bytes > 0));
+    for (uint32_t i = 0; i < bp->num_classes; i++) {
+        _sfetch_buffer_class_t* cls = &bp->classes[i];
+        const bool avail = (cls->free_top > 0) && (!spare_only || (((cls->free_top - 1) * 2) >= cls->count));
+        if ((cls->size >= num_bytes) && avail) {
+            const uint32_t slot = cls->free_slots[--cls->free_top];
+            SOKOL_ASSERT(slot < cls->count);
+            out_buf->ptr = cls->base + (size_t)slot * cls->stride;
+            out_buf->size = cls->size;
+            return true;
+        }
+    }
+    return false;
 }
 
-_SOKOL_PRIVATE void _sfetch_thread_request_stop(_sfetch_thread_t* thread) {
-    pthread_mutex_lock(&thread->stop_mutex);
-    thread->stop_requested = true;
-    pthread_mutex_unlock(&thread->stop_mutex);
+_SOKOL_PRIVATE bool _sfetch_buffer_pool_alloc(_sfetch_buffer_pool_t* bp, uint32_t num_bytes, _sfetch_buffer_t* out_buf) {
+    return _sfetch_buffer_pool_alloc_from(bp, num_bytes, false, out_buf);
 }
 
-_SOKOL_PRIVATE bool _sfetch_thread_stop_requested(_sfetch_thread_t* thread) {
-    pthread_mutex_lock(&thread->stop_mutex);
-    bool stop_requested = thread->stop_requested;
-    pthread_mutex_unlock(&thread->stop_mutex);
-    return stop_requested;
+/* read-ahead buffers are optional, so they never take the last half of a size
+   class, this leaves enough buffers for regular requests
+*/
+_SOKOL_PRIVATE bool _sfetch_buffer_pool_alloc_spare(_sfetch_buffer_pool_t* bp, uint32_t num_bytes, _sfetch_buffer_t* out_buf) {
+    return _sfetch_buffer_pool_alloc_from(bp, num_bytes, true, out_buf);
 }
 
-_SOKOL_PRIVATE void _sfetch_thread_join(_sfetch_thread_t* thread) {
-    SOKOL_ASSERT(thread);
-    if (thread->valid) {
-        pthread_mutex_lock(&thread->incoming_mutex);
-        _sfetch_thread_request_stop(thread);
-        pthread_cond_signal(&thread->incoming_cond);
-        pthread_mutex_unlock(&thread->incoming_mutex);
-        pthread_join(thread->thread, 0);
-        thread->valid = false;
+/* return a buffer to its size class */
+_SOKOL_PRIVATE void _sfetch_buffer_pool_free(_sfetch_buffer_pool_t* bp, const uint8_t* ptr) {
+    SOKOL_ASSERT(bp && ptr);
+    for (uint32_t i = 0; i < bp->num_classes; i++) {
+        _sfetch_buffer_class_t* cls = &bp->classes[i];
+        if ((ptr >= cls->base) && (ptr < (cls->base + (size_t)cls->stride * cls->count))) {
+            const uint32_t slot = (uint32_t)((size_t)(ptr - cls->base) / cls->stride);
+            SOKOL_ASSERT(ptr == (cls->base + (size_t)slot * cls->stride));
+            #if defined(SOKOL_DEBUG)
+            /* debug check against double-free */
+            for (uint32_t fi = 0; fi < cls->free_top; fi++) {
+                SOKOL_ASSERT(cls->free_slots[fi] != slot);
+            }
+            #endif
+            SOKOL_ASSERT(cls->free_top < cls->count);
+            cls->free_slots[cls->free_top++] = slot;
+            return;
+        }
     }
-    pthread_mutex_destroy(&thread->stop_mutex);
-    pthread_mutex_destroy(&thread->running_mutex);
-    pthread_mutex_destroy(&thread->incoming_mutex);
-    pthread_mutex_destroy(&thread->outgoing_mutex);
-    pthread_cond_destroy(&thread->incoming_cond);
+    SOKOL_ASSERT(false && "pointer doesn't belong to buffer pool");
 }
 
-/* called when the thread-func is entered, this blocks the thread func until
-   the _sfetch_thread_t object is fully initialized
-*/
-_SOKOL_PRIVATE void _sfetch_thread_entered(_sfetch_thread_t* thread) {
-    pthread_mutex_lock(&thread->running_mutex);
+/*=== access log implementation ==============================================*/
+_SOKOL_PRIVATE bool _sfetch_access_log_init(_sfetch_access_log_t* log, uint32_t size) {
+    SOKOL_ASSERT(log && (0 == log->entries));
+    if (0 == size) {
+        return true;
+    }
+    const size_t num_bytes = size * sizeof(_sfetch_access_log_entry_t);
+    log->entries = (_sfetch_access_log_entry_t*) SOKOL_MALLOC(num_bytes);
+    if (0 == log->entries) {
+        SOKOL_LOG("sfetch_setup: failed to allocate access log");
+        return false;
+    }
+    memset(log->entries, 0, num_bytes);
+    log->size = size;
+    log->num_recorded = 0;
+    return true;
 }
 
-/* called by the thread-func right before it is left */
-_SOKOL_PRIVATE void _sfetch_thread_leaving(_sfetch_thread_t* thread) {
-    pthread_mutex_unlock(&thread->running_mutex);
+_SOKOL_PRIVATE void _sfetch_access_log_discard(_sfetch_access_log_t* log) {
+    SOKOL_ASSERT(log);
+    if (log->entries) {
+        SOKOL_FREE(log->entries);
+        log->entries = 0;
+    }
+    log->size = 0;
 }
 
-_SOKOL_PRIVATE void _sfetch_thread_enqueue_incoming(_sfetch_thread_t* thread, _sfetch_ring_t* incoming, _sfetch_ring_t* src) {
-    /* called from user thread */
-    SOKOL_ASSERT(thread && thread->valid);
-    SOKOL_ASSERT(incoming && incoming->buf);
-    SOKOL_ASSERT(src && src->buf);
-    if (!_sfetch_ring_empty(src)) {
-        pthread_mutex_lock(&thread->incoming_mutex);
-        while (!_sfetch_ring_full(incoming) && !_sfetch_ring_empty(src)) {
-            _sfetch_ring_enqueue(incoming, _sfetch_ring_dequeue(src));
+/* record a fetched range of a request, consecutive chunks of a streaming
+   request are merged into one entry (unless the entry has been overwritten
+   in the meantime)
+*/
+_SOKOL_PRIVATE void _sfetch_access_log_record(_sfetch_access_log_t* log, _sfetch_item_t* item, uint32_t offset, uint32_t size) {
+    SOKOL_ASSERT(log && item);
+    if (0 == log->size) {
+        return;
+    }
+    _sfetch_access_log_entry_t* entry = 0;
+    if (item->access_log_pos > 0) {
+        const uint64_t pos = item->access_log_pos - 1;
+        if ((log->num_recorded - pos) <= log->size) {
+            entry = &log->entries[pos % log->size];
+            if ((entry->offset + entry->size) == offset) {
+                entry->size += size;
+                return;
+            }
         }
-        pthread_cond_signal(&thread->incoming_cond);
-        pthread_mutex_unlock(&thread->incoming_mutex);
     }
+    const uint64_t pos = log->num_recorded++;
+    entry = &log->entries[pos % log->size];
+    _sfetch_path_copy(&entry->path, item->path.buf);
+    entry->offset = offset;
+    entry->size = size;
+    entry->time = item->user.timings.sent;
+    item->access_log_pos = pos + 1;
 }
 
-_SOKOL_PRIVATE uint32_t _sfetch_thread_dequeue_incoming(_sfetch_thread_t* thread, _sfetch_ring_t* incoming) {
-    /* called from thread function */
-    SOKOL_ASSERT(thread && thread->valid);
+/* sort preload list entries by path, then by offset */
+_SOKOL_PRIVATE int _sfetch_preload_compare(const void* a, const void* b) {
+    const sfetch_access_log_entry_t* ea = (const sfetch_access_log_entry_t*) a;
+    const sfetch_access_log_entry_t* eb = (const sfetch_access_log_entry_t*) b;
+    const int res = strcmp(ea->path, eb->path);
+    if (res != 0) {
+        return res;
+    }
+    else if (ea->offset < eb->offset) {
+        return -1;
+    }
+    else if (ea->offset > eb->offset) {
+        return 1;
+    }
+    else {
+        return 0;
+    }
+}
+
+/* sort a preload list, and merge overlapping ranges in the same file,
+   returns the number of merged entries at the start of the array
+*/
+_SOKOL_PRIVATE int _sfetch_preload_sort_and_merge(sfetch_access_log_entry_t* entries, int num_entries) {
+    qsort(entries, (size_t)num_entries, sizeof(sfetch_access_log_entry_t), _sfetch_preload_compare);
+    int num_merged = 0;
+    for (int i = 0; i < num_entries; i++) {
+        const sfetch_access_log_entry_t cur = entries[i];
+        if (num_merged > 0) {
+            sfetch_access_log_entry_t* last = &entries[num_merged - 1];
+            /* a zero size means 'to end of file' */
+            const bool last_to_eof = (0 == last->size);
+            const uint64_t last_end = (uint64_t)last->offset + last->size;
+            if ((0 == strcmp(last->path, cur.path)) && (last_to_eof || (cur.offset <= last_end))) {
+                if (!last_to_eof) {
+                    const uint64_t cur_end = (uint64_t)cur.offset + cur.size;
+                    if (0 == cur.size) {
+                        last->size = 0;
+                    }
+                    else if (cur_end > last_end) {
+                        last->size = (uint32_t)(cur_end - last->offset);
+                    }
+                }
+                if (cur.time < last->time) {
+                    last->time = cur.time;
+                }
+                continue;
+            }
+        }
+        entries[num_merged++] = cur;
+    }
+    return num_merged;
+}
+
+/* the response callback of preload requests */
+_SOKOL_PRIVATE void _sfetch_preload_callback(const sfetch_response_t* response) {
+    _SOKOL_UNUSED(response);
+}
+
+/*=== PLATFORM WRAPPER FUNCTIONS =============================================*/
+#if _SFETCH_PLATFORM_POSIX
+/* file handles are file descriptors plus one, so that 0 is an invalid handle */
+_SOKOL_PRIVATE void* _sfetch_posix_fd_to_handle(int fd) {
+    return (fd >= 0) ? (void*)(intptr_t)(fd + 1) : 0;
+}
+
+_SOKOL_PRIVATE int _sfetch_posix_handle_to_fd(void* h) {
+    return (int)((intptr_t)h - 1);
+}
+
+_SOKOL_PRIVATE void* _sfetch_native_file_open(const char* path, void* user_data) {
+    (void)user_data;
+    return _sfetch_posix_fd_to_handle(open(path, O_RDONLY));
+}
+
+_SOKOL_PRIVATE void _sfetch_native_file_close(void* h, void* user_data) {
+    (void)user_data;
+    close(_sfetch_posix_handle_to_fd(h));
+}
+
+_SOKOL_PRIVATE uint32_t _sfetch_native_file_size(void* h, void* user_data) {
+    (void)user_data;
+    struct stat st;
+    if (0 == fstat(_sfetch_posix_handle_to_fd(h), &st)) {
+        return (uint32_t) st.st_size;
+    }
+    else {
+        return 0;
+    }
+}
+
+_SOKOL_PRIVATE bool _sfetch_native_file_read(void* h, uint32_t offset, uint32_t num_bytes, void* ptr, void* user_data) {
+    (void)user_data;
+    const int fd = _sfetch_posix_handle_to_fd(h);
+    uint8_t* dst = (uint8_t*) ptr;
+    #if !_SFETCH_HAS_PREAD
+    if (lseek(fd, (off_t)offset, SEEK_SET) < 0) {
+        return false;
+    }
+    #endif
+    while (num_bytes > 0) {
+        #if _SFETCH_HAS_PREAD
+        const ssize_t res = pread(fd, dst, num_bytes, (off_t)offset);
+        #else
+        const ssize_t res = read(fd, dst, num_bytes);
+        #endif
+        if (res > 0) {
+            dst += res;
+            offset += (uint32_t)res;
+            num_bytes -= (uint32_t)res;
+        }
+        else if ((res < 0) && (errno == EINTR)) {
+            continue;
+        }
+        else {
+            /* error or unexpected end-of-file */
+            return false;
+        }
+    }
+    return true;
+}
+
+/* open a file for reading with the OS file cache bypassed */
+_SOKOL_PRIVATE void* _sfetch_native_file_open_direct(const char* path) {
+    int fd = -1;
+    #if defined(O_DIRECT)
+    fd = open(path, O_RDONLY|O_DIRECT);
+    #endif
+    if (fd < 0) {
+        /* no O_DIRECT (or not supported by file system), the data
+           will be dropped from the file cache after reading instead
+        */
+        fd = open(path, O_RDONLY);
+    }
+    #if defined(__APPLE__)
+    if (fd >= 0) {
+        fcntl(fd, F_NOCACHE, 1);
+    }
+    #endif
+    return _sfetch_posix_fd_to_handle(fd);
+}
+
+#if defined(O_DIRECT)
+/* read the unaligned tail of an O_DIRECT read (less than one block) through
+   an aligned bounce buffer, the block read may run into the end of the file,
+   so fewer bytes than the block size are fine as long as num_bytes are read
+*/
+_SOKOL_PRIVATE bool _sfetch_native_file_read_direct_tail(int fd, uint32_t offset, uint32_t num_bytes, uint8_t* dst) {
+    SOKOL_ASSERT(num_bytes < _SFETCH_DIRECT_IO_ALIGN);
+    SOKOL_ASSERT(0 == (offset & (_SFETCH_DIRECT_IO_ALIGN - 1)));
+    uint8_t storage[2 * _SFETCH_DIRECT_IO_ALIGN];
+    uint8_t* bounce = (uint8_t*) (((uintptr_t)storage + (_SFETCH_DIRECT_IO_ALIGN - 1)) & ~(uintptr_t)(_SFETCH_DIRECT_IO_ALIGN - 1));
+    ssize_t res;
+    do {
+        #if _SFETCH_HAS_PREAD
+        res = pread(fd, bounce, _SFETCH_DIRECT_IO_ALIGN, (off_t)offset);
+        #else
+        res = (lseek(fd, (off_t)offset, SEEK_SET) < 0) ? -1 : read(fd, bounce, _SFETCH_DIRECT_IO_ALIGN);
+        #endif
+    } while ((res < 0) && (errno == EINTR));
+    if (res < (ssize_t)num_bytes) {
+        return false;
+    }
+    memcpy(dst, bounce, num_bytes);
+    return true;
+}
+#endif
+
+_SOKOL_PRIVATE bool _sfetch_native_file_read_direct(void* h, uint32_t offset, uint32_t num_bytes, void* ptr) {
+    const int fd = _sfetch_posix_handle_to_fd(h);
+    bool uncached = false;
+    bool res;
+    #if defined(O_DIRECT)
+    const int flags = fcntl(fd, F_GETFL);
+    if ((flags != -1) && (flags & O_DIRECT)) {
+        const uint32_t mask = _SFETCH_DIRECT_IO_ALIGN - 1;
+        if ((offset & mask) || ((uintptr_t)ptr & mask)) {
+            /* O_DIRECT can't do this read, do it with buffered IO, but keep
+               O_DIRECT for the following reads
+            */
+            fcntl(fd, F_SETFL, flags & ~O_DIRECT);
+            res = _sfetch_native_file_read(h, offset, num_bytes, ptr, 0);
+            fcntl(fd, F_SETFL, flags);
+        }
+        else {
+            /* the aligned part is read directly into the destination buffer,
+               an unaligned tail (usually the end of the file) through a bounce buffer
+            */
+            const uint32_t num_tail_bytes = num_bytes & mask;
+            const uint32_t num_head_bytes = num_bytes - num_tail_bytes;
+            res = true;
+            if (num_head_bytes > 0) {
+                res = _sfetch_native_file_read(h, offset, num_head_bytes, ptr, 0);
+            }
+            if (res && (num_tail_bytes > 0)) {
+                res = _sfetch_native_file_read_direct_tail(fd, offset + num_head_bytes, num_tail_bytes, (uint8_t*)ptr + num_head_bytes);
+            }
+            uncached = true;
+        }
+    }
+    else
+    #endif
+    {
+        res = _sfetch_native_file_read(h, offset, num_bytes, ptr, 0);
+    }
+    #if defined(POSIX_FADV_DONTNEED)
+    if (!uncached) {
+        posix_fadvise(fd, (off_t)offset, (off_t)num_bytes, POSIX_FADV_DONTNEED);
+    }
+    #endif
+    _SOKOL_UNUSED(fd);
+    _SOKOL_UNUSED(uncached);
+    return res;
+}
+
+/* ask the OS to read a file range into the file cache in the background,
+   returns false if this isn't supported
+*/
+_SOKOL_PRIVATE bool _sfetch_native_file_preload(const char* path, uint32_t offset, uint32_t size) {
+    #if defined(POSIX_FADV_WILLNEED) || defined(F_RDADVISE)
+    const int fd = open(path, O_RDONLY);
+    if (fd >= 0) {
+        #if defined(POSIX_FADV_WILLNEED)
+        posix_fadvise(fd, (off_t)offset, (off_t)size, POSIX_FADV_WILLNEED);
+        #else
+        if (0 == size) {
+            struct stat st;
+            if ((0 == fstat(fd, &st)) && (st.st_size > (off_t)offset)) {
+                size = (uint32_t)(st.st_size - (off_t)offset);
+            }
+        }
+        struct radvisory ra;
+        ra.ra_offset = (off_t)offset;
+        ra.ra_count = (int)size;
+        fcntl(fd, F_RDADVISE, &ra);
+        #endif
+        close(fd);
+    }
+    return true;
+    #else
+    _SOKOL_UNUSED(path);
+    _SOKOL_UNUSED(offset);
+    _SOKOL_UNUSED(size);
+    return false;
+    #endif
+}
+
+/* create the thread's sync objects, the thread itself is started with _sfetch_thread_start() */
+_SOKOL_PRIVATE void _sfetch_thread_init(_sfetch_thread_t* thread) {
+    SOKOL_ASSERT(thread && !thread->valid && !thread->stop_requested);
+
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutex_init(&thread->incoming_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutex_init(&thread->outgoing_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutex_init(&thread->running_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutex_init(&thread->stop_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_cond_init(&thread->incoming_cond, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+}
+
+_SOKOL_PRIVATE bool _sfetch_thread_start(_sfetch_thread_t* thread, _sfetch_thread_func_t thread_func, void* thread_arg) {
+    SOKOL_ASSERT(thread && !thread->valid && !thread->stop_requested);
+    /* FIXME: in debug mode, the threads should be named */
+    pthread_mutex_lock(&thread->running_mutex);
+    int res = pthread_create(&thread->thread, 0, thread_func, thread_arg);
+    thread->valid = (0 == res);
+    pthread_mutex_unlock(&thread->running_mutex);
+    return thread->valid;
+}
+
+_SOKOL_PRIVATE void _sfetch_thread_request_stop(_sfetch_thread_t* thread) {
+    pthread_mutex_lock(&thread->stop_mutex);
+    thread->stop_requested = true;
+    pthread_mutex_unlock(&thread->stop_mutex);
+}
+
+_SOKOL_PRIVATE bool _sfetch_thread_stop_requested(_sfetch_thread_t* thread) {
+    pthread_mutex_lock(&thread->stop_mutex);
+    bool stop_requested = thread->stop_requested;
+    pthread_mutex_unlock(&thread->stop_mutex);
+    return stop_requested;
+}
+
+_SOKOL_PRIVATE void _sfetch_thread_join(_sfetch_thread_t* thread) {
+    SOKOL_ASSERT(thread);
+    if (thread->valid) {
+        pthread_mutex_lock(&thread->incoming_mutex);
+        _sfetch_thread_request_stop(thread);
+        pthread_cond_signal(&thread->incoming_cond);
+        pthread_mutex_unlock(&thread->incoming_mutex);
+        pthread_join(thread->thread, 0);
+        thread->valid = false;
+    }
+}
+
+/* destroy the thread's sync objects, must be called after _sfetch_thread_join() */
+_SOKOL_PRIVATE void _sfetch_thread_discard(_sfetch_thread_t* thread) {
+    SOKOL_ASSERT(thread && !thread->valid);
+    pthread_mutex_destroy(&thread->stop_mutex);
+    pthread_mutex_destroy(&thread->running_mutex);
+    pthread_mutex_destroy(&thread->incoming_mutex);
+    pthread_mutex_destroy(&thread->outgoing_mutex);
+    pthread_cond_destroy(&thread->incoming_cond);
+}
+
+/* called when the thread-func is entered, this blocks the thread func until
+   the _sfetch_thread_t object is fully initialized
+*/
+_SOKOL_PRIVATE void _sfetch_thread_entered(_sfetch_thread_t* thread) {
+    pthread_mutex_lock(&thread->running_mutex);
+}
+
+/* called by the thread-func right before it is left */
+_SOKOL_PRIVATE void _sfetch_thread_leaving(_sfetch_thread_t* thread) {
+    pthread_mutex_unlock(&thread->running_mutex);
+}
+
+_SOKOL_PRIVATE uint32_t _sfetch_thread_enqueue_incoming(_sfetch_thread_t* thread, _sfetch_ring_t* incoming, _sfetch_ring_t* src) {
+    /* called from user thread, returns the number of items waiting in the incoming queue */
+    SOKOL_ASSERT(thread && thread->valid);
+    SOKOL_ASSERT(incoming && incoming->buf);
+    SOKOL_ASSERT(src && src->buf);
+    uint32_t num_waiting = 0;
+    if (!_sfetch_ring_empty(src)) {
+        pthread_mutex_lock(&thread->incoming_mutex);
+        while (!_sfetch_ring_full(incoming) && !_sfetch_ring_empty(src)) {
+            _sfetch_ring_enqueue(incoming, _sfetch_ring_dequeue(src));
+        }
+        num_waiting = _sfetch_ring_count(incoming);
+        pthread_cond_signal(&thread->incoming_cond);
+        pthread_mutex_unlock(&thread->incoming_mutex);
+    }
+    return num_waiting;
+}
+
+/* wake up a thread blocked in _sfetch_thread_dequeue_incoming() even if it has no incoming
+   items, returns false if the thread isn't idle (or has already been woken up)
+*/
+_SOKOL_PRIVATE bool _sfetch_thread_wakeup_idle(_sfetch_thread_t* thread) {
+    SOKOL_ASSERT(thread && thread->valid);
+    pthread_mutex_lock(&thread->incoming_mutex);
+    const bool wakeup = thread->idle && !thread->wakeup_requested;
+    if (wakeup) {
+        thread->wakeup_requested = true;
+        pthread_cond_signal(&thread->incoming_cond);
+    }
+    pthread_mutex_unlock(&thread->incoming_mutex);
+    return wakeup;
+}
+
+/* called from another channel's thread function, dequeue the oldest incoming
+   item if the 'stealable' callback agrees, otherwise return 0
+*/
+_SOKOL_PRIVATE uint32_t _sfetch_thread_steal_incoming(_sfetch_thread_t* thread, _sfetch_ring_t* incoming, bool (*stealable)(_sfetch_pool_t*, uint32_t), _sfetch_pool_t* pool) {
+    SOKOL_ASSERT(thread && incoming && stealable && pool);
+    uint32_t item = 0;
+    pthread_mutex_lock(&thread->incoming_mutex);
+    if (!_sfetch_ring_empty(incoming) && stealable(pool, _sfetch_ring_peek(incoming, 0))) {
+        item = _sfetch_ring_dequeue(incoming);
+    }
+    pthread_mutex_unlock(&thread->incoming_mutex);
+    return item;
+}
+
+_SOKOL_PRIVATE uint32_t _sfetch_thread_dequeue_incoming(_sfetch_thread_t* thread, _sfetch_ring_t* incoming, bool wait) {
+    /* called from thread function, returns 0 if !wait and the incoming queue is empty,
+       or if the thread was woken up via _sfetch_thread_wakeup_idle()
+    */
+    SOKOL_ASSERT(thread && thread->valid);
     SOKOL_ASSERT(incoming && incoming->buf);
     pthread_mutex_lock(&thread->incoming_mutex);
-    while (_sfetch_ring_empty(incoming) && !thread->stop_requested) {
+    while (wait && _sfetch_ring_empty(incoming) && !thread->stop_requested && !thread->wakeup_requested) {
+        thread->idle = true;
         pthread_cond_wait(&thread->incoming_cond, &thread->incoming_mutex);
     }
+    thread->idle = false;
+    thread->wakeup_requested = false;
     uint32_t item = 0;
-    if (!thread->stop_requested) {
+    if (!thread->stop_requested && !_sfetch_ring_empty(incoming)) {
         item = _sfetch_ring_dequeue(incoming);
     }
     pthread_mutex_unlock(&thread->incoming_mutex);
@@ -1578,14 +2743,19 @@ _SOKOL_PRIVATE uint32_t _sfetch_thread_dequeue_incoming(_sfetch_thread_t* thread
 }
 
 _SOKOL_PRIVATE bool _sfetch_thread_enqueue_outgoing(_sfetch_thread_t* thread, _sfetch_ring_t* outgoing, uint32_t item) {
-    /* called from thread function */
-    SOKOL_ASSERT(thread && thread->valid);
+    /* called from thread function (in work-sharing mode also from other channel's
+       threads, so don't check thread->valid, which is written by the user thread)
+    */
+    SOKOL_ASSERT(thread);
     SOKOL_ASSERT(outgoing && outgoing->buf);
     SOKOL_ASSERT(0 != item);
     pthread_mutex_lock(&thread->outgoing_mutex);
     bool result = false;
+    /* the outgoing queue has one slot per lane, so it can never overflow */
+    SOKOL_ASSERT(!_sfetch_ring_full(outgoing));
     if (!_sfetch_ring_full(outgoing)) {
         _sfetch_ring_enqueue(outgoing, item);
+        result = true;
     }
     pthread_mutex_unlock(&thread->outgoing_mutex);
     return result;
@@ -1620,36 +2790,40 @@ _SOKOL_PRIVATE bool _sfetch_win32_utf8_to_wide(const char* src, wchar_t* dst, in
     }
 }
 
-_SOKOL_PRIVATE _sfetch_file_handle_t _sfetch_file_open(const _sfetch_path_t* path) {
+_SOKOL_PRIVATE void* _sfetch_win32_file_open(const char* path, DWORD flags) {
     wchar_t w_path[SFETCH_MAX_PATH];
-    if (!_sfetch_win32_utf8_to_wide(path->buf, w_path, sizeof(w_path))) {
-        SOKOL_LOG("_sfetch_file_open: error converting UTF-8 path to wide string");
+    if (!_sfetch_win32_utf8_to_wide(path, w_path, sizeof(w_path))) {
+        SOKOL_LOG("_sfetch_win32_file_open: error converting UTF-8 path to wide string");
         return 0;
     }
-    _sfetch_file_handle_t h = CreateFileW(
+    HANDLE h = CreateFileW(
         w_path,                 /* lpFileName */
         GENERIC_READ,           /* dwDesiredAccess */
         FILE_SHARE_READ,        /* dwShareMode */
         NULL,                   /* lpSecurityAttributes */
         OPEN_EXISTING,          /* dwCreationDisposition */
-        FILE_ATTRIBUTE_NORMAL|FILE_FLAG_SEQUENTIAL_SCAN,    /* dwFlagsAndAttributes */
+        FILE_ATTRIBUTE_NORMAL|flags,    /* dwFlagsAndAttributes */
         NULL);                  /* hTemplateFile */
-    return h;
+    return (INVALID_HANDLE_VALUE == h) ? 0 : (void*)h;
 }
 
-_SOKOL_PRIVATE void _sfetch_file_close(_sfetch_file_handle_t h) {
-    CloseHandle(h);
+_SOKOL_PRIVATE void* _sfetch_native_file_open(const char* path, void* user_data) {
+    (void)user_data;
+    return _sfetch_win32_file_open(path, FILE_FLAG_SEQUENTIAL_SCAN);
 }
 
-_SOKOL_PRIVATE bool _sfetch_file_handle_valid(_sfetch_file_handle_t h) {
-    return h != _SFETCH_INVALID_FILE_HANDLE;
+_SOKOL_PRIVATE void _sfetch_native_file_close(void* h, void* user_data) {
+    (void)user_data;
+    CloseHandle((HANDLE)h);
 }
 
-_SOKOL_PRIVATE uint32_t _sfetch_file_size(_sfetch_file_handle_t h) {
-    return GetFileSize(h, NULL);
+_SOKOL_PRIVATE uint32_t _sfetch_native_file_size(void* h, void* user_data) {
+    (void)user_data;
+    return GetFileSize((HANDLE)h, NULL);
 }
 
-_SOKOL_PRIVATE bool _sfetch_file_read(_sfetch_file_handle_t h, uint32_t offset, uint32_t num_bytes, void* ptr) {
+_SOKOL_PRIVATE bool _sfetch_native_file_read(void* h, uint32_t offset, uint32_t num_bytes, void* ptr, void* user_data) {
+    (void)user_data;
     LARGE_INTEGER offset_li;
     offset_li.QuadPart = offset;
     BOOL seek_res = SetFilePointerEx(h, offset_li, NULL, FILE_BEGIN);
@@ -1663,7 +2837,40 @@ _SOKOL_PRIVATE bool _sfetch_file_read(_sfetch_file_handle_t h, uint32_t offset,
     }
 }
 
-_SOKOL_PRIVATE bool _sfetch_thread_init(_sfetch_thread_t* thread, _sfetch_thread_func_t thread_func, void* thread_arg) {
+/* open a file for reading with the OS file cache bypassed */
+_SOKOL_PRIVATE void* _sfetch_native_file_open_direct(const char* path) {
+    return _sfetch_win32_file_open(path, FILE_FLAG_NO_BUFFERING);
+}
+
+_SOKOL_PRIVATE bool _sfetch_native_file_read_direct(void* h, uint32_t offset, uint32_t num_bytes, void* ptr) {
+    const uint32_t mask = _SFETCH_DIRECT_IO_ALIGN - 1;
+    if ((offset & mask) || (num_bytes & mask) || ((uintptr_t)ptr & mask)) {
+        /* unbuffered handles can't do unaligned reads, use a temporary buffered handle */
+        HANDLE buffered_h = ReOpenFile((HANDLE)h, GENERIC_READ, FILE_SHARE_READ, FILE_FLAG_SEQUENTIAL_SCAN);
+        if (INVALID_HANDLE_VALUE == buffered_h) {
+            return false;
+        }
+        const bool res = _sfetch_native_file_read((void*)buffered_h, offset, num_bytes, ptr, 0);
+        CloseHandle(buffered_h);
+        return res;
+    }
+    else {
+        return _sfetch_native_file_read(h, offset, num_bytes, ptr, 0);
+    }
+}
+
+/* no background read-hint for regular files on Windows, the file
+   range will be read and discarded instead
+*/
+_SOKOL_PRIVATE bool _sfetch_native_file_preload(const char* path, uint32_t offset, uint32_t size) {
+    _SOKOL_UNUSED(path);
+    _SOKOL_UNUSED(offset);
+    _SOKOL_UNUSED(size);
+    return false;
+}
+
+/* create the thread's sync objects, the thread itself is started with _sfetch_thread_start() */
+_SOKOL_PRIVATE void _sfetch_thread_init(_sfetch_thread_t* thread) {
     SOKOL_ASSERT(thread && !thread->valid && !thread->stop_requested);
 
     thread->incoming_event = CreateEventA(NULL, FALSE, FALSE, NULL);
@@ -1672,7 +2879,10 @@ _SOKOL_PRIVATE bool _sfetch_thread_init(_sfetch_thread_t* thread, _sfetch_thread
     InitializeCriticalSection(&thread->outgoing_critsec);
     InitializeCriticalSection(&thread->running_critsec);
     InitializeCriticalSection(&thread->stop_critsec);
+}
 
+_SOKOL_PRIVATE bool _sfetch_thread_start(_sfetch_thread_t* thread, _sfetch_thread_func_t thread_func, void* thread_arg) {
+    SOKOL_ASSERT(thread && !thread->valid && !thread->stop_requested);
     EnterCriticalSection(&thread->running_critsec);
     const SIZE_T stack_size = 512 * 1024;
     thread->thread = CreateThread(NULL, stack_size, thread_func, thread_arg, 0, NULL);
@@ -1706,6 +2916,11 @@ _SOKOL_PRIVATE void _sfetch_thread_join(_sfetch_thread_t* thread) {
         CloseHandle(thread->thread);
         thread->valid = false;
     }
+}
+
+/* destroy the thread's sync objects, must be called after _sfetch_thread_join() */
+_SOKOL_PRIVATE void _sfetch_thread_discard(_sfetch_thread_t* thread) {
+    SOKOL_ASSERT(thread && !thread->valid);
     CloseHandle(thread->incoming_event);
     DeleteCriticalSection(&thread->stop_critsec);
     DeleteCriticalSection(&thread->running_critsec);
@@ -1722,35 +2937,76 @@ _SOKOL_PRIVATE void _sfetch_thread_leaving(_sfetch_thread_t* thread) {
     LeaveCriticalSection(&thread->running_critsec);
 }
 
-_SOKOL_PRIVATE void _sfetch_thread_enqueue_incoming(_sfetch_thread_t* thread, _sfetch_ring_t* incoming, _sfetch_ring_t* src) {
-    /* called from user thread */
+_SOKOL_PRIVATE uint32_t _sfetch_thread_enqueue_incoming(_sfetch_thread_t* thread, _sfetch_ring_t* incoming, _sfetch_ring_t* src) {
+    /* called from user thread, returns the number of items waiting in the incoming queue */
     SOKOL_ASSERT(thread && thread->valid);
     SOKOL_ASSERT(incoming && incoming->buf);
     SOKOL_ASSERT(src && src->buf);
+    uint32_t num_waiting = 0;
     if (!_sfetch_ring_empty(src)) {
         EnterCriticalSection(&thread->incoming_critsec);
         while (!_sfetch_ring_full(incoming) && !_sfetch_ring_empty(src)) {
             _sfetch_ring_enqueue(incoming, _sfetch_ring_dequeue(src));
         }
+        num_waiting = _sfetch_ring_count(incoming);
         LeaveCriticalSection(&thread->incoming_critsec);
         BOOL set_event_res = SetEvent(thread->incoming_event);
         _SOKOL_UNUSED(set_event_res);
         SOKOL_ASSERT(set_event_res);
     }
+    return num_waiting;
 }
 
-_SOKOL_PRIVATE uint32_t _sfetch_thread_dequeue_incoming(_sfetch_thread_t* thread, _sfetch_ring_t* incoming) {
-    /* called from thread function */
+/* wake up a thread blocked in _sfetch_thread_dequeue_incoming() even if it has no incoming
+   items, returns false if the thread isn't idle (or has already been woken up)
+*/
+_SOKOL_PRIVATE bool _sfetch_thread_wakeup_idle(_sfetch_thread_t* thread) {
+    SOKOL_ASSERT(thread && thread->valid);
+    EnterCriticalSection(&thread->incoming_critsec);
+    const bool wakeup = thread->idle && !thread->wakeup_requested;
+    if (wakeup) {
+        thread->wakeup_requested = true;
+    }
+    LeaveCriticalSection(&thread->incoming_critsec);
+    if (wakeup) {
+        BOOL set_event_res = SetEvent(thread->incoming_event);
+        _SOKOL_UNUSED(set_event_res);
+        SOKOL_ASSERT(set_event_res);
+    }
+    return wakeup;
+}
+
+/* called from another channel's thread function, dequeue the oldest incoming
+   item if the 'stealable' callback agrees, otherwise return 0
+*/
+_SOKOL_PRIVATE uint32_t _sfetch_thread_steal_incoming(_sfetch_thread_t* thread, _sfetch_ring_t* incoming, bool (*stealable)(_sfetch_pool_t*, uint32_t), _sfetch_pool_t* pool) {
+    SOKOL_ASSERT(thread && incoming && stealable && pool);
+    uint32_t item = 0;
+    EnterCriticalSection(&thread->incoming_critsec);
+    if (!_sfetch_ring_empty(incoming) && stealable(pool, _sfetch_ring_peek(incoming, 0))) {
+        item = _sfetch_ring_dequeue(incoming);
+    }
+    LeaveCriticalSection(&thread->incoming_critsec);
+    return item;
+}
+
+_SOKOL_PRIVATE uint32_t _sfetch_thread_dequeue_incoming(_sfetch_thread_t* thread, _sfetch_ring_t* incoming, bool wait) {
+    /* called from thread function, returns 0 if !wait and the incoming queue is empty,
+       or if the thread was woken up via _sfetch_thread_wakeup_idle()
+    */
     SOKOL_ASSERT(thread && thread->valid);
     SOKOL_ASSERT(incoming && incoming->buf);
     EnterCriticalSection(&thread->incoming_critsec);
-    while (_sfetch_ring_empty(incoming) && !thread->stop_requested) {
+    while (wait && _sfetch_ring_empty(incoming) && !thread->stop_requested && !thread->wakeup_requested) {
+        thread->idle = true;
         LeaveCriticalSection(&thread->incoming_critsec);
         WaitForSingleObject(thread->incoming_event, INFINITE);
         EnterCriticalSection(&thread->incoming_critsec);
     }
+    thread->idle = false;
+    thread->wakeup_requested = false;
     uint32_t item = 0;
-    if (!thread->stop_requested) {
+    if (!thread->stop_requested && !_sfetch_ring_empty(incoming)) {
         item = _sfetch_ring_dequeue(incoming);
     }
     LeaveCriticalSection(&thread->incoming_critsec);
@@ -1758,13 +3014,18 @@ _SOKOL_PRIVATE uint32_t _sfetch_thread_dequeue_incoming(_sfetch_thread_t* thread
 }
 
 _SOKOL_PRIVATE bool _sfetch_thread_enqueue_outgoing(_sfetch_thread_t* thread, _sfetch_ring_t* outgoing, uint32_t item) {
-    /* called from thread function */
-    SOKOL_ASSERT(thread && thread->valid);
+    /* called from thread function (in work-sharing mode also from other channel's
+       threads, so don't check thread->valid, which is written by the user thread)
+    */
+    SOKOL_ASSERT(thread);
     SOKOL_ASSERT(outgoing && outgoing->buf);
     EnterCriticalSection(&thread->outgoing_critsec);
     bool result = false;
+    /* the outgoing queue has one slot per lane, so it can never overflow */
+    SOKOL_ASSERT(!_sfetch_ring_full(outgoing));
     if (!_sfetch_ring_full(outgoing)) {
         _sfetch_ring_enqueue(outgoing, item);
+        result = true;
     }
     LeaveCriticalSection(&thread->outgoing_critsec);
     return result;
@@ -1787,31 +3048,192 @@ _SOKOL_PRIVATE void _sfetch_thread_dequeue_outgoing(_sfetch_thread_t* thread, _s
 
 /* per-channel request handler for native platforms accessing the local filesystem */
 #if _SFETCH_HAS_THREADS
+/* file access goes through the file backend callbacks */
+_SOKOL_PRIVATE _sfetch_file_handle_t _sfetch_file_open(_sfetch_t* ctx, const _sfetch_path_t* path, bool direct_io) {
+    /* direct IO is only supported by the native file functions */
+    if (direct_io && (0 == ctx->desc.file_backend.open_cb)) {
+        return _sfetch_native_file_open_direct(path->buf);
+    }
+    return ctx->file_backend.open_cb(path->buf, ctx->file_backend.user_data);
+}
+
+_SOKOL_PRIVATE void _sfetch_file_close(_sfetch_t* ctx, _sfetch_file_handle_t h) {
+    ctx->file_backend.close_cb(h, ctx->file_backend.user_data);
+}
+
+_SOKOL_PRIVATE bool _sfetch_file_handle_valid(_sfetch_file_handle_t h) {
+    return h != _SFETCH_INVALID_FILE_HANDLE;
+}
+
+_SOKOL_PRIVATE uint32_t _sfetch_file_size(_sfetch_t* ctx, _sfetch_file_handle_t h) {
+    return ctx->file_backend.size_cb(h, ctx->file_backend.user_data);
+}
+
+_SOKOL_PRIVATE bool _sfetch_file_read(_sfetch_t* ctx, _sfetch_file_handle_t h, bool direct_io, uint32_t offset, uint32_t num_bytes, void* ptr) {
+    if (direct_io && (0 == ctx->desc.file_backend.open_cb)) {
+        return _sfetch_native_file_read_direct(h, offset, num_bytes, ptr);
+    }
+    return ctx->file_backend.read_cb(h, offset, num_bytes, ptr, ctx->file_backend.user_data);
+}
+
+/* warm up the file cache for a file range, either with a hint to the
+   OS, or by reading the data in small pieces and throwing it away
+*/
+#define _SFETCH_PRELOAD_READ_SIZE (16 * 1024)
+_SOKOL_PRIVATE void _sfetch_file_preload(_sfetch_t* ctx, const _sfetch_path_t* path, uint32_t offset, uint32_t size) {
+    if ((0 == ctx->desc.file_backend.open_cb) && _sfetch_native_file_preload(path->buf, offset, size)) {
+        return;
+    }
+    _sfetch_file_handle_t h = _sfetch_file_open(ctx, path, false);
+    if (_sfetch_file_handle_valid(h)) {
+        const uint32_t content_size = _sfetch_file_size(ctx, h);
+        uint32_t end = content_size;
+        if ((size > 0) && (((uint64_t)offset + size) < content_size)) {
+            end = offset + size;
+        }
+        uint8_t buf[_SFETCH_PRELOAD_READ_SIZE];
+        while (offset < end) {
+            const uint32_t num_bytes = ((end - offset) < _SFETCH_PRELOAD_READ_SIZE) ? (end - offset) : _SFETCH_PRELOAD_READ_SIZE;
+            if (!_sfetch_file_read(ctx, h, false, offset, num_bytes, buf)) {
+                break;
+            }
+            offset += num_bytes;
+        }
+        _sfetch_file_close(ctx, h);
+    }
+}
+
+_SOKOL_PRIVATE void _sfetch_read_ahead_reset(_sfetch_read_ahead_t* ra) {
+    memset(ra, 0, sizeof(_sfetch_read_ahead_t));
+    ra->file_handle = _SFETCH_INVALID_FILE_HANDLE;
+}
+
+/* called when a streaming request with read-ahead buffers is first seen on its lane */
+_SOKOL_PRIVATE void _sfetch_read_ahead_init(_sfetch_read_ahead_t* ra, uint32_t slot_id, const _sfetch_item_t* item) {
+    _sfetch_read_ahead_reset(ra);
+    ra->slot_id = slot_id;
+    ra->file_handle = item->thread.file_handle;
+    ra->direct_io = item->direct_io;
+    ra->content_size = item->thread.content_size;
+    ra->read_offset = item->thread.fetched_offset;
+    ra->num_bufs = item->num_read_ahead_bufs;
+    for (uint32_t i = 0; i < ra->num_bufs; i++) {
+        ra->bufs[i] = item->read_ahead_bufs[i];
+    }
+}
+
+/* return true if there's a free read-ahead buffer on any lane */
+_SOKOL_PRIVATE bool _sfetch_read_ahead_pending(const _sfetch_channel_t* chn) {
+    for (uint32_t lane = 0; lane < chn->num_lanes; lane++) {
+        const _sfetch_read_ahead_t* ra = &chn->read_ahead[lane];
+        if ((ra->slot_id != 0) && !ra->failed && (ra->count < ra->num_bufs) && (ra->read_offset < ra->content_size)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* read one chunk ahead on the lane with the fewest chunks in its read-ahead ring */
+_SOKOL_PRIVATE void _sfetch_read_ahead_step(_sfetch_channel_t* chn) {
+    _sfetch_read_ahead_t* ra = 0;
+    for (uint32_t lane = 0; lane < chn->num_lanes; lane++) {
+        _sfetch_read_ahead_t* cur = &chn->read_ahead[lane];
+        if ((cur->slot_id != 0) && !cur->failed && (cur->count < cur->num_bufs) && (cur->read_offset < cur->content_size)) {
+            if ((0 == ra) || (cur->count < ra->count)) {
+                ra = cur;
+            }
+        }
+    }
+    if (ra) {
+        const uint32_t index = ra->head;
+        uint32_t bytes_to_read = ra->chunk_size;
+        if (bytes_to_read > ra->bufs[index].size) {
+            bytes_to_read = ra->bufs[index].size;
+        }
+        if ((ra->read_offset + bytes_to_read) > ra->content_size) {
+            bytes_to_read = ra->content_size - ra->read_offset;
+        }
+        ra->io_start[index] = _sfetch_timer_now(&chn->ctx->timer);
+        if (_sfetch_file_read(chn->ctx, ra->file_handle, ra->direct_io, ra->read_offset, bytes_to_read, ra->bufs[index].ptr)) {
+            ra->io_end[index] = _sfetch_timer_now(&chn->ctx->timer);
+            ra->sizes[index] = bytes_to_read;
+            ra->chunk_sizes[index] = ra->chunk_size;
+            ra->read_offset += bytes_to_read;
+            ra->head = (ra->head + 1) % ra->num_bufs;
+            ra->count++;
+        }
+        else {
+            /* let the regular read path handle the error */
+            ra->failed = true;
+        }
+    }
+}
+
+/* requests with read-ahead must stay on their own channel's thread which
+   owns the per-lane read-ahead state
+*/
+_SOKOL_PRIVATE bool _sfetch_item_stealable(_sfetch_pool_t* pool, uint32_t slot_id) {
+    const _sfetch_item_t* item = _sfetch_pool_item_lookup(pool, slot_id);
+    return item && (0 == item->num_read_ahead_bufs);
+}
+
+/* in work-sharing mode, take an incoming request from another channel,
+   returns 0 if there's nothing to steal
+*/
+_SOKOL_PRIVATE uint32_t _sfetch_channel_steal(_sfetch_channel_t* chn, _sfetch_channel_t** out_owner) {
+    _sfetch_t* ctx = chn->ctx;
+    const uint32_t num_channels = ctx->desc.num_channels;
+    const uint32_t chn_index = (uint32_t)(chn - ctx->chn);
+    for (uint32_t i = 1; i < num_channels; i++) {
+        _sfetch_channel_t* victim = &ctx->chn[(chn_index + i) % num_channels];
+        if (victim->valid) {
+            const uint32_t slot_id = _sfetch_thread_steal_incoming(&victim->thread, &victim->thread_incoming, _sfetch_item_stealable, &ctx->pool);
+            if (0 != slot_id) {
+                *out_owner = victim;
+                return slot_id;
+            }
+        }
+    }
+    return 0;
+}
+
 _SOKOL_PRIVATE void _sfetch_request_handler(_sfetch_t* ctx, uint32_t slot_id) {
     _sfetch_state_t state;
     _sfetch_path_t* path;
     _sfetch_item_thread_t* thread;
     _sfetch_buffer_t* buffer;
     uint32_t chunk_size;
-    {
-        _sfetch_item_t* item = _sfetch_pool_item_lookup(&ctx->pool, slot_id);
-        if (!item) {
-            return;
+    _sfetch_read_ahead_t* ra = 0;
+    uint64_t ra_io_end = 0;
+    _sfetch_item_t* item = _sfetch_pool_item_lookup(&ctx->pool, slot_id);
+    if (!item) {
+        return;
+    }
+    state = item->state;
+    SOKOL_ASSERT((state == _SFETCH_STATE_FETCHING) ||
+                 (state == _SFETCH_STATE_PAUSED) ||
+                 (state == _SFETCH_STATE_FAILED));
+    path = &item->path;
+    thread = &item->thread;
+    buffer = &item->buffer;
+    chunk_size = item->chunk_size;
+    if ((item->num_read_ahead_bufs > 0) && (item->lane != _SFETCH_INVALID_LANE)) {
+        ra = &ctx->chn[item->channel].read_ahead[item->lane];
+        if ((ra->slot_id != 0) && (ra->slot_id != slot_id)) {
+            /* stale state from a previous request on the same lane */
+            _sfetch_read_ahead_reset(ra);
         }
-        state = item->state;
-        SOKOL_ASSERT((state == _SFETCH_STATE_FETCHING) ||
-                     (state == _SFETCH_STATE_PAUSED) ||
-                     (state == _SFETCH_STATE_FAILED));
-        path = &item->path;
-        thread = &item->thread;
-        buffer = &item->buffer;
-        chunk_size = item->chunk_size;
     }
     if (thread->failed) {
         return;
     }
     if (state == _SFETCH_STATE_FETCHING) {
-        if ((buffer->ptr == 0) || (buffer->size == 0)) {
+        thread->io_start = _sfetch_timer_now(&ctx->timer);
+        if (item->preload) {
+            /* preload requests don't fetch any data */
+            _sfetch_file_preload(ctx, path, item->preload_offset, item->preload_size);
+        }
+        else if ((buffer->ptr == 0) || (buffer->size == 0)) {
             thread->error_code = SFETCH_ERROR_NO_BUFFER;
             thread->failed = true;
         }
@@ -1821,15 +3243,21 @@ _SOKOL_PRIVATE void _sfetch_request_handler(_sfetch_t* ctx, uint32_t slot_id) {
                 SOKOL_ASSERT(path->buf[0]);
                 SOKOL_ASSERT(thread->fetched_offset == 0);
                 SOKOL_ASSERT(thread->fetched_size == 0);
-                thread->file_handle = _sfetch_file_open(path);
+                thread->file_handle = _sfetch_file_open(ctx, path, item->direct_io);
                 if (_sfetch_file_handle_valid(thread->file_handle)) {
-                    thread->content_size = _sfetch_file_size(thread->file_handle);
+                    thread->content_size = _sfetch_file_size(ctx, thread->file_handle);
                 }
                 else {
                     thread->error_code = SFETCH_ERROR_FILE_NOT_FOUND;
                     thread->failed = true;
                 }
             }
+            if (!thread->failed && ra && (chunk_size > 0)) {
+                if (ra->slot_id != slot_id) {
+                    _sfetch_read_ahead_init(ra, slot_id, item);
+                }
+                ra->chunk_size = chunk_size;
+            }
             if (!thread->failed) {
                 uint32_t read_offset = 0;
                 uint32_t bytes_to_read = 0;
@@ -1860,9 +3288,33 @@ _SOKOL_PRIVATE void _sfetch_request_handler(_sfetch_t* ctx, uint32_t slot_id) {
                     }
                 }
                 if (!thread->failed) {
-                    if (_sfetch_file_read(thread->file_handle, read_offset, bytes_to_read, buffer->ptr)) {
+                    if (ra && (ra->slot_id == slot_id) && (ra->count > 0)) {
+                        /* the next chunk has already been read ahead, just copy it */
+                        const uint32_t index = (ra->head + ra->num_bufs - ra->count) % ra->num_bufs;
+                        const uint32_t num_bytes = ra->sizes[index];
+                        if (num_bytes <= buffer->size) {
+                            memcpy(buffer->ptr, ra->bufs[index].ptr, num_bytes);
+                            ra->count--;
+                            thread->fetched_size = num_bytes;
+                            thread->fetched_offset += num_bytes;
+                            /* the chunk size may have been adapted since the chunk was read */
+                            thread->chunk_size = ra->chunk_sizes[index];
+                            /* report the time of the actual IO operation */
+                            thread->io_start = ra->io_start[index];
+                            ra_io_end = ra->io_end[index];
+                        }
+                        else {
+                            thread->error_code = SFETCH_ERROR_BUFFER_TOO_SMALL;
+                            thread->failed = true;
+                        }
+                    }
+                    else if (_sfetch_file_read(ctx, thread->file_handle, item->direct_io, read_offset, bytes_to_read, buffer->ptr)) {
                         thread->fetched_size = bytes_to_read;
                         thread->fetched_offset += bytes_to_read;
+                        thread->chunk_size = chunk_size;
+                        if (ra && (ra->slot_id == slot_id)) {
+                            ra->read_offset = thread->fetched_offset;
+                        }
                     }
                     else {
                         thread->error_code = SFETCH_ERROR_UNEXPECTED_EOF;
@@ -1874,13 +3326,27 @@ _SOKOL_PRIVATE void _sfetch_request_handler(_sfetch_t* ctx, uint32_t slot_id) {
         SOKOL_ASSERT(thread->fetched_offset <= thread->content_size);
         if (thread->failed || (thread->fetched_offset == thread->content_size)) {
             if (_sfetch_file_handle_valid(thread->file_handle)) {
-                _sfetch_file_close(thread->file_handle);
+                _sfetch_file_close(ctx, thread->file_handle);
                 thread->file_handle = _SFETCH_INVALID_FILE_HANDLE;
             }
             thread->finished = true;
         }
+        thread->io_end = (ra_io_end > 0) ? ra_io_end : _sfetch_timer_now(&ctx->timer);
     }
-    /* ignore items in PAUSED or FAILED state */
+    else if (state == _SFETCH_STATE_FAILED) {
+        /* a cancelled request, close the file if it was opened */
+        if (_sfetch_file_handle_valid(thread->file_handle)) {
+            _sfetch_file_close(ctx, thread->file_handle);
+            thread->file_handle = _SFETCH_INVALID_FILE_HANDLE;
+        }
+    }
+    /* the request is no longer streaming, stop reading ahead, a paused request
+       returns its read-ahead buffers to the pool and starts over when continued
+    */
+    if (ra && (ra->slot_id == slot_id) && (thread->finished || (state == _SFETCH_STATE_FAILED) || (state == _SFETCH_STATE_PAUSED))) {
+        _sfetch_read_ahead_reset(ra);
+    }
+    /* ignore items in PAUSED state */
 }
 
 #if _SFETCH_PLATFORM_WINDOWS
@@ -1890,15 +3356,33 @@ _SOKOL_PRIVATE void* _sfetch_channel_thread_func(void* arg) {
 #endif
     _sfetch_channel_t* chn = (_sfetch_channel_t*) arg;
     _sfetch_thread_entered(&chn->thread);
+    const bool work_sharing = chn->ctx->desc.work_sharing;
     while (!_sfetch_thread_stop_requested(&chn->thread)) {
-        /* block until work arrives */
-        uint32_t slot_id = _sfetch_thread_dequeue_incoming(&chn->thread, &chn->thread_incoming);
+        /* block until work arrives, unless there's other work to do */
+        const bool read_ahead_pending = _sfetch_read_ahead_pending(chn);
+        uint32_t slot_id = _sfetch_thread_dequeue_incoming(&chn->thread, &chn->thread_incoming, !(read_ahead_pending || work_sharing));
         /* slot_id will be invalid if the thread was woken up to join */
         if (!_sfetch_thread_stop_requested(&chn->thread)) {
-            SOKOL_ASSERT(0 != slot_id);
-            chn->request_handler(chn->ctx, slot_id);
-            SOKOL_ASSERT(!_sfetch_ring_full(&chn->thread_outgoing));
-            _sfetch_thread_enqueue_outgoing(&chn->thread, &chn->thread_outgoing, slot_id);
+            _sfetch_channel_t* owner = chn;
+            if ((0 == slot_id) && !read_ahead_pending && work_sharing) {
+                /* no own work, try to help out other channels */
+                slot_id = _sfetch_channel_steal(chn, &owner);
+                if (0 == slot_id) {
+                    slot_id = _sfetch_thread_dequeue_incoming(&chn->thread, &chn->thread_incoming, true);
+                    if ((0 == slot_id) || _sfetch_thread_stop_requested(&chn->thread)) {
+                        /* woken up to join, or to look for work on other channels */
+                        continue;
+                    }
+                }
+            }
+            if (0 != slot_id) {
+                owner->request_handler(owner->ctx, slot_id);
+                _sfetch_thread_enqueue_outgoing(&owner->thread, &owner->thread_outgoing, slot_id);
+            }
+            else {
+                /* no incoming requests, use the idle time to read ahead */
+                _sfetch_read_ahead_step(chn);
+            }
         }
     }
     _sfetch_thread_leaving(&chn->thread);
@@ -2003,8 +3487,10 @@ EMSCRIPTEN_KEEPALIVE void _sfetch_emsc_get_response(uint32_t slot_id, uint32_t r
     if (ctx && ctx->valid) {
         _sfetch_item_t* item = _sfetch_pool_item_lookup(&ctx->pool, slot_id);
         if (item) {
+            item->thread.io_end = _sfetch_timer_now(&ctx->timer);
             item->thread.fetched_size = content_fetched_size;
             item->thread.fetched_offset += content_fetched_size;
+            item->thread.chunk_size = item->chunk_size;
             item->thread.http_range_offset += range_fetched_size;
             if (item->chunk_size == 0) {
                 item->thread.finished = true;
@@ -2029,6 +3515,7 @@ EMSCRIPTEN_KEEPALIVE void _sfetch_emsc_failed_http_status(uint32_t slot_id, uint
             else {
                 item->thread.error_code = SFETCH_ERROR_INVALID_HTTP_STATUS;
             }
+            item->thread.io_end = _sfetch_timer_now(&ctx->timer);
             item->thread.failed = true;
             item->thread.finished = true;
             _sfetch_ring_enqueue(&ctx->chn[item->channel].user_outgoing, slot_id);
@@ -2042,6 +3529,7 @@ EMSCRIPTEN_KEEPALIVE void _sfetch_emsc_failed_buffer_too_small(uint32_t slot_id)
         _sfetch_item_t* item = _sfetch_pool_item_lookup(&ctx->pool, slot_id);
         if (item) {
             item->thread.error_code = SFETCH_ERROR_BUFFER_TOO_SMALL;
+            item->thread.io_end = _sfetch_timer_now(&ctx->timer);
             item->thread.failed = true;
             item->thread.finished = true;
             _sfetch_ring_enqueue(&ctx->chn[item->channel].user_outgoing, slot_id);
@@ -2059,6 +3547,8 @@ _SOKOL_PRIVATE void _sfetch_request_handler(_sfetch_t* ctx, uint32_t slot_id) {
         return;
     }
     if (item->state == _SFETCH_STATE_FETCHING) {
+        item->thread.io_start = _sfetch_timer_now(&ctx->timer);
+        item->thread.io_end = 0;
         if ((item->chunk_size > 0) && (item->thread.content_size == 0)) {
             /* if streaming download is requested, and the content-length isn't known
                yet, need to send a HEAD request first
@@ -2089,9 +3579,14 @@ _SOKOL_PRIVATE void _sfetch_channel_discard(_sfetch_channel_t* chn) {
     #if _SFETCH_HAS_THREADS
         if (chn->valid) {
             _sfetch_thread_join(&chn->thread);
+            _sfetch_thread_discard(&chn->thread);
         }
         _sfetch_ring_discard(&chn->thread_incoming);
         _sfetch_ring_discard(&chn->thread_outgoing);
+        if (chn->read_ahead) {
+            SOKOL_FREE(chn->read_ahead);
+            chn->read_ahead = 0;
+        }
     #endif
     _sfetch_ring_discard(&chn->free_lanes);
     _sfetch_ring_discard(&chn->user_sent);
@@ -2117,12 +3612,22 @@ _SOKOL_PRIVATE bool _sfetch_channel_init(_sfetch_channel_t* chn, _sfetch_t* ctx,
     #if _SFETCH_HAS_THREADS
         valid &= _sfetch_ring_init(&chn->thread_incoming, num_lanes);
         valid &= _sfetch_ring_init(&chn->thread_outgoing, num_lanes);
+        chn->num_lanes = num_lanes;
+        chn->read_ahead = (_sfetch_read_ahead_t*) SOKOL_MALLOC(num_lanes * sizeof(_sfetch_read_ahead_t));
+        if (chn->read_ahead) {
+            for (uint32_t lane = 0; lane < num_lanes; lane++) {
+                _sfetch_read_ahead_reset(&chn->read_ahead[lane]);
+            }
+        }
+        else {
+            valid = false;
+        }
     #endif
     if (valid) {
-        chn->valid = true;
         #if _SFETCH_HAS_THREADS
-        _sfetch_thread_init(&chn->thread, _sfetch_channel_thread_func, chn);
+        _sfetch_thread_init(&chn->thread);
         #endif
+        chn->valid = true;
         return true;
     }
     else {
@@ -2138,6 +3643,10 @@ _SOKOL_PRIVATE bool _sfetch_channel_send(_sfetch_channel_t* chn, uint32_t slot_i
     SOKOL_ASSERT(chn && chn->valid);
     if (!_sfetch_ring_full(&chn->user_sent)) {
         _sfetch_ring_enqueue(&chn->user_sent, slot_id);
+        const uint32_t queue_depth = _sfetch_ring_count(&chn->user_sent);
+        if (queue_depth > chn->stats.max_queue_depth) {
+            chn->stats.max_queue_depth = queue_depth;
+        }
         return true;
     }
     else {
@@ -2146,7 +3655,20 @@ _SOKOL_PRIVATE bool _sfetch_channel_send(_sfetch_channel_t* chn, uint32_t slot_i
     }
 }
 
-_SOKOL_PRIVATE void _sfetch_invoke_response_callback(_sfetch_item_t* item) {
+/* put an array of requests into the channel's sent-queue at once, the
+   caller must check that the queue has enough free space
+*/
+_SOKOL_PRIVATE void _sfetch_channel_send_n(_sfetch_channel_t* chn, const uint32_t* slot_ids, uint32_t num) {
+    SOKOL_ASSERT(chn && chn->valid);
+    _sfetch_ring_enqueue_n(&chn->user_sent, slot_ids, num);
+    const uint32_t queue_depth = _sfetch_ring_count(&chn->user_sent);
+    if (queue_depth > chn->stats.max_queue_depth) {
+        chn->stats.max_queue_depth = queue_depth;
+    }
+}
+
+_SOKOL_PRIVATE void _sfetch_invoke_response_callback(_sfetch_item_t* item, uint64_t now) {
+    item->user.timings.callback = now;
     sfetch_response_t response;
     memset(&response, 0, sizeof(response));
     response.handle = item->handle;
@@ -2163,28 +3685,155 @@ _SOKOL_PRIVATE void _sfetch_invoke_response_callback(_sfetch_item_t* item) {
     response.user_data = item->user.user_data;
     response.fetched_offset = item->user.fetched_offset - item->user.fetched_size;
     response.fetched_size = item->user.fetched_size;
+    /* a fetched chunk reports the size it was read with, which may differ
+       from the current chunk size with adaptive chunk sizes and read-ahead
+    */
+    response.chunk_size = response.fetched ? item->user.chunk_size : item->chunk_size;
     response.buffer_ptr = item->buffer.ptr;
     response.buffer_size = item->buffer.size;
+    response.buffer_pooled = item->buffer_pooled;
+    response.timings = item->user.timings;
     item->callback(&response);
 }
 
+/* compute the next chunk size of an adaptive streaming request from the
+   channel's recently measured IO throughput and the per-chunk target latency
+*/
+_SOKOL_PRIVATE uint32_t _sfetch_adaptive_chunk_size(const _sfetch_channel_t* chn, const _sfetch_item_t* item) {
+    SOKOL_ASSERT(item->max_chunk_size > 0);
+    const uint64_t bytes_per_sec = chn->stats.io_bytes_per_sec;
+    if (0 == bytes_per_sec) {
+        /* no measurements yet */
+        return item->chunk_size;
+    }
+    uint64_t size = (bytes_per_sec * item->chunk_latency) / 1000000000;
+    /* keep big chunks a multiple of 4 KBytes */
+    if (size > 4096) {
+        size &= ~(uint64_t)4095;
+    }
+    if (size < item->min_chunk_size) {
+        size = item->min_chunk_size;
+    }
+    if (size > item->max_chunk_size) {
+        size = item->max_chunk_size;
+    }
+    if ((item->buffer.size > 0) && (size > item->buffer.size)) {
+        size = item->buffer.size;
+    }
+    return (uint32_t)size;
+}
+
+/* update channel statistics when a request has finished */
+_SOKOL_PRIVATE void _sfetch_channel_stats_finished(_sfetch_channel_t* chn, const _sfetch_item_t* item, uint64_t now) {
+    sfetch_channel_stats_t* stats = &chn->stats;
+    stats->num_finished++;
+    if (item->state == _SFETCH_STATE_FAILED) {
+        stats->num_failed++;
+    }
+    const uint64_t latency_ms = (now - item->user.timings.sent) / 1000000;
+    int bucket = 0;
+    while ((bucket < (SFETCH_NUM_LATENCY_BUCKETS-1)) && (((uint64_t)1<<bucket) <= latency_ms)) {
+        bucket++;
+    }
+    stats->latency_histogram[bucket]++;
+}
+
+/* update channel statistics when a chunk of data has been fetched */
+_SOKOL_PRIVATE void _sfetch_channel_stats_fetched(_sfetch_channel_t* chn, const _sfetch_item_t* item) {
+    sfetch_channel_stats_t* stats = &chn->stats;
+    const uint64_t io_start = item->user.timings.io_start;
+    const uint64_t io_end = item->user.timings.io_end;
+    stats->bytes_fetched += item->user.fetched_size;
+    if ((io_start > 0) && (io_end > io_start)) {
+        const uint64_t io_time = io_end - io_start;
+        stats->io_time += io_time;
+        if (item->user.fetched_size > 0) {
+            const uint64_t bytes_per_sec = ((uint64_t)item->user.fetched_size * 1000000000) / io_time;
+            if (0 == stats->io_bytes_per_sec) {
+                stats->io_bytes_per_sec = bytes_per_sec;
+            }
+            else {
+                /* exponential moving average over roughly the last 8 IO operations */
+                stats->io_bytes_per_sec = stats->io_bytes_per_sec - (stats->io_bytes_per_sec / 8) + (bytes_per_sec / 8);
+            }
+        }
+    }
+}
+
+#if _SFETCH_HAS_THREADS
+/* grab as many read-ahead buffers as requested and spare in the buffer pool */
+_SOKOL_PRIVATE void _sfetch_read_ahead_acquire(_sfetch_item_t* item, _sfetch_buffer_pool_t* buffers) {
+    if (item->read_ahead > 0) {
+        const uint32_t buf_size = (item->max_chunk_size > item->chunk_size) ? item->max_chunk_size : item->chunk_size;
+        while ((item->num_read_ahead_bufs < item->read_ahead) &&
+               _sfetch_buffer_pool_alloc_spare(buffers, buf_size, &item->read_ahead_bufs[item->num_read_ahead_bufs]))
+        {
+            item->num_read_ahead_bufs++;
+        }
+    }
+}
+#endif
+
+/* return the read-ahead buffers to the pool, the IO thread must be done with them */
+_SOKOL_PRIVATE void _sfetch_read_ahead_release(_sfetch_item_t* item, _sfetch_buffer_pool_t* buffers) {
+    for (uint32_t i = 0; i < item->num_read_ahead_bufs; i++) {
+        _sfetch_buffer_pool_free(buffers, item->read_ahead_bufs[i].ptr);
+    }
+    item->num_read_ahead_bufs = 0;
+}
+
 /* per-frame channel stuff: move requests in and out of the IO threads, call response callbacks */
-_SOKOL_PRIVATE void _sfetch_channel_dowork(_sfetch_channel_t* chn, _sfetch_pool_t* pool) {
+_SOKOL_PRIVATE void _sfetch_channel_dowork(_sfetch_channel_t* chn, _sfetch_pool_t* pool, _sfetch_buffer_pool_t* buffers) {
+    const _sfetch_timer_t* timer = &chn->ctx->timer;
 
-    /* move items from sent- to incoming-queue permitting free lanes */
+    /* move items from sent- to incoming-queue permitting free lanes (and pooled buffers),
+       requests which need to wait for a pooled buffer are rotated to the back of
+       the sent-queue so that they don't block the requests behind them
+    */
     const uint32_t num_sent = _sfetch_ring_count(&chn->user_sent);
-    const uint32_t avail_lanes = _sfetch_ring_count(&chn->free_lanes);
-    const uint32_t num_move = (num_sent < avail_lanes) ? num_sent : avail_lanes;
-    for (uint32_t i = 0; i < num_move; i++) {
+    uint32_t num_rotated = 0;
+    for (uint32_t i = 0; i < num_sent; i++) {
+        const bool lane_avail = !_sfetch_ring_empty(&chn->free_lanes);
+        if (!lane_avail && (0 == num_rotated)) {
+            /* nothing more to dispatch, and the queue order is still intact */
+            break;
+        }
         const uint32_t slot_id = _sfetch_ring_dequeue(&chn->user_sent);
         _sfetch_item_t* item = _sfetch_pool_item_lookup(pool, slot_id);
         SOKOL_ASSERT(item);
         SOKOL_ASSERT(item->state == _SFETCH_STATE_ALLOCATED);
+        /* cancelled requests don't need a buffer, they only need to be retired */
+        const bool cancelled = item->user.cancel;
+        bool dispatch = lane_avail;
+        if (dispatch && (item->pool_buffer_size > 0) && !cancelled && _sfetch_buffer_pool_valid(buffers)) {
+            if (_sfetch_buffer_pool_alloc(buffers, item->pool_buffer_size, &item->buffer)) {
+                item->pool_buffer_size = 0;
+                item->buffer_pooled = true;
+            }
+            else {
+                /* all matching pooled buffers in use, keep waiting in the sent-queue */
+                dispatch = false;
+            }
+        }
+        if (!dispatch) {
+            /* rotating all remaining items after the first waiting item keeps them in order */
+            _sfetch_ring_enqueue(&chn->user_sent, slot_id);
+            num_rotated++;
+            continue;
+        }
+        #if _SFETCH_HAS_THREADS
+        if (!cancelled) {
+            _sfetch_read_ahead_acquire(item, buffers);
+        }
+        #endif
         item->state = _SFETCH_STATE_DISPATCHED;
         item->lane = _sfetch_ring_dequeue(&chn->free_lanes);
+        item->user.timings.dispatched = _sfetch_timer_now(timer);
+        chn->stats.num_dispatched++;
+        chn->stats.queue_time += item->user.timings.dispatched - item->user.timings.sent;
         /* if no buffer provided yet, invoke response callback to do so */
-        if (0 == item->buffer.ptr) {
-            _sfetch_invoke_response_callback(item);
+        if ((0 == item->buffer.ptr) && !cancelled) {
+            _sfetch_invoke_response_callback(item, item->user.timings.dispatched);
         }
         _sfetch_ring_enqueue(&chn->user_incoming, slot_id);
     }
@@ -2205,6 +3854,10 @@ _SOKOL_PRIVATE void _sfetch_channel_dowork(_sfetch_channel_t* chn, _sfetch_pool_
         if (item->user.cont) {
             if (item->state == _SFETCH_STATE_PAUSED) {
                 item->state = _SFETCH_STATE_FETCHED;
+                #if _SFETCH_HAS_THREADS
+                /* the read-ahead buffers were returned when the request was paused */
+                _sfetch_read_ahead_acquire(item, buffers);
+                #endif
             }
             item->user.cont = false;
         }
@@ -2216,6 +3869,9 @@ _SOKOL_PRIVATE void _sfetch_channel_dowork(_sfetch_channel_t* chn, _sfetch_pool_
             case _SFETCH_STATE_DISPATCHED:
             case _SFETCH_STATE_FETCHED:
                 item->state = _SFETCH_STATE_FETCHING;
+                if (item->max_chunk_size > 0) {
+                    item->chunk_size = _sfetch_adaptive_chunk_size(chn, item);
+                }
                 break;
             default: break;
         }
@@ -2223,7 +3879,22 @@ _SOKOL_PRIVATE void _sfetch_channel_dowork(_sfetch_channel_t* chn, _sfetch_pool_
 
     #if _SFETCH_HAS_THREADS
         /* move new items into the IO threads and processed items out of IO threads */
-        _sfetch_thread_enqueue_incoming(&chn->thread, &chn->thread_incoming, &chn->user_incoming);
+        const uint32_t num_waiting = _sfetch_thread_enqueue_incoming(&chn->thread, &chn->thread_incoming, &chn->user_incoming);
+        if ((num_waiting > 0) && chn->ctx->desc.work_sharing) {
+            /* wake up one idle thread of another channel to pick up work, a woken
+               thread keeps taking requests from other channels until it runs out
+               of work, so more threads are only woken if items are still waiting
+               in the next call
+            */
+            const uint32_t num_channels = chn->ctx->desc.num_channels;
+            const uint32_t chn_index = (uint32_t)(chn - chn->ctx->chn);
+            for (uint32_t i = 1; i < num_channels; i++) {
+                _sfetch_channel_t* other = &chn->ctx->chn[(chn_index + i) % num_channels];
+                if (other->valid && _sfetch_thread_wakeup_idle(&other->thread)) {
+                    break;
+                }
+            }
+        }
         _sfetch_thread_dequeue_outgoing(&chn->thread, &chn->thread_outgoing, &chn->user_outgoing);
     #else
         /* without threading just directly dequeue items from the user_incoming queue and
@@ -2251,6 +3922,9 @@ _SOKOL_PRIVATE void _sfetch_channel_dowork(_sfetch_channel_t* chn, _sfetch_pool_
         /* transfer output params from thread- to user-data */
         item->user.fetched_offset = item->thread.fetched_offset;
         item->user.fetched_size = item->thread.fetched_size;
+        item->user.chunk_size = item->thread.chunk_size;
+        item->user.timings.io_start = item->thread.io_start;
+        item->user.timings.io_end = item->thread.io_end;
         if (item->user.cancel) {
             item->user.error_code = SFETCH_ERROR_CANCELLED;
         }
@@ -2264,16 +3938,34 @@ _SOKOL_PRIVATE void _sfetch_channel_dowork(_sfetch_channel_t* chn, _sfetch_pool_
         if (item->thread.failed) {
             item->state = _SFETCH_STATE_FAILED;
         }
+        else if (item->state == _SFETCH_STATE_PAUSED) {
+            /* the IO thread has dropped the read-ahead state of the paused
+               request, so the read-ahead buffers can go back to the pool
+            */
+            _sfetch_read_ahead_release(item, buffers);
+        }
         else if (item->state == _SFETCH_STATE_FETCHING) {
             item->state = _SFETCH_STATE_FETCHED;
+            _sfetch_channel_stats_fetched(chn, item);
+            if (!item->preload && (item->user.fetched_size > 0)) {
+                _sfetch_access_log_record(&chn->ctx->access_log, item, item->user.fetched_offset - item->user.fetched_size, item->user.fetched_size);
+            }
         }
-        _sfetch_invoke_response_callback(item);
+        const uint64_t now = _sfetch_timer_now(timer);
+        if (item->user.finished) {
+            _sfetch_channel_stats_finished(chn, item, now);
+        }
+        _sfetch_invoke_response_callback(item, now);
 
         /* when the request is finish, free the lane for another request,
            otherwise feed it back into the incoming queue
         */
         if (item->user.finished) {
             _sfetch_ring_enqueue(&chn->free_lanes, item->lane);
+            if (item->buffer_pooled) {
+                _sfetch_buffer_pool_free(buffers, item->buffer.ptr);
+            }
+            _sfetch_read_ahead_release(item, buffers);
             _sfetch_pool_item_free(pool, slot_id);
         }
         else {
@@ -2305,6 +3997,28 @@ _SOKOL_PRIVATE bool _sfetch_validate_request(_sfetch_t* ctx, const sfetch_reques
             SOKOL_LOG("_sfetch_validate_request: request.stream_size is greater request.buffer_size)");
             return false;
         }
+        if (req->max_chunk_size > 0) {
+            if ((req->min_chunk_size == 0) || (req->min_chunk_size > req->max_chunk_size)) {
+                SOKOL_LOG("_sfetch_validate_request: request.min_chunk_size must be > 0 and <= request.max_chunk_size");
+                return false;
+            }
+            if (req->max_chunk_size > req->buffer_size) {
+                SOKOL_LOG("_sfetch_validate_request: request.max_chunk_size is greater request.buffer_size");
+                return false;
+            }
+            if ((req->chunk_size > 0) && ((req->chunk_size < req->min_chunk_size) || (req->chunk_size > req->max_chunk_size))) {
+                SOKOL_LOG("_sfetch_validate_request: request.chunk_size must be between request.min_chunk_size and request.max_chunk_size");
+                return false;
+            }
+        }
+        else if ((req->min_chunk_size > 0) || (req->chunk_latency_ms > 0)) {
+            SOKOL_LOG("_sfetch_validate_request: request.min_chunk_size or request.chunk_latency_ms set without request.max_chunk_size");
+            return false;
+        }
+        if ((req->read_ahead > 0) && (req->chunk_size == 0) && (req->max_chunk_size == 0)) {
+            SOKOL_LOG("_sfetch_validate_request: request.read_ahead requires streaming (request.chunk_size or request.max_chunk_size)");
+            return false;
+        }
         if (req->user_data_ptr && (req->user_data_size == 0)) {
             SOKOL_LOG("_sfetch_validate_request: request.user_data_ptr is set, but req.user_data_size is null");
             return false;
@@ -2324,6 +4038,119 @@ _SOKOL_PRIVATE bool _sfetch_validate_request(_sfetch_t* ctx, const sfetch_reques
     return true;
 }
 
+/* validate a request and check that its buffer can be obtained */
+_SOKOL_PRIVATE bool _sfetch_check_request(_sfetch_t* ctx, const sfetch_request_t* request) {
+    SOKOL_ASSERT(request && (request->_start_canary == 0) && (request->_end_canary == 0));
+    if (!_sfetch_validate_request(ctx, request)) {
+        return false;
+    }
+    SOKOL_ASSERT(request->channel < ctx->desc.num_channels);
+    if (!request->buffer_ptr && (request->buffer_size > 0) && _sfetch_buffer_pool_valid(&ctx->buffers) && !_sfetch_buffer_pool_fits(&ctx->buffers, request->buffer_size)) {
+        SOKOL_LOG("sfetch_send: no buffer pool size class big enough for request.buffer_size");
+        return false;
+    }
+    if ((request->read_ahead > 0) && !_sfetch_buffer_pool_valid(&ctx->buffers)) {
+        SOKOL_LOG("sfetch_send: request.read_ahead is ignored without a buffer pool (see sfetch_desc_t.buffer_pool)");
+    }
+    return true;
+}
+
+/* allocate a request item and put it into its channel's sent-queue, returns 0 on error */
+_SOKOL_PRIVATE uint32_t _sfetch_send(_sfetch_t* ctx, const sfetch_request_t* request, uint64_t now) {
+    SOKOL_ASSERT(ctx && ctx->valid);
+    if (!_sfetch_check_request(ctx, request)) {
+        return 0;
+    }
+    const uint32_t slot_id = _sfetch_pool_item_alloc(&ctx->pool, request);
+    if (0 == slot_id) {
+        SOKOL_LOG("sfetch_send: request pool exhausted (too many active requests)");
+        return 0;
+    }
+    _sfetch_pool_item_at(&ctx->pool, slot_id)->user.timings.sent = now;
+    if (!_sfetch_channel_send(&ctx->chn[request->channel], slot_id)) {
+        /* send failed because the channels sent-queue overflowed */
+        _sfetch_pool_item_free(&ctx->pool, slot_id);
+        return 0;
+    }
+    return slot_id;
+}
+
+/* send up to _SFETCH_SEND_BATCH_CHUNK requests at once: all requests are
+   validated first, then the pool slots for the accepted requests are
+   reserved in one go, and the slot ids are grouped by channel so that
+   each channel's sent-queue is only touched once, returns the number of
+   requests sent
+*/
+_SOKOL_PRIVATE uint32_t _sfetch_send_chunk(_sfetch_t* ctx, const sfetch_request_t* requests, uint32_t num, sfetch_handle_t* out_handles, uint64_t now) {
+    SOKOL_ASSERT(ctx && ctx->valid);
+    SOKOL_ASSERT(requests && (num <= _SFETCH_SEND_BATCH_CHUNK));
+    const uint32_t num_channels = ctx->desc.num_channels;
+    uint32_t chn_free[SFETCH_MAX_CHANNELS];
+    uint32_t chn_counts[SFETCH_MAX_CHANNELS];
+    for (uint32_t chn_index = 0; chn_index < num_channels; chn_index++) {
+        chn_free[chn_index] = _sfetch_ring_num_free(&ctx->chn[chn_index].user_sent);
+        chn_counts[chn_index] = 0;
+    }
+
+    /* validate the requests and check for free request items and queue space */
+    bool accepted[_SFETCH_SEND_BATCH_CHUNK];
+    uint32_t num_accepted = 0;
+    for (uint32_t i = 0; i < num; i++) {
+        const sfetch_request_t* req = &requests[i];
+        accepted[i] = false;
+        if (!_sfetch_check_request(ctx, req)) {
+            continue;
+        }
+        if (num_accepted >= ctx->pool.free_top) {
+            SOKOL_LOG("sfetch_send_batch: request pool exhausted (too many active requests)");
+            continue;
+        }
+        if (chn_counts[req->channel] >= chn_free[req->channel]) {
+            SOKOL_LOG("sfetch_send_batch: user_sent queue is full");
+            continue;
+        }
+        chn_counts[req->channel]++;
+        num_accepted++;
+        accepted[i] = true;
+    }
+
+    /* reserve the request items for all accepted requests */
+    uint32_t slot_indices[_SFETCH_SEND_BATCH_CHUNK];
+    _sfetch_pool_reserve(&ctx->pool, num_accepted, slot_indices);
+
+    /* initialize the request items, and sort their slot ids by channel */
+    uint32_t chn_offsets[SFETCH_MAX_CHANNELS];
+    uint32_t offset = 0;
+    for (uint32_t chn_index = 0; chn_index < num_channels; chn_index++) {
+        chn_offsets[chn_index] = offset;
+        offset += chn_counts[chn_index];
+    }
+    uint32_t slot_ids[_SFETCH_SEND_BATCH_CHUNK];
+    uint32_t next_slot = 0;
+    for (uint32_t i = 0; i < num; i++) {
+        uint32_t slot_id = 0;
+        if (accepted[i]) {
+            slot_id = _sfetch_pool_item_init_at(&ctx->pool, slot_indices[next_slot++], &requests[i]);
+            _sfetch_pool_item_at(&ctx->pool, slot_id)->user.timings.sent = now;
+            slot_ids[chn_offsets[requests[i].channel]++] = slot_id;
+        }
+        if (out_handles) {
+            out_handles[i] = _sfetch_make_handle(slot_id);
+        }
+    }
+    SOKOL_ASSERT(next_slot == num_accepted);
+
+    /* push each channel's group of requests into its sent-queue */
+    offset = 0;
+    for (uint32_t chn_index = 0; chn_index < num_channels; chn_index++) {
+        if (chn_counts[chn_index] > 0) {
+            _sfetch_channel_send_n(&ctx->chn[chn_index], &slot_ids[offset], chn_counts[chn_index]);
+            offset += chn_counts[chn_index];
+        }
+    }
+    return num_accepted;
+}
+
 /*=== PUBLIC API FUNCTIONS ===================================================*/
 SOKOL_API_IMPL void sfetch_setup(const sfetch_desc_t* desc) {
     SOKOL_ASSERT(desc);
@@ -2336,6 +4163,7 @@ SOKOL_API_IMPL void sfetch_setup(const sfetch_desc_t* desc) {
     ctx->desc = *desc;
     ctx->setup = true;
     ctx->valid = true;
+    _sfetch_timer_init(&ctx->timer);
 
     /* replace zero-init items with default values */
     ctx->desc.max_requests = _sfetch_def(ctx->desc.max_requests, 128);
@@ -2349,23 +4177,77 @@ SOKOL_API_IMPL void sfetch_setup(const sfetch_desc_t* desc) {
     /* setup the global request item pool */
     ctx->valid &= _sfetch_pool_init(&ctx->pool, ctx->desc.max_requests);
 
+    /* setup the optional buffer pool */
+    ctx->valid &= _sfetch_buffer_pool_init(&ctx->buffers, ctx->desc.buffer_pool);
+
+    /* setup the optional access log */
+    ctx->valid &= _sfetch_access_log_init(&ctx->access_log, ctx->desc.access_log_size);
+
+    /* use the platform's file functions unless the user provided a file backend */
+    #if _SFETCH_HAS_THREADS
+    const sfetch_file_backend_t* fb = &ctx->desc.file_backend;
+    if (fb->open_cb || fb->close_cb || fb->size_cb || fb->read_cb) {
+        SOKOL_ASSERT(fb->open_cb && fb->close_cb && fb->size_cb && fb->read_cb);
+        ctx->file_backend = *fb;
+    }
+    else {
+        ctx->file_backend.open_cb = _sfetch_native_file_open;
+        ctx->file_backend.close_cb = _sfetch_native_file_close;
+        ctx->file_backend.size_cb = _sfetch_native_file_size;
+        ctx->file_backend.read_cb = _sfetch_native_file_read;
+        ctx->file_backend.user_data = 0;
+    }
+    #endif
+
     /* setup IO channels (one thread per channel) */
     for (uint32_t i = 0; i < ctx->desc.num_channels; i++) {
         ctx->valid &= _sfetch_channel_init(&ctx->chn[i], ctx, ctx->desc.max_requests, ctx->desc.num_lanes, _sfetch_request_handler);
     }
+    #if _SFETCH_HAS_THREADS
+    /* only start the IO threads once all channels are initialized,
+       with work sharing a thread may look into any other channel
+    */
+    for (uint32_t i = 0; i < ctx->desc.num_channels; i++) {
+        if (ctx->chn[i].valid && !_sfetch_thread_start(&ctx->chn[i].thread, _sfetch_channel_thread_func, &ctx->chn[i])) {
+            SOKOL_LOG("sfetch_setup: failed to start IO thread");
+            /* stop the threads which are already running (they may look into the
+               failed channel in work-sharing mode) before discarding the channel
+            */
+            for (uint32_t j = 0; j < i; j++) {
+                if (ctx->chn[j].valid) {
+                    _sfetch_thread_join(&ctx->chn[j].thread);
+                }
+            }
+            _sfetch_channel_discard(&ctx->chn[i]);
+            ctx->valid = false;
+            break;
+        }
+    }
+    #endif
 }
 
 SOKOL_API_IMPL void sfetch_shutdown(void) {
     _sfetch_t* ctx = _sfetch_ctx();
     SOKOL_ASSERT(ctx && ctx->setup);
     ctx->valid = false;
-    /* IO threads must be shutdown first */
+    /* IO threads must be shutdown first (all of them before any channel
+       is destroyed, since threads may access other channels in work-sharing mode)
+    */
+    #if _SFETCH_HAS_THREADS
+    for (uint32_t i = 0; i < ctx->desc.num_channels; i++) {
+        if (ctx->chn[i].valid) {
+            _sfetch_thread_join(&ctx->chn[i].thread);
+        }
+    }
+    #endif
     for (uint32_t i = 0; i < ctx->desc.num_channels; i++) {
         if (ctx->chn[i].valid) {
             _sfetch_channel_discard(&ctx->chn[i]);
         }
     }
     _sfetch_pool_discard(&ctx->pool);
+    _sfetch_buffer_pool_discard(&ctx->buffers);
+    _sfetch_access_log_discard(&ctx->access_log);
     ctx->setup = false;
     SOKOL_FREE(ctx);
     _sfetch = 0;
@@ -2403,28 +4285,32 @@ SOKOL_API_IMPL bool sfetch_handle_valid(sfetch_handle_t h) {
 SOKOL_API_IMPL sfetch_handle_t sfetch_send(const sfetch_request_t* request) {
     _sfetch_t* ctx = _sfetch_ctx();
     SOKOL_ASSERT(ctx && ctx->setup);
-    SOKOL_ASSERT(request && (request->_start_canary == 0) && (request->_end_canary == 0));
-
-    const sfetch_handle_t invalid_handle = _sfetch_make_handle(0);
+    SOKOL_ASSERT(request);
     if (!ctx->valid) {
-        return invalid_handle;
-    }
-    if (!_sfetch_validate_request(ctx, request)) {
-        return invalid_handle;
+        return _sfetch_make_handle(0);
     }
-    SOKOL_ASSERT(request->channel < ctx->desc.num_channels);
+    return _sfetch_make_handle(_sfetch_send(ctx, request, _sfetch_timer_now(&ctx->timer)));
+}
 
-    uint32_t slot_id = _sfetch_pool_item_alloc(&ctx->pool, request);
-    if (0 == slot_id) {
-        SOKOL_LOG("sfetch_send: request pool exhausted (too many active requests)");
-        return invalid_handle;
+SOKOL_API_IMPL int sfetch_send_batch(const sfetch_request_t* requests, int num_requests, sfetch_handle_t* out_handles) {
+    _sfetch_t* ctx = _sfetch_ctx();
+    SOKOL_ASSERT(ctx && ctx->setup);
+    SOKOL_ASSERT(requests && (num_requests >= 0));
+    if (!ctx->valid) {
+        if (out_handles) {
+            memset(out_handles, 0, (size_t)num_requests * sizeof(sfetch_handle_t));
+        }
+        return 0;
     }
-    if (!_sfetch_channel_send(&ctx->chn[request->channel], slot_id)) {
-        /* send failed because the channels sent-queue overflowed */
-        _sfetch_pool_item_free(&ctx->pool, slot_id);
-        return invalid_handle;
+    /* all requests in a batch share the same 'sent' timestamp */
+    const uint64_t now = _sfetch_timer_now(&ctx->timer);
+    int num_sent = 0;
+    for (int base = 0; base < num_requests; base += _SFETCH_SEND_BATCH_CHUNK) {
+        const int num_left = num_requests - base;
+        const int num = (num_left < _SFETCH_SEND_BATCH_CHUNK) ? num_left : _SFETCH_SEND_BATCH_CHUNK;
+        num_sent += (int) _sfetch_send_chunk(ctx, &requests[base], (uint32_t)num, out_handles ? &out_handles[base] : 0, now);
     }
-    return _sfetch_make_handle(slot_id);
+    return num_sent;
 }
 
 SOKOL_API_IMPL void sfetch_dowork(void) {
@@ -2440,7 +4326,7 @@ SOKOL_API_IMPL void sfetch_dowork(void) {
     ctx->in_callback = true;
     for (int pass = 0; pass < 2; pass++) {
         for (uint32_t chn_index = 0; chn_index < ctx->desc.num_channels; chn_index++) {
-            _sfetch_channel_dowork(&ctx->chn[chn_index], &ctx->pool);
+            _sfetch_channel_dowork(&ctx->chn[chn_index], &ctx->pool, &ctx->buffers);
         }
     }
     ctx->in_callback = false;
@@ -2455,6 +4341,7 @@ SOKOL_API_IMPL void sfetch_bind_buffer(sfetch_handle_t h, void* buffer_ptr, uint
         SOKOL_ASSERT((0 == item->buffer.ptr) && (0 == item->buffer.size));
         item->buffer.ptr = (uint8_t*) buffer_ptr;
         item->buffer.size = buffer_size;
+        item->buffer_pooled = false;
     }
 }
 
@@ -2465,6 +4352,13 @@ SOKOL_API_IMPL void* sfetch_unbind_buffer(sfetch_handle_t h) {
     _sfetch_item_t* item = _sfetch_pool_item_lookup(&ctx->pool, h.id);
     if (item) {
         void* prev_buf_ptr = item->buffer.ptr;
+        if (item->buffer_pooled) {
+            /* pooled buffers go straight back into the pool, but remain valid
+               until the response callback returns
+            */
+            _sfetch_buffer_pool_free(&ctx->buffers, item->buffer.ptr);
+            item->buffer_pooled = false;
+        }
         item->buffer.ptr = 0;
         item->buffer.size = 0;
         return prev_buf_ptr;
@@ -2505,5 +4399,77 @@ SOKOL_API_IMPL void sfetch_cancel(sfetch_handle_t h) {
     }
 }
 
-#endif /* SOKOL_IMPL */
+SOKOL_API_IMPL sfetch_channel_stats_t sfetch_query_stats(uint32_t channel) {
+    _sfetch_t* ctx = _sfetch_ctx();
+    SOKOL_ASSERT(ctx && ctx->valid);
+    SOKOL_ASSERT(channel < ctx->desc.num_channels);
+    const _sfetch_channel_t* chn = &ctx->chn[channel];
+    sfetch_channel_stats_t stats = chn->stats;
+    stats.queue_depth = _sfetch_ring_count(&chn->user_sent);
+    stats.num_inflight = ctx->desc.num_lanes - _sfetch_ring_count(&chn->free_lanes);
+    stats.bytes_per_sec = (stats.bytes_fetched * 1000) / ((_sfetch_timer_now(&ctx->timer) / 1000000) + 1);
+    return stats;
+}
 
+SOKOL_API_IMPL int sfetch_query_access_log(sfetch_access_log_entry_t* out_entries, int max_entries) {
+    _sfetch_t* ctx = _sfetch_ctx();
+    SOKOL_ASSERT(ctx && ctx->setup);
+    SOKOL_ASSERT(out_entries || (0 == max_entries));
+    if (!ctx->valid) {
+        return 0;
+    }
+    const _sfetch_access_log_t* log = &ctx->access_log;
+    uint64_t pos = (log->num_recorded > log->size) ? (log->num_recorded - log->size) : 0;
+    int num_entries = 0;
+    while ((pos < log->num_recorded) && (num_entries < max_entries)) {
+        const _sfetch_access_log_entry_t* src = &log->entries[pos % log->size];
+        sfetch_access_log_entry_t* dst = &out_entries[num_entries++];
+        dst->path = src->path.buf;
+        dst->offset = src->offset;
+        dst->size = src->size;
+        dst->time = src->time;
+        pos++;
+    }
+    return num_entries;
+}
+
+SOKOL_API_IMPL int sfetch_preload(uint32_t channel, sfetch_access_log_entry_t* entries, int num_entries) {
+    _sfetch_t* ctx = _sfetch_ctx();
+    SOKOL_ASSERT(ctx && ctx->setup);
+    SOKOL_ASSERT(channel < ctx->desc.num_channels);
+    SOKOL_ASSERT(entries || (0 == num_entries));
+    if (!ctx->valid || (num_entries <= 0)) {
+        return 0;
+    }
+    #if _SFETCH_PLATFORM_EMSCRIPTEN
+        /* no file cache to warm up */
+        _SOKOL_UNUSED(channel);
+        _SOKOL_UNUSED(entries);
+        return 0;
+    #else
+        const int num_merged = _sfetch_preload_sort_and_merge(entries, num_entries);
+        const uint64_t now = _sfetch_timer_now(&ctx->timer);
+        int num_sent = 0;
+        for (int i = 0; i < num_merged; i++) {
+            sfetch_request_t request;
+            memset(&request, 0, sizeof(request));
+            request.channel = channel;
+            request.path = entries[i].path;
+            request.callback = _sfetch_preload_callback;
+            const uint32_t slot_id = _sfetch_send(ctx, &request, now);
+            if (0 == slot_id) {
+                break;
+            }
+            /* the request hasn't been dispatched yet, so it's safe to modify here */
+            _sfetch_item_t* item = _sfetch_pool_item_lookup(&ctx->pool, slot_id);
+            SOKOL_ASSERT(item);
+            item->preload = true;
+            item->preload_offset = entries[i].offset;
+            item->preload_size = entries[i].size;
+            num_sent++;
+        }
+        return num_sent;
+    #endif
+}
+
+#endif /* SOKOL_IMPL */
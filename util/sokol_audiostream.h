@@ -0,0 +1,999 @@
+#ifndef SOKOL_AUDIOSTREAM_INCLUDED
+/*
+    sokol_audiostream.h -- stream audio files from sokol_fetch.h into
+                           sokol_audio.h
+
+    Project URL: https://github.com/floooh/sokol
+
+    Do this:
+        #define SOKOL_AUDIOSTREAM_IMPL
+    before you include this file in *one* C or C++ file to create the
+    implementation.
+
+    The header sokol_fetch.h and sokol_audio.h must be included before
+    sokol_audiostream.h (both for the declaration and the implementation).
+
+    ...optionally provide the following macros to override defaults:
+
+    SOKOL_ASSERT(c)     - your own assert macro (default: assert(c))
+    SOKOL_MALLOC(s)     - your own malloc function (default: malloc(s))
+    SOKOL_FREE(p)       - your own free function (default: free(p))
+    SOKOL_API_DECL      - public function declaration prefix (default: extern)
+    SOKOL_API_IMPL      - public function implementation prefix (default: -)
+    SOKOL_LOG(msg)      - your own logging function (default: puts(msg))
+
+    If sokol_audiostream.h is compiled as a DLL, define the following before
+    including the declaration or implementation:
+
+    SOKOL_DLL
+
+    On Windows, SOKOL_DLL will define SOKOL_API_DECL as __declspec(dllexport)
+    or __declspec(dllimport) as needed.
+
+    FEATURE OVERVIEW
+    ================
+    sokol_audiostream.h plays long audio files (like music tracks) without
+    loading them into memory first. The file is loaded in chunks with
+    sokol_fetch.h, decoded on a worker thread, and the decoded samples
+    are pushed into sokol_audio.h's push FIFO ahead of playback:
+
+        sokol_fetch IO thread -> read-ahead buffer -> worker thread (decoder) -> saudio_push()
+
+    - the memory usage is bounded, the read-ahead buffer holds a fixed number
+      of fetched-but-not-yet-decoded bytes, when it is full, the fetch request
+      is paused until the decoder has caught up
+    - the decoder stays at most one decode block ahead of the audio FIFO
+    - WAV files (8-, 16-, 24- and 32-bit integer PCM, and 32-bit float) are
+      decoded by a built-in decoder, other formats (like Ogg Vorbis or MP3)
+      can be decoded with a codec callback
+
+    sokol_audiostream.h is the only producer for the sokol_audio.h push FIFO
+    while a stream is playing, so the application must not call saudio_push()
+    at the same time, and sokol_audio.h must be setup in the push model
+    with the default FLOAT32 sample format.
+
+    On platforms without threads (emscripten), or if the compiler doesn't
+    expose the POSIX timer functions (strict ANSI mode), the decoder runs on
+    the main thread inside sastream_dowork().
+
+    STEP BY STEP
+    ============
+    --- setup sokol_audio.h, sokol_fetch.h and then sokol_audiostream.h:
+
+        saudio_setup(&(saudio_desc){ .num_channels = 2 });
+        sfetch_setup(&(sfetch_desc_t){ .num_channels = 1, .num_lanes = 1 });
+        sastream_setup(&(sastream_desc){ 0 });
+
+    --- start playing a file:
+
+        sastream_play(&(sastream_play_desc){ .path = "music.wav" });
+
+    --- call sastream_dowork() once per frame, after sfetch_dowork():
+
+        sfetch_dowork();
+        sastream_dowork();
+
+    --- query the state of the stream:
+
+        sastream_state state = sastream_query_state();
+
+        SASTREAM_STATE_IDLE:        no stream was started, or it was stopped
+        SASTREAM_STATE_PLAYING:     the stream is loading and decoding
+        SASTREAM_STATE_FINISHED:    the entire file was decoded and pushed
+                                    into the audio FIFO (note that the last
+                                    pushed samples are still playing)
+        SASTREAM_STATE_FAILED:      loading or decoding has failed
+
+    --- stop the stream (this is also called by sastream_play() and
+        sastream_shutdown()):
+
+        sastream_stop();
+
+    --- and finally at shutdown, before sfetch_shutdown() and saudio_shutdown():
+
+        sastream_shutdown();
+
+    The following parameters can be provided in sastream_desc:
+
+        uint32_t fetch_channel      -- the sokol_fetch.h channel used for
+                                       loading (default: 0)
+        uint32_t chunk_size         -- the number of bytes loaded at once
+                                       (default: 64 KBytes)
+        uint32_t read_ahead_size    -- the max number of loaded bytes which
+                                       haven't been decoded yet, rounded
+                                       up to a power of two (default:
+                                       4 * chunk_size)
+        int decode_frames           -- the number of frames decoded at once
+                                       (default: 1024)
+
+    The memory usage is 2 * chunk_size + read_ahead_size plus one block of
+    decode_frames * num_channels floats.
+
+    CODEC CALLBACKS
+    ===============
+    To decode other formats than WAV, provide a codec in sastream_play_desc:
+
+        sastream_play(&(sastream_play_desc){
+            .path = "music.ogg",
+            .codec = {
+                .decode_cb = my_decode,
+                .reset_cb = my_reset,
+                .user_data = &my_decoder,
+            }
+        });
+
+    The reset_cb function is optional and called on the worker thread when
+    a new stream starts. The decode_cb function is called on the worker
+    thread with a sastream_decode_args struct:
+
+        const uint8_t* src  -- the undecoded data (starting at the first
+                               byte which hasn't been consumed yet)
+        int src_size        -- the number of bytes in src
+        bool src_eof        -- true if src contains the end of the file
+        float* dst          -- destination for interleaved float samples
+        int dst_frames      -- max number of frames to write to dst
+        int num_channels    -- number of channels in dst (saudio_channels())
+        void* user_data     -- the user_data from the sastream_codec struct
+
+    The codec must write the number of consumed bytes and decoded frames
+    into args->consumed and args->decoded. If the codec needs more input
+    data to make progress, it should consume nothing and decode nothing,
+    sokol_audiostream.h will call the codec again when more data has been
+    loaded (the codec must be able to make progress with chunk_size bytes).
+    When src_eof is true and the codec consumes and decodes nothing, the
+    stream is finished. Return false to signal a decoding error.
+
+    The decoded data must have the sample rate expected by sokol_audio.h
+    (the device sample rate, or saudio_desc.source_sample_rate if the
+    sokol_audio.h resampler is used).
+
+    STATISTICS
+    ==========
+    Call sastream_query_stats() to get information about the stream:
+
+        sastream_state state        -- same as sastream_query_state()
+        uint32_t bytes_fetched      -- number of bytes loaded by sokol_fetch
+        uint32_t bytes_buffered     -- number of loaded bytes waiting in
+                                       the read-ahead buffer
+        uint32_t frames_pushed      -- number of frames pushed into the
+                                       sokol_audio.h FIFO
+        uint32_t num_fetch_pauses   -- number of times loading was paused
+                                       because the read-ahead buffer was full
+        uint32_t num_starved        -- number of times the decoder ran out of
+                                       loaded data (if this happens a lot,
+                                       increase chunk_size and
+                                       read_ahead_size)
+
+    LICENSE
+    =======
+
+    zlib/libpng license
+
+    Copyright (c) 2018 Andre Weissflog
+
+    This software is provided 'as-is', without any express or implied warranty.
+    In no event will the authors be held liable for any damages arising from the
+    use of this software.
+
+    Permission is granted to anyone to use this software for any purpose,
+    including commercial applications, and to alter it and redistribute it
+    freely, subject to the following restrictions:
+
+        1. The origin of this software must not be misrepresented; you must not
+        claim that you wrote the original software. If you use this software in a
+        product, an acknowledgment in the product documentation would be
+        appreciated but is not required.
+
+        2. Altered source versions must be plainly marked as such, and must not
+        be misrepresented as being the original software.
+
+        3. This notice may not be removed or altered from any source
+        distribution.
+*/
+#define SOKOL_AUDIOSTREAM_INCLUDED (1)
+#include <stdint.h>
+#include <stdbool.h>
+
+#if !defined(SOKOL_FETCH_INCLUDED)
+#error "Please include sokol_fetch.h before sokol_audiostream.h"
+#endif
+#if !defined(SOKOL_AUDIO_INCLUDED)
+#error "Please include sokol_audio.h before sokol_audiostream.h"
+#endif
+
+#ifndef SOKOL_API_DECL
+#if defined(_WIN32) && defined(SOKOL_DLL) && defined(SOKOL_IMPL)
+#define SOKOL_API_DECL __declspec(dllexport)
+#elif defined(_WIN32) && defined(SOKOL_DLL)
+#define SOKOL_API_DECL __declspec(dllimport)
+#else
+#define SOKOL_API_DECL extern
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum sastream_state {
+    SASTREAM_STATE_IDLE,
+    SASTREAM_STATE_PLAYING,
+    SASTREAM_STATE_FINISHED,
+    SASTREAM_STATE_FAILED,
+    _SASTREAM_STATE_FORCE_U32 = 0x7FFFFFFF
+} sastream_state;
+
+/* arguments for the codec's decode callback, see CODEC CALLBACKS */
+typedef struct sastream_decode_args {
+    const uint8_t* src;     /* undecoded data */
+    int src_size;           /* number of bytes in src */
+    bool src_eof;           /* true if src contains the end of the file */
+    float* dst;             /* destination for interleaved float samples */
+    int dst_frames;         /* max number of frames to write to dst */
+    int num_channels;       /* number of channels in dst */
+    int consumed;           /* out: number of bytes consumed from src */
+    int decoded;            /* out: number of frames written to dst */
+    void* user_data;
+} sastream_decode_args;
+
+typedef struct sastream_codec {
+    bool (*decode_cb)(sastream_decode_args* args);  /* return false on error */
+    void (*reset_cb)(void* user_data);              /* optional, called before a new stream starts */
+    void* user_data;
+} sastream_codec;
+
+typedef struct sastream_desc {
+    uint32_t fetch_channel;     /* sokol_fetch.h channel for loading, default: 0 */
+    uint32_t chunk_size;        /* number of bytes loaded at once, default: 64 KBytes */
+    uint32_t read_ahead_size;   /* max number of loaded but undecoded bytes, default: 4 * chunk_size */
+    int decode_frames;          /* number of frames decoded at once, default: 1024 */
+} sastream_desc;
+
+typedef struct sastream_play_desc {
+    const char* path;           /* file path or URL (required) */
+    sastream_codec codec;       /* optional codec, default: built-in WAV decoder */
+} sastream_play_desc;
+
+typedef struct sastream_stats {
+    sastream_state state;
+    uint32_t bytes_fetched;     /* number of bytes loaded by sokol_fetch */
+    uint32_t bytes_buffered;    /* number of loaded bytes waiting in the read-ahead buffer */
+    uint32_t frames_pushed;     /* number of frames pushed into the sokol_audio.h FIFO */
+    uint32_t num_fetch_pauses;  /* number of times loading was paused because the read-ahead buffer was full */
+    uint32_t num_starved;       /* number of times the decoder ran out of loaded data */
+} sastream_stats;
+
+SOKOL_API_DECL void sastream_setup(const sastream_desc* desc);
+SOKOL_API_DECL void sastream_shutdown(void);
+SOKOL_API_DECL bool sastream_play(const sastream_play_desc* desc);
+SOKOL_API_DECL void sastream_stop(void);
+SOKOL_API_DECL void sastream_dowork(void);
+SOKOL_API_DECL sastream_state sastream_query_state(void);
+SOKOL_API_DECL sastream_stats sastream_query_stats(void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif /* SOKOL_AUDIOSTREAM_INCLUDED */
+
+/*=== IMPLEMENTATION =========================================================*/
+#ifdef SOKOL_AUDIOSTREAM_IMPL
+#define SOKOL_AUDIOSTREAM_IMPL_INCLUDED (1)
+
+#include <string.h> /* memset, memcpy, memmove */
+
+#ifndef SOKOL_API_IMPL
+    #define SOKOL_API_IMPL
+#endif
+#ifndef SOKOL_DEBUG
+    #ifndef NDEBUG
+        #define SOKOL_DEBUG (1)
+    #endif
+#endif
+#ifndef SOKOL_ASSERT
+    #include <assert.h>
+    #define SOKOL_ASSERT(c) assert(c)
+#endif
+#ifndef SOKOL_MALLOC
+    #include <stdlib.h>
+    #define SOKOL_MALLOC(s) malloc(s)
+    #define SOKOL_FREE(p) free(p)
+#endif
+#ifndef SOKOL_LOG
+    #ifdef SOKOL_DEBUG
+        #include <stdio.h>
+        #define SOKOL_LOG(s) { SOKOL_ASSERT(s); puts(s); }
+    #else
+        #define SOKOL_LOG(s)
+    #endif
+#endif
+#ifndef _SOKOL_PRIVATE
+    #if defined(__GNUC__) || defined(__clang__)
+        #define _SOKOL_PRIVATE __attribute__((unused)) static
+    #else
+        #define _SOKOL_PRIVATE static
+    #endif
+#endif
+#ifndef _SOKOL_UNUSED
+    #define _SOKOL_UNUSED(x) (void)(x)
+#endif
+
+#if defined(_MSC_VER)
+    #include <intrin.h>     /* _InterlockedOr, _InterlockedExchange */
+#endif
+
+/* the decoder runs on a worker thread where threads and a sleep function are available */
+#if defined(_WIN32)
+    #define _SASTREAM_WINTHREADS (1)
+    #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+    #define NOMINMAX
+    #endif
+    #include <windows.h>
+#elif !defined(__EMSCRIPTEN__)
+    #include <pthread.h>
+    #include <time.h>       /* nanosleep */
+    /* NOTE: nanosleep is missing in strict ANSI mode without _POSIX_C_SOURCE */
+    #if defined(CLOCK_MONOTONIC)
+        #define _SASTREAM_PTHREADS (1)
+    #endif
+#endif
+#if defined(_SASTREAM_WINTHREADS) || defined(_SASTREAM_PTHREADS)
+    #define _SASTREAM_HAS_THREADS (1)
+#endif
+
+#define _sastream_def(val, def) (((val) == 0) ? (def) : (val))
+#define _SASTREAM_DEFAULT_CHUNK_SIZE (64 * 1024)
+#define _SASTREAM_DEFAULT_DECODE_FRAMES (1024)
+#define _SASTREAM_POLL_INTERVAL_MS (2)
+
+/* built-in WAV decoder state */
+typedef enum {
+    _SASTREAM_WAV_RIFF,         /* expecting the RIFF header */
+    _SASTREAM_WAV_CHUNK,        /* expecting a chunk header */
+    _SASTREAM_WAV_SKIP,         /* skipping an unknown chunk */
+    _SASTREAM_WAV_DATA,         /* decoding the data chunk */
+    _SASTREAM_WAV_DONE          /* ignoring anything after the data chunk */
+} _sastream_wav_phase_t;
+
+typedef struct {
+    _sastream_wav_phase_t phase;
+    uint32_t skip_bytes;        /* remaining bytes of the chunk being skipped */
+    uint32_t data_bytes;        /* remaining bytes in the data chunk */
+    bool has_fmt;
+    int format;                 /* 1: integer PCM, 3: IEEE float */
+    int num_channels;
+    int sample_rate;
+    int bits;
+} _sastream_wav_t;
+
+/* a single-producer/single-consumer byte ring, the main thread writes
+    fetched data, the worker thread reads it, head and tail are free-running
+    counters, size is a power of two
+*/
+typedef struct {
+    uint8_t* buf;
+    uint32_t size;
+    uint32_t head;  /* atomic, total number of bytes written */
+    uint32_t tail;  /* atomic, total number of bytes read */
+} _sastream_ring_t;
+
+typedef struct {
+    bool valid;
+    sastream_desc desc;
+    uint32_t stream_id;         /* tags fetch callbacks, to ignore responses of stopped streams */
+    sfetch_handle_t request;
+    uint8_t* chunk_buf;         /* the sokol_fetch chunk buffer */
+    _sastream_ring_t ring;      /* read-ahead buffer between sokol_fetch and the decoder */
+    sastream_codec codec;
+    int num_channels;
+    /* shared between main and worker thread (atomic) */
+    uint32_t state;             /* sastream_state, written by main thread (start) and worker (end) */
+    uint32_t input_done;        /* set by main thread when all data is in the ring */
+    uint32_t input_failed;      /* set by main thread when loading failed */
+    uint32_t stop;              /* set by main thread to stop the worker */
+    uint32_t frames_pushed;     /* written by worker */
+    uint32_t num_starved;       /* written by worker */
+    /* main thread statistics */
+    uint32_t bytes_fetched;
+    uint32_t num_fetch_pauses;
+    /* worker thread state */
+    uint8_t* in_buf;            /* linear decode input buffer */
+    int in_cap;
+    int in_size;
+    int in_pos;
+    float* pcm;                 /* decoded frames */
+    int pcm_pos;
+    int pcm_pending;
+    int pad_frames;             /* remaining silence frames after the end of the stream, -1 if not started */
+    bool starving;
+    _sastream_wav_t wav;
+    #if defined(_SASTREAM_PTHREADS)
+    pthread_t thread;
+    #elif defined(_SASTREAM_WINTHREADS)
+    HANDLE thread;
+    #endif
+    bool thread_valid;
+} _sastream_t;
+static _sastream_t _sastream;
+
+/*=== ATOMIC WRAPPERS ========================================================*/
+#if defined(_MSC_VER)
+_SOKOL_PRIVATE uint32_t _sastream_atomic_load(uint32_t* ptr) {
+    return (uint32_t) _InterlockedOr((volatile long*)ptr, 0);
+}
+
+_SOKOL_PRIVATE void _sastream_atomic_store(uint32_t* ptr, uint32_t val) {
+    _InterlockedExchange((volatile long*)ptr, (long)val);
+}
+#elif defined(__GNUC__) || defined(__clang__)
+_SOKOL_PRIVATE uint32_t _sastream_atomic_load(uint32_t* ptr) {
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+_SOKOL_PRIVATE void _sastream_atomic_store(uint32_t* ptr, uint32_t val) {
+    __atomic_store_n(ptr, val, __ATOMIC_RELEASE);
+}
+#elif !defined(__cplusplus) && defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+_SOKOL_PRIVATE uint32_t _sastream_atomic_load(uint32_t* ptr) {
+    return atomic_load_explicit((_Atomic uint32_t*)ptr, memory_order_acquire);
+}
+
+_SOKOL_PRIVATE void _sastream_atomic_store(uint32_t* ptr, uint32_t val) {
+    atomic_store_explicit((_Atomic uint32_t*)ptr, val, memory_order_release);
+}
+#else
+#error "sokol_audiostream.h: no atomic load/store for this compiler (needs MSVC, GCC, clang or C11 atomics)"
+#endif
+
+/*=== READ-AHEAD RING ========================================================*/
+_SOKOL_PRIVATE uint32_t _sastream_round_pow2(uint32_t val) {
+    uint32_t res = 1;
+    while (res < val) {
+        res <<= 1;
+    }
+    return res;
+}
+
+_SOKOL_PRIVATE void _sastream_ring_reset(_sastream_ring_t* ring) {
+    _sastream_atomic_store(&ring->head, 0);
+    _sastream_atomic_store(&ring->tail, 0);
+}
+
+_SOKOL_PRIVATE uint32_t _sastream_ring_count(_sastream_ring_t* ring) {
+    return _sastream_atomic_load(&ring->head) - _sastream_atomic_load(&ring->tail);
+}
+
+/* producer side: write all bytes, the caller must make sure they fit */
+_SOKOL_PRIVATE void _sastream_ring_write(_sastream_ring_t* ring, const uint8_t* src, uint32_t num_bytes) {
+    const uint32_t head = ring->head;
+    SOKOL_ASSERT(num_bytes <= (ring->size - (head - _sastream_atomic_load(&ring->tail))));
+    const uint32_t pos = head & (ring->size - 1);
+    const uint32_t n0 = ((ring->size - pos) < num_bytes) ? (ring->size - pos) : num_bytes;
+    memcpy(ring->buf + pos, src, n0);
+    memcpy(ring->buf, src + n0, num_bytes - n0);
+    _sastream_atomic_store(&ring->head, head + num_bytes);
+}
+
+/* consumer side: read up to max_bytes, returns number of bytes read */
+_SOKOL_PRIVATE uint32_t _sastream_ring_read(_sastream_ring_t* ring, uint8_t* dst, uint32_t max_bytes) {
+    const uint32_t tail = ring->tail;
+    const uint32_t avail = _sastream_atomic_load(&ring->head) - tail;
+    const uint32_t num_bytes = (avail < max_bytes) ? avail : max_bytes;
+    const uint32_t pos = tail & (ring->size - 1);
+    const uint32_t n0 = ((ring->size - pos) < num_bytes) ? (ring->size - pos) : num_bytes;
+    memcpy(dst, ring->buf + pos, n0);
+    memcpy(dst + n0, ring->buf, num_bytes - n0);
+    _sastream_atomic_store(&ring->tail, tail + num_bytes);
+    return num_bytes;
+}
+
+/*=== BUILT-IN WAV DECODER ===================================================*/
+_SOKOL_PRIVATE uint32_t _sastream_wav_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+_SOKOL_PRIVATE uint16_t _sastream_wav_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+_SOKOL_PRIVATE float _sastream_wav_sample(const _sastream_wav_t* wav, const uint8_t* p) {
+    switch (wav->bits) {
+        case 8:
+            return ((float)p[0] - 128.0f) * (1.0f / 128.0f);
+        case 16:
+            return (float)(int16_t)_sastream_wav_u16(p) * (1.0f / 32768.0f);
+        case 24:
+            return (float)((int32_t)(((uint32_t)p[0] << 8) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 24)) >> 8) * (1.0f / 8388608.0f);
+        default:
+            if (3 == wav->format) {
+                float f;
+                uint32_t u = _sastream_wav_u32(p);
+                memcpy(&f, &u, sizeof(f));
+                return f;
+            }
+            else {
+                return (float)(int32_t)_sastream_wav_u32(p) * (1.0f / 2147483648.0f);
+            }
+    }
+}
+
+_SOKOL_PRIVATE bool _sastream_wav_parse_fmt(_sastream_wav_t* wav, const uint8_t* p, uint32_t size) {
+    if (size < 16) {
+        return false;
+    }
+    wav->format = _sastream_wav_u16(p);
+    wav->num_channels = _sastream_wav_u16(p + 2);
+    wav->sample_rate = (int)_sastream_wav_u32(p + 4);
+    wav->bits = _sastream_wav_u16(p + 14);
+    if ((0xFFFE == wav->format) && (size >= 26)) {
+        /* WAVE_FORMAT_EXTENSIBLE, the format is in the first 2 bytes of the sub-format GUID */
+        wav->format = _sastream_wav_u16(p + 24);
+    }
+    const bool int_ok = (1 == wav->format) && ((8 == wav->bits) || (16 == wav->bits) || (24 == wav->bits) || (32 == wav->bits));
+    const bool flt_ok = (3 == wav->format) && (32 == wav->bits);
+    if (!(int_ok || flt_ok) || (0 == wav->num_channels)) {
+        SOKOL_LOG("sokol_audiostream.h: unsupported WAV format");
+        return false;
+    }
+    const saudio_desc audio_desc = saudio_query_desc();
+    const int expected_rate = (audio_desc.source_sample_rate > 0) ? audio_desc.source_sample_rate : saudio_sample_rate();
+    if (wav->sample_rate != expected_rate) {
+        SOKOL_LOG("sokol_audiostream.h: WAV sample rate doesn't match the sokol_audio.h sample rate");
+    }
+    wav->has_fmt = true;
+    return true;
+}
+
+_SOKOL_PRIVATE void _sastream_wav_reset(void* user_data) {
+    _sastream_wav_t* wav = (_sastream_wav_t*) user_data;
+    memset(wav, 0, sizeof(_sastream_wav_t));
+}
+
+_SOKOL_PRIVATE bool _sastream_wav_decode(sastream_decode_args* args) {
+    _sastream_wav_t* wav = (_sastream_wav_t*) args->user_data;
+    const uint8_t* src = args->src;
+    int avail = args->src_size;
+    for (;;) {
+        if (_SASTREAM_WAV_RIFF == wav->phase) {
+            if (avail < 12) {
+                break;
+            }
+            if ((0 != memcmp(src, "RIFF", 4)) || (0 != memcmp(src + 8, "WAVE", 4))) {
+                SOKOL_LOG("sokol_audiostream.h: not a WAV file");
+                return false;
+            }
+            src += 12; avail -= 12;
+            wav->phase = _SASTREAM_WAV_CHUNK;
+        }
+        else if (_SASTREAM_WAV_CHUNK == wav->phase) {
+            if (avail < 8) {
+                break;
+            }
+            const uint32_t size = _sastream_wav_u32(src + 4);
+            if (0 == memcmp(src, "fmt ", 4)) {
+                /* the fmt chunk is parsed in one piece */
+                if (size > 256) {
+                    return false;
+                }
+                const int chunk_bytes = 8 + (int)size + (int)(size & 1);
+                if (avail < chunk_bytes) {
+                    break;
+                }
+                if (!_sastream_wav_parse_fmt(wav, src + 8, size)) {
+                    return false;
+                }
+                src += chunk_bytes; avail -= chunk_bytes;
+            }
+            else if (0 == memcmp(src, "data", 4)) {
+                if (!wav->has_fmt) {
+                    return false;
+                }
+                /* streamed WAV files may have a zero or max data size, play until the end of the file */
+                wav->data_bytes = (0 == size) ? 0xFFFFFFFF : size;
+                src += 8; avail -= 8;
+                wav->phase = _SASTREAM_WAV_DATA;
+            }
+            else {
+                wav->skip_bytes = size + (size & 1);
+                src += 8; avail -= 8;
+                wav->phase = _SASTREAM_WAV_SKIP;
+            }
+        }
+        else if (_SASTREAM_WAV_SKIP == wav->phase) {
+            const int n = ((uint32_t)avail < wav->skip_bytes) ? avail : (int)wav->skip_bytes;
+            src += n; avail -= n;
+            wav->skip_bytes -= (uint32_t)n;
+            if (wav->skip_bytes > 0) {
+                break;
+            }
+            wav->phase = _SASTREAM_WAV_CHUNK;
+        }
+        else if (_SASTREAM_WAV_DATA == wav->phase) {
+            const int bytes_per_sample = wav->bits / 8;
+            const int bytes_per_frame = bytes_per_sample * wav->num_channels;
+            int num_frames = avail / bytes_per_frame;
+            if ((uint32_t)num_frames > (wav->data_bytes / bytes_per_frame)) {
+                num_frames = (int)(wav->data_bytes / bytes_per_frame);
+            }
+            if (num_frames > (args->dst_frames - args->decoded)) {
+                num_frames = args->dst_frames - args->decoded;
+            }
+            float* dst = args->dst + args->decoded * args->num_channels;
+            for (int i = 0; i < num_frames; i++) {
+                const uint8_t* frame = src + i * bytes_per_frame;
+                for (int c = 0; c < args->num_channels; c++) {
+                    /* mono is copied into all channels, extra channels are dropped or silent */
+                    if (1 == wav->num_channels) {
+                        dst[c] = _sastream_wav_sample(wav, frame);
+                    }
+                    else if (c < wav->num_channels) {
+                        dst[c] = _sastream_wav_sample(wav, frame + c * bytes_per_sample);
+                    }
+                    else {
+                        dst[c] = 0.0f;
+                    }
+                }
+                dst += args->num_channels;
+            }
+            const int num_bytes = num_frames * bytes_per_frame;
+            src += num_bytes; avail -= num_bytes;
+            args->decoded += num_frames;
+            if (0xFFFFFFFF != wav->data_bytes) {
+                wav->data_bytes -= (uint32_t)num_bytes;
+            }
+            if (wav->data_bytes < (uint32_t)bytes_per_frame) {
+                wav->phase = _SASTREAM_WAV_DONE;
+            }
+            else if ((args->src_eof) && (avail < bytes_per_frame)) {
+                /* a truncated file, drop the incomplete last frame */
+                wav->phase = _SASTREAM_WAV_DONE;
+            }
+            else {
+                break;
+            }
+        }
+        else {
+            /* _SASTREAM_WAV_DONE: ignore any chunks after the sample data */
+            src += avail; avail = 0;
+            break;
+        }
+    }
+    args->consumed = (int)(src - args->src);
+    if (args->src_eof && (0 == args->consumed) && (0 == args->decoded) && (wav->phase < _SASTREAM_WAV_DATA)) {
+        SOKOL_LOG("sokol_audiostream.h: WAV file has no sample data");
+        return false;
+    }
+    return true;
+}
+
+/*=== DECODER ================================================================*/
+/* called on the worker thread (or in sastream_dowork() without threads),
+    returns true if any progress was made
+*/
+_SOKOL_PRIVATE bool _sastream_decode_step(void) {
+    bool progress = false;
+
+    /* first get rid of the previously decoded frames */
+    if (_sastream.pcm_pending > 0) {
+        const int num_frames = saudio_push(_sastream.pcm + _sastream.pcm_pos * _sastream.num_channels, _sastream.pcm_pending);
+        if (num_frames > 0) {
+            _sastream.pcm_pos += num_frames;
+            _sastream.pcm_pending -= num_frames;
+            _sastream_atomic_store(&_sastream.frames_pushed, _sastream_atomic_load(&_sastream.frames_pushed) + (uint32_t)num_frames);
+            progress = true;
+        }
+        if (_sastream.pcm_pending > 0) {
+            /* the audio FIFO is full */
+            return progress;
+        }
+    }
+
+    /* move loaded data from the read-ahead ring into the linear input buffer,
+       NOTE: the input_done flag must be checked before the ring is drained,
+       so that src_eof is only set when the input buffer really holds all data
+    */
+    const bool input_done = 0 != _sastream_atomic_load(&_sastream.input_done);
+    if (_sastream.in_pos > 0) {
+        _sastream.in_size -= _sastream.in_pos;
+        memmove(_sastream.in_buf, _sastream.in_buf + _sastream.in_pos, (size_t)_sastream.in_size);
+        _sastream.in_pos = 0;
+    }
+    const uint32_t num_read = _sastream_ring_read(&_sastream.ring, _sastream.in_buf + _sastream.in_size, (uint32_t)(_sastream.in_cap - _sastream.in_size));
+    _sastream.in_size += (int)num_read;
+
+    /* decode the next block */
+    sastream_decode_args args;
+    memset(&args, 0, sizeof(args));
+    args.src = _sastream.in_buf;
+    args.src_size = _sastream.in_size;
+    args.src_eof = input_done && (0 == _sastream_ring_count(&_sastream.ring));
+    args.dst = _sastream.pcm;
+    args.dst_frames = _sastream.desc.decode_frames;
+    args.num_channels = _sastream.num_channels;
+    args.user_data = _sastream.codec.user_data;
+    if (!_sastream.codec.decode_cb(&args)) {
+        SOKOL_LOG("sokol_audiostream.h: decoding failed");
+        _sastream_atomic_store(&_sastream.state, SASTREAM_STATE_FAILED);
+        return false;
+    }
+    SOKOL_ASSERT((args.consumed >= 0) && (args.consumed <= args.src_size));
+    SOKOL_ASSERT((args.decoded >= 0) && (args.decoded <= args.dst_frames));
+    _sastream.in_pos = args.consumed;
+    _sastream.pcm_pos = 0;
+    _sastream.pcm_pending = args.decoded;
+    if ((args.consumed > 0) || (args.decoded > 0)) {
+        _sastream.starving = false;
+        return true;
+    }
+
+    /* the decoder couldn't make progress */
+    if (args.src_eof) {
+        /* the audio thread only pulls complete stream buffers from the FIFO,
+           so the last samples must be followed by a period of silence
+        */
+        if (_sastream.pad_frames < 0) {
+            _sastream.pad_frames = saudio_period_frames();
+        }
+        if (_sastream.pad_frames > 0) {
+            const int num_frames = (_sastream.pad_frames < args.dst_frames) ? _sastream.pad_frames : args.dst_frames;
+            memset(_sastream.pcm, 0, (size_t)(num_frames * _sastream.num_channels) * sizeof(float));
+            _sastream.pcm_pending = num_frames;
+            _sastream.pad_frames -= num_frames;
+            return true;
+        }
+        _sastream_atomic_store(&_sastream.state, SASTREAM_STATE_FINISHED);
+    }
+    else if (_sastream_atomic_load(&_sastream.input_failed)) {
+        _sastream_atomic_store(&_sastream.state, SASTREAM_STATE_FAILED);
+    }
+    else if (_sastream.in_size == _sastream.in_cap) {
+        SOKOL_LOG("sokol_audiostream.h: codec can't make progress with a full input buffer (increase chunk_size)");
+        _sastream_atomic_store(&_sastream.state, SASTREAM_STATE_FAILED);
+    }
+    else if (!_sastream.starving) {
+        /* waiting for sokol_fetch */
+        _sastream.starving = true;
+        _sastream_atomic_store(&_sastream.num_starved, _sastream_atomic_load(&_sastream.num_starved) + 1);
+    }
+    return progress || (num_read > 0);
+}
+
+_SOKOL_PRIVATE bool _sastream_decoding(void) {
+    return (SASTREAM_STATE_PLAYING == _sastream_atomic_load(&_sastream.state)) && !_sastream_atomic_load(&_sastream.stop);
+}
+
+#if defined(_SASTREAM_HAS_THREADS)
+_SOKOL_PRIVATE void _sastream_sleep(int ms) {
+    #if defined(_SASTREAM_WINTHREADS)
+        Sleep((DWORD)ms);
+    #else
+        struct timespec ts;
+        ts.tv_sec = 0;
+        ts.tv_nsec = (long)ms * 1000000;
+        nanosleep(&ts, 0);
+    #endif
+}
+
+_SOKOL_PRIVATE void _sastream_thread_loop(void) {
+    while (_sastream_decoding()) {
+        if (!_sastream_decode_step()) {
+            /* nothing to do, wait for the audio thread or sokol_fetch to catch up */
+            _sastream_sleep(_SASTREAM_POLL_INTERVAL_MS);
+        }
+    }
+}
+
+#if defined(_SASTREAM_WINTHREADS)
+_SOKOL_PRIVATE DWORD WINAPI _sastream_thread_fn(LPVOID param) {
+    _SOKOL_UNUSED(param);
+    _sastream_thread_loop();
+    return 0;
+}
+#else
+_SOKOL_PRIVATE void* _sastream_thread_fn(void* param) {
+    _SOKOL_UNUSED(param);
+    _sastream_thread_loop();
+    return 0;
+}
+#endif
+#endif /* _SASTREAM_HAS_THREADS */
+
+/*=== SOKOL-FETCH CALLBACK ===================================================*/
+_SOKOL_PRIVATE void _sastream_fetch_callback(const sfetch_response_t* response) {
+    const uint32_t stream_id = *(const uint32_t*)response->user_data;
+    if (!_sastream.valid || (stream_id != _sastream.stream_id)) {
+        /* a response of a stopped stream */
+        return;
+    }
+    if (response->fetched) {
+        _sastream_ring_write(&_sastream.ring, (const uint8_t*)response->buffer_ptr, response->fetched_size);
+        _sastream.bytes_fetched += response->fetched_size;
+    }
+    if (response->finished) {
+        _sastream.request.id = 0;
+        if (response->failed) {
+            SOKOL_LOG("sokol_audiostream.h: loading failed");
+            _sastream_atomic_store(&_sastream.input_failed, 1);
+        }
+        else {
+            _sastream_atomic_store(&_sastream.input_done, 1);
+        }
+        return;
+    }
+    /* the pause or continue takes effect before the next chunk is loaded,
+       so a fetched chunk always fits into the ring
+    */
+    const uint32_t free_bytes = _sastream.ring.size - _sastream_ring_count(&_sastream.ring);
+    if (free_bytes < _sastream.desc.chunk_size) {
+        if (!response->paused) {
+            sfetch_pause(response->handle);
+            _sastream.num_fetch_pauses++;
+        }
+    }
+    else if (response->paused) {
+        sfetch_continue(response->handle);
+    }
+}
+
+/*=== PUBLIC API FUNCTIONS ===================================================*/
+SOKOL_API_IMPL void sastream_setup(const sastream_desc* desc) {
+    SOKOL_ASSERT(desc);
+    SOKOL_ASSERT(!_sastream.valid);
+    memset(&_sastream, 0, sizeof(_sastream));
+    _sastream.desc = *desc;
+    _sastream.desc.chunk_size = _sastream_def(_sastream.desc.chunk_size, _SASTREAM_DEFAULT_CHUNK_SIZE);
+    _sastream.desc.read_ahead_size = _sastream_round_pow2(_sastream_def(_sastream.desc.read_ahead_size, 4 * _sastream.desc.chunk_size));
+    _sastream.desc.decode_frames = _sastream_def(_sastream.desc.decode_frames, _SASTREAM_DEFAULT_DECODE_FRAMES);
+    SOKOL_ASSERT(_sastream.desc.read_ahead_size >= _sastream.desc.chunk_size);
+    SOKOL_ASSERT(_sastream.desc.decode_frames > 0);
+    _sastream.num_channels = saudio_channels();
+    _sastream.chunk_buf = (uint8_t*) SOKOL_MALLOC(_sastream.desc.chunk_size);
+    _sastream.ring.size = _sastream.desc.read_ahead_size;
+    _sastream.ring.buf = (uint8_t*) SOKOL_MALLOC(_sastream.ring.size);
+    _sastream.in_cap = (int)_sastream.desc.chunk_size;
+    _sastream.in_buf = (uint8_t*) SOKOL_MALLOC((size_t)_sastream.in_cap);
+    _sastream.pcm = (float*) SOKOL_MALLOC((size_t)(_sastream.desc.decode_frames * _sastream.num_channels) * sizeof(float));
+    SOKOL_ASSERT(_sastream.chunk_buf && _sastream.ring.buf && _sastream.in_buf && _sastream.pcm);
+    _sastream.valid = true;
+}
+
+SOKOL_API_IMPL void sastream_shutdown(void) {
+    SOKOL_ASSERT(_sastream.valid);
+    sastream_stop();
+    SOKOL_FREE(_sastream.chunk_buf);
+    SOKOL_FREE(_sastream.ring.buf);
+    SOKOL_FREE(_sastream.in_buf);
+    SOKOL_FREE(_sastream.pcm);
+    _sastream.valid = false;
+}
+
+SOKOL_API_IMPL void sastream_stop(void) {
+    SOKOL_ASSERT(_sastream.valid);
+    _sastream_atomic_store(&_sastream.stop, 1);
+    #if defined(_SASTREAM_HAS_THREADS)
+    if (_sastream.thread_valid) {
+        #if defined(_SASTREAM_WINTHREADS)
+            WaitForSingleObject(_sastream.thread, INFINITE);
+            CloseHandle(_sastream.thread);
+        #else
+            pthread_join(_sastream.thread, 0);
+        #endif
+        _sastream.thread_valid = false;
+    }
+    #endif
+    if (sfetch_handle_valid(_sastream.request)) {
+        /* the response callback ignores the cancelled response via the stream id */
+        sfetch_cancel(_sastream.request);
+    }
+    _sastream.request.id = 0;
+    _sastream.stream_id++;
+    _sastream_atomic_store(&_sastream.state, SASTREAM_STATE_IDLE);
+}
+
+SOKOL_API_IMPL bool sastream_play(const sastream_play_desc* desc) {
+    SOKOL_ASSERT(_sastream.valid);
+    SOKOL_ASSERT(desc && desc->path);
+    /* sokol_audiostream.h pushes float samples into the sokol_audio.h FIFO */
+    SOKOL_ASSERT(saudio_query_desc().sample_format <= SAUDIO_SAMPLEFORMAT_FLOAT32);
+    sastream_stop();
+    if (!saudio_isvalid() || !sfetch_valid()) {
+        return false;
+    }
+
+    /* reset the stream state */
+    _sastream_ring_reset(&_sastream.ring);
+    _sastream.in_size = 0;
+    _sastream.in_pos = 0;
+    _sastream.pcm_pos = 0;
+    _sastream.pcm_pending = 0;
+    _sastream.pad_frames = -1;
+    _sastream.starving = false;
+    _sastream.bytes_fetched = 0;
+    _sastream.num_fetch_pauses = 0;
+    _sastream_atomic_store(&_sastream.input_done, 0);
+    _sastream_atomic_store(&_sastream.input_failed, 0);
+    _sastream_atomic_store(&_sastream.frames_pushed, 0);
+    _sastream_atomic_store(&_sastream.num_starved, 0);
+    _sastream_atomic_store(&_sastream.stop, 0);
+    if (desc->codec.decode_cb) {
+        _sastream.codec = desc->codec;
+    }
+    else {
+        _sastream.codec.decode_cb = _sastream_wav_decode;
+        _sastream.codec.reset_cb = _sastream_wav_reset;
+        _sastream.codec.user_data = &_sastream.wav;
+    }
+    if (_sastream.codec.reset_cb) {
+        _sastream.codec.reset_cb(_sastream.codec.user_data);
+    }
+
+    /* start loading */
+    sfetch_request_t req;
+    memset(&req, 0, sizeof(req));
+    req.channel = _sastream.desc.fetch_channel;
+    req.path = desc->path;
+    req.callback = _sastream_fetch_callback;
+    req.buffer_ptr = _sastream.chunk_buf;
+    req.buffer_size = _sastream.desc.chunk_size;
+    req.chunk_size = _sastream.desc.chunk_size;
+    req.user_data_ptr = &_sastream.stream_id;
+    req.user_data_size = sizeof(_sastream.stream_id);
+    _sastream.request = sfetch_send(&req);
+    if (!sfetch_handle_valid(_sastream.request)) {
+        SOKOL_LOG("sokol_audiostream.h: sfetch_send() failed");
+        _sastream_atomic_store(&_sastream.state, SASTREAM_STATE_FAILED);
+        return false;
+    }
+    _sastream_atomic_store(&_sastream.state, SASTREAM_STATE_PLAYING);
+
+    /* start the decoder */
+    #if defined(_SASTREAM_HAS_THREADS)
+        #if defined(_SASTREAM_WINTHREADS)
+            _sastream.thread = CreateThread(NULL, 0, _sastream_thread_fn, 0, 0, 0);
+            _sastream.thread_valid = (0 != _sastream.thread);
+        #else
+            _sastream.thread_valid = (0 == pthread_create(&_sastream.thread, 0, _sastream_thread_fn, 0));
+        #endif
+        if (!_sastream.thread_valid) {
+            SOKOL_LOG("sokol_audiostream.h: failed to create decoder thread");
+            sastream_stop();
+            _sastream_atomic_store(&_sastream.state, SASTREAM_STATE_FAILED);
+            return false;
+        }
+    #endif
+    return true;
+}
+
+SOKOL_API_IMPL void sastream_dowork(void) {
+    SOKOL_ASSERT(_sastream.valid);
+    #if !defined(_SASTREAM_HAS_THREADS)
+        /* without threads, decode until the audio FIFO is full or the input data runs out */
+        while (_sastream_decoding() && _sastream_decode_step()) { }
+    #endif
+}
+
+SOKOL_API_IMPL sastream_state sastream_query_state(void) {
+    return (sastream_state) _sastream_atomic_load(&_sastream.state);
+}
+
+SOKOL_API_IMPL sastream_stats sastream_query_stats(void) {
+    sastream_stats stats;
+    memset(&stats, 0, sizeof(stats));
+    if (_sastream.valid) {
+        stats.state = sastream_query_state();
+        stats.bytes_fetched = _sastream.bytes_fetched;
+        stats.bytes_buffered = _sastream_ring_count(&_sastream.ring);
+        stats.frames_pushed = _sastream_atomic_load(&_sastream.frames_pushed);
+        stats.num_fetch_pauses = _sastream.num_fetch_pauses;
+        stats.num_starved = _sastream_atomic_load(&_sastream.num_starved);
+    }
+    return stats;
+}
+
+#undef _sastream_def
+
+#endif /* SOKOL_AUDIOSTREAM_IMPL */
@@ -0,0 +1,797 @@
+#ifndef SOKOL_FETCHBENCH_INCLUDED
+/*
+    sokol_fetchbench.h -- synthetic IO benchmark and storage simulation
+                          for sokol_fetch.h
+
+    Project URL: https://github.com/floooh/sokol
+
+    Do this:
+        #define SOKOL_FETCHBENCH_IMPL
+    before you include this file in *one* C or C++ file to create the
+    implementation.
+
+    The header sokol_fetch.h must be included before sokol_fetchbench.h
+    (both for the declaration and the implementation).
+
+    ...optionally provide the following macros to override defaults:
+
+    SOKOL_ASSERT(c)     - your own assert macro (default: assert(c))
+    SOKOL_MALLOC(s)     - your own malloc function (default: malloc(s))
+    SOKOL_FREE(p)       - your own free function (default: free(p))
+    SOKOL_API_DECL      - public function declaration prefix (default: extern)
+    SOKOL_API_IMPL      - public function implementation prefix (default: -)
+    SOKOL_LOG(msg)      - your own logging function (default: puts(msg))
+
+    The implementation only works on POSIX platforms with threads (it has
+    been written for Linux). In strict ANSI mode, define _POSIX_C_SOURCE
+    (for instance -D_POSIX_C_SOURCE=200809L) so that the POSIX timer
+    functions are visible.
+
+    FEATURE OVERVIEW
+    ================
+    sokol_fetchbench.h measures the overhead and behaviour of sokol_fetch.h
+    itself, independent from a real application and real storage:
+
+    - it generates a corpus of files with configurable sizes and counts,
+      by default on tmpfs (/dev/shm), so that the actual file reads are
+      as cheap as possible
+    - it drives sfetch_send() and sfetch_dowork() with a mix of request
+      types (whole-file loads and streamed loads on different channels)
+      and a max number of requests in flight
+    - it can simulate slow storage through a sokol_fetch.h file backend
+      (see sfetch_desc_t.file_backend) which adds latency per file open
+      and per read, and limits the bandwidth shared by all IO threads
+    - it reports throughput, the request latency distribution (from
+      sfetch_send() to the final response callback) and the time spent
+      in each sfetch_dowork() call
+
+    STEP BY STEP
+    ============
+    --- describe the request mix, the storage and the sokol_fetch.h setup:
+
+        const sfbench_desc desc = {
+            .files = {
+                // 1000 small files, loaded as a whole on channel 0
+                [0] = { .file_size = 16 * 1024, .num_files = 1000 },
+                // 4 big files, streamed in 256 KByte chunks on channel 1
+                [1] = { .file_size = 64 * 1024 * 1024, .num_files = 4, .chunk_size = 256 * 1024, .channel = 1 },
+            },
+            .max_inflight = 32,
+            .frame_us = 16667,
+            .storage = {
+                .read_latency_us = 100,
+                .bandwidth_mbps = 500,
+            },
+            .fetch = {
+                .num_channels = 2,
+                .num_lanes = 8,
+            },
+        };
+
+    --- generate the corpus (existing files with the right size are reused):
+
+        sfbench_make_corpus(&desc);
+
+    --- run the benchmark, sfbench_run() calls sfetch_setup() and
+        sfetch_shutdown() itself, so sokol_fetch.h must not be setup
+        on the calling thread:
+
+        sfbench_result res = sfbench_run(&desc);
+        sfbench_print_result("small+stream", &res);
+
+    --- and remove the corpus files when done:
+
+        sfbench_remove_corpus(&desc);
+
+    The following parameters can be provided in sfbench_desc:
+
+        const char* dir             -- the corpus directory, this is created
+                                       if it doesn't exist (default:
+                                       "/dev/shm/sokol_fetchbench")
+        sfbench_file_class files[]  -- up to SFBENCH_MAX_FILE_CLASSES file
+                                       classes (see below), the first class
+                                       with num_files == 0 ends the list
+        uint32_t max_inflight       -- max number of requests which have
+                                       been sent but not finished
+                                       (default: 16)
+        uint32_t frame_us           -- simulated frame duration,
+                                       sfetch_dowork() is called once per
+                                       frame (default: 0, no waiting
+                                       between sfetch_dowork() calls)
+        sfetch_desc_t fetch         -- passed to sfetch_setup(), max_requests
+                                       is raised to max_inflight if needed
+        sfbench_storage_desc storage -- the simulated storage, see below
+
+    Each file class in sfbench_file_class describes files of the same size
+    and how they are loaded:
+
+        uint32_t file_size          -- size of each file in bytes
+        uint32_t num_files          -- number of files in the corpus
+        uint32_t num_loads          -- number of requests sent for this
+                                       class, the files are loaded round-robin
+                                       (default: num_files)
+        uint32_t chunk_size         -- if not 0, the files are streamed in
+                                       chunks of this size
+        uint32_t read_ahead         -- passed to sfetch_request_t.read_ahead
+        uint32_t channel            -- the sokol_fetch.h channel
+        bool direct_io              -- passed to sfetch_request_t.direct_io
+
+    The requests of the different classes are interleaved. Without a
+    buffer pool in sfetch_desc_t, sokol_fetchbench.h allocates one buffer
+    per request in flight, big enough for the biggest file (or chunk) of
+    all classes. With a buffer pool, the requests use pooled buffers.
+
+    SIMULATED STORAGE
+    =================
+    If any value in sfbench_storage_desc is not zero, sfbench_run() replaces
+    sfetch_desc_t.file_backend with a file backend which reads through
+    open() and pread(), but delays each operation:
+
+        uint32_t open_latency_us    -- added to each file open
+        uint32_t read_latency_us    -- added to each read
+        uint32_t read_jitter_us     -- a random time between 0 and this
+                                       value is added to each read
+        uint32_t bandwidth_mbps     -- the storage bandwidth in MBytes per
+                                       second, shared by all IO threads
+                                       (default: 0, unlimited)
+
+    The reads of all IO threads are serialized on one simulated storage
+    device: a read of num_bytes starts transferring after its latency has
+    passed and the device has finished all earlier transfers, and then
+    occupies the device for num_bytes / bandwidth.
+
+    The same file backend can also be used to test how an application
+    behaves under slow storage:
+
+        sfetch_setup(&(sfetch_desc_t){
+            .file_backend = sfbench_file_backend(&(sfbench_storage_desc){
+                .read_latency_us = 5000,
+                .bandwidth_mbps = 50,
+            }),
+        });
+
+    The storage parameters are copied into a global of sokol_fetchbench.h
+    (so there can only be one simulated storage configuration at a time).
+
+    RESULTS
+    =======
+    sfbench_run() returns a sfbench_result struct:
+
+        bool valid                  -- false if the benchmark couldn't run
+                                       (for instance if sfetch_setup()
+                                       failed)
+        uint32_t num_requests       -- number of requests sent
+        uint32_t num_failed         -- number of failed requests
+        uint64_t num_bytes          -- number of bytes fetched
+        uint32_t num_frames         -- number of sfetch_dowork() calls
+        double duration_ms          -- time from the first sfetch_send() until
+                                       all requests have finished
+        double mbytes_per_sec       -- num_bytes / duration
+        double latency_avg_ms       -- average, median, 90th and 99th
+        double latency_p50_ms          percentile and max time from
+        double latency_p90_ms          sfetch_send() to the final response
+        double latency_p99_ms          callback of a request (from
+        double latency_max_ms          sfetch_response_t.timings)
+        double dowork_avg_us        -- average, 99th percentile and max time
+        double dowork_p99_us           spent in one sfetch_dowork() call
+        double dowork_max_us           (this includes the response callbacks)
+
+    sfbench_print_result() prints the result with printf().
+
+    LICENSE
+    =======
+
+    zlib/libpng license
+
+    Copyright (c) 2018 Andre Weissflog
+
+    This software is provided 'as-is', without any express or implied warranty.
+    In no event will the authors be held liable for any damages arising from the
+    use of this software.
+
+    Permission is granted to anyone to use this software for any purpose,
+    including commercial applications, and to alter it and redistribute it
+    freely, subject to the following restrictions:
+
+        1. The origin of this software must not be misrepresented; you must not
+        claim that you wrote the original software. If you use this software in a
+        product, an acknowledgment in the product documentation would be
+        appreciated but is not required.
+
+        2. Altered source versions must be plainly marked as such, and must not
+        be misrepresented as being the original software.
+
+        3. This notice may not be removed or altered from any source
+        distribution.
+*/
+#define SOKOL_FETCHBENCH_INCLUDED (1)
+#include <stdint.h>
+#include <stdbool.h>
+
+#if !defined(SOKOL_FETCH_INCLUDED)
+#error "Please include sokol_fetch.h before sokol_fetchbench.h"
+#endif
+
+#ifndef SOKOL_API_DECL
+#if defined(_WIN32) && defined(SOKOL_DLL) && defined(SOKOL_IMPL)
+#define SOKOL_API_DECL __declspec(dllexport)
+#elif defined(_WIN32) && defined(SOKOL_DLL)
+#define SOKOL_API_DECL __declspec(dllimport)
+#else
+#define SOKOL_API_DECL extern
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    SFBENCH_MAX_FILE_CLASSES = 8,
+};
+
+/* simulated storage parameters, see SIMULATED STORAGE */
+typedef struct sfbench_storage_desc {
+    uint32_t open_latency_us;   /* added to each file open */
+    uint32_t read_latency_us;   /* added to each read */
+    uint32_t read_jitter_us;    /* random 0..read_jitter_us added to each read */
+    uint32_t bandwidth_mbps;    /* MBytes/sec shared by all IO threads, default: 0 (unlimited) */
+} sfbench_storage_desc;
+
+/* a class of files with the same size and request parameters */
+typedef struct sfbench_file_class {
+    uint32_t file_size;         /* size of each file in bytes */
+    uint32_t num_files;         /* number of files in the corpus */
+    uint32_t num_loads;         /* number of requests for this class, default: num_files */
+    uint32_t chunk_size;        /* optional: stream the files in chunks of this size */
+    uint32_t read_ahead;        /* optional: sfetch_request_t.read_ahead */
+    uint32_t channel;           /* sokol_fetch.h channel, default: 0 */
+    bool direct_io;             /* optional: sfetch_request_t.direct_io */
+} sfbench_file_class;
+
+typedef struct sfbench_desc {
+    const char* dir;                /* corpus directory, default: "/dev/shm/sokol_fetchbench" */
+    sfbench_file_class files[SFBENCH_MAX_FILE_CLASSES];
+    uint32_t max_inflight;          /* max number of sent but unfinished requests, default: 16 */
+    uint32_t frame_us;              /* simulated frame duration, default: 0 (no waiting) */
+    sfetch_desc_t fetch;            /* passed to sfetch_setup() */
+    sfbench_storage_desc storage;   /* optional simulated storage */
+} sfbench_desc;
+
+typedef struct sfbench_result {
+    bool valid;
+    uint32_t num_requests;
+    uint32_t num_failed;
+    uint64_t num_bytes;
+    uint32_t num_frames;
+    double duration_ms;
+    double mbytes_per_sec;
+    double latency_avg_ms;
+    double latency_p50_ms;
+    double latency_p90_ms;
+    double latency_p99_ms;
+    double latency_max_ms;
+    double dowork_avg_us;
+    double dowork_p99_us;
+    double dowork_max_us;
+} sfbench_result;
+
+SOKOL_API_DECL bool sfbench_make_corpus(const sfbench_desc* desc);
+SOKOL_API_DECL void sfbench_remove_corpus(const sfbench_desc* desc);
+SOKOL_API_DECL sfbench_result sfbench_run(const sfbench_desc* desc);
+SOKOL_API_DECL void sfbench_print_result(const char* title, const sfbench_result* res);
+SOKOL_API_DECL sfetch_file_backend_t sfbench_file_backend(const sfbench_storage_desc* storage);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif /* SOKOL_FETCHBENCH_INCLUDED */
+
+/*=== IMPLEMENTATION =========================================================*/
+#ifdef SOKOL_FETCHBENCH_IMPL
+#define SOKOL_FETCHBENCH_IMPL_INCLUDED (1)
+
+#include <string.h> /* memset, memcpy */
+#include <stdio.h>  /* snprintf, printf */
+#include <stdlib.h> /* qsort */
+
+#ifndef SOKOL_API_IMPL
+    #define SOKOL_API_IMPL
+#endif
+#ifndef SOKOL_DEBUG
+    #ifndef NDEBUG
+        #define SOKOL_DEBUG (1)
+    #endif
+#endif
+#ifndef SOKOL_ASSERT
+    #include <assert.h>
+    #define SOKOL_ASSERT(c) assert(c)
+#endif
+#ifndef SOKOL_MALLOC
+    #define SOKOL_MALLOC(s) malloc(s)
+    #define SOKOL_FREE(p) free(p)
+#endif
+#ifndef SOKOL_LOG
+    #ifdef SOKOL_DEBUG
+        #define SOKOL_LOG(s) { SOKOL_ASSERT(s); puts(s); }
+    #else
+        #define SOKOL_LOG(s)
+    #endif
+#endif
+#ifndef _SOKOL_PRIVATE
+    #if defined(__GNUC__) || defined(__clang__)
+        #define _SOKOL_PRIVATE __attribute__((unused)) static
+    #else
+        #define _SOKOL_PRIVATE static
+    #endif
+#endif
+#ifndef _SOKOL_UNUSED
+    #define _SOKOL_UNUSED(x) (void)(x)
+#endif
+
+#if defined(_WIN32) || defined(__EMSCRIPTEN__)
+#error "sokol_fetchbench.h: only POSIX platforms with threads are supported"
+#endif
+#include <pthread.h>
+#include <time.h>       /* clock_gettime, nanosleep */
+#include <errno.h>
+#include <fcntl.h>      /* open */
+#include <unistd.h>     /* pread, write, close, unlink, rmdir */
+#include <sys/stat.h>   /* fstat, stat, mkdir */
+#if !defined(CLOCK_MONOTONIC)
+#error "sokol_fetchbench.h: CLOCK_MONOTONIC not found (define _POSIX_C_SOURCE in strict ANSI mode)"
+#endif
+
+#define _sfbench_def(val, def) (((val) == 0) ? (def) : (val))
+#define _SFBENCH_DEFAULT_DIR "/dev/shm/sokol_fetchbench"
+#define _SFBENCH_DEFAULT_MAX_INFLIGHT (16)
+#define _SFBENCH_MAX_PATH (1024)
+#define _SFBENCH_WRITE_BLOCK_SIZE (64 * 1024)
+
+/* the simulated storage device, shared by all IO threads */
+typedef struct {
+    sfbench_storage_desc desc;
+    pthread_mutex_t mutex;
+    uint64_t device_free;   /* time when the device has finished all transfers (protected by mutex) */
+    uint32_t rand_state;    /* xorshift state for the read jitter (protected by mutex) */
+} _sfbench_storage_t;
+
+/* a growable array of nanosecond durations */
+typedef struct {
+    uint64_t* items;
+    uint32_t num;
+    uint32_t cap;
+} _sfbench_samples_t;
+
+/* per request user data */
+typedef struct {
+    uint32_t slot;
+} _sfbench_request_data_t;
+
+typedef struct {
+    uint32_t num_finished;
+    uint32_t num_failed;
+    uint64_t num_bytes;
+    _sfbench_samples_t latencies;
+    uint32_t* free_slots;
+    uint32_t num_free_slots;
+} _sfbench_run_t;
+
+typedef struct {
+    _sfbench_storage_t storage;
+    _sfbench_run_t run;
+} _sfbench_t;
+static _sfbench_t _sfbench = { { { 0, 0, 0, 0 }, PTHREAD_MUTEX_INITIALIZER, 0, 0 }, { 0, 0, 0, { 0, 0, 0 }, 0, 0 } };
+
+_SOKOL_PRIVATE uint64_t _sfbench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000) + (uint64_t)ts.tv_nsec;
+}
+
+_SOKOL_PRIVATE void _sfbench_sleep_until(uint64_t deadline) {
+    uint64_t now = _sfbench_now();
+    while (now < deadline) {
+        const uint64_t ns = deadline - now;
+        struct timespec ts;
+        ts.tv_sec = (time_t)(ns / 1000000000);
+        ts.tv_nsec = (long)(ns % 1000000000);
+        nanosleep(&ts, 0);
+        now = _sfbench_now();
+    }
+}
+
+/*=== SAMPLES ================================================================*/
+_SOKOL_PRIVATE void _sfbench_samples_add(_sfbench_samples_t* s, uint64_t val) {
+    if (s->num == s->cap) {
+        const uint32_t new_cap = _sfbench_def(s->cap * 2, 1024);
+        uint64_t* new_items = (uint64_t*) SOKOL_MALLOC(new_cap * sizeof(uint64_t));
+        SOKOL_ASSERT(new_items);
+        if (s->items) {
+            memcpy(new_items, s->items, s->num * sizeof(uint64_t));
+            SOKOL_FREE(s->items);
+        }
+        s->items = new_items;
+        s->cap = new_cap;
+    }
+    s->items[s->num++] = val;
+}
+
+_SOKOL_PRIVATE void _sfbench_samples_discard(_sfbench_samples_t* s) {
+    if (s->items) {
+        SOKOL_FREE(s->items);
+    }
+    memset(s, 0, sizeof(_sfbench_samples_t));
+}
+
+_SOKOL_PRIVATE int _sfbench_compare_u64(const void* a, const void* b) {
+    const uint64_t va = *(const uint64_t*)a;
+    const uint64_t vb = *(const uint64_t*)b;
+    return (va < vb) ? -1 : ((va > vb) ? 1 : 0);
+}
+
+/* sort the samples and return the percentile p (0.0 .. 1.0) in nanoseconds */
+_SOKOL_PRIVATE uint64_t _sfbench_samples_percentile(_sfbench_samples_t* s, double p) {
+    if (0 == s->num) {
+        return 0;
+    }
+    qsort(s->items, s->num, sizeof(uint64_t), _sfbench_compare_u64);
+    return s->items[(uint32_t)((double)(s->num - 1) * p + 0.5)];
+}
+
+_SOKOL_PRIVATE double _sfbench_samples_avg(const _sfbench_samples_t* s) {
+    if (0 == s->num) {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (uint32_t i = 0; i < s->num; i++) {
+        sum += (double)s->items[i];
+    }
+    return sum / (double)s->num;
+}
+
+/*=== SIMULATED STORAGE FILE BACKEND =========================================*/
+/* file handles are file descriptors plus one, so that 0 is an invalid handle */
+_SOKOL_PRIVATE void* _sfbench_fd_to_handle(int fd) {
+    return (fd >= 0) ? (void*)(intptr_t)(fd + 1) : 0;
+}
+
+_SOKOL_PRIVATE int _sfbench_handle_to_fd(void* h) {
+    return (int)((intptr_t)h - 1);
+}
+
+_SOKOL_PRIVATE void* _sfbench_file_open(const char* path, void* user_data) {
+    const _sfbench_storage_t* st = (const _sfbench_storage_t*) user_data;
+    const uint64_t done = _sfbench_now() + (uint64_t)st->desc.open_latency_us * 1000;
+    const int fd = open(path, O_RDONLY);
+    _sfbench_sleep_until(done);
+    return _sfbench_fd_to_handle(fd);
+}
+
+_SOKOL_PRIVATE void _sfbench_file_close(void* h, void* user_data) {
+    _SOKOL_UNUSED(user_data);
+    close(_sfbench_handle_to_fd(h));
+}
+
+_SOKOL_PRIVATE uint32_t _sfbench_file_size(void* h, void* user_data) {
+    _SOKOL_UNUSED(user_data);
+    struct stat st;
+    if (0 == fstat(_sfbench_handle_to_fd(h), &st)) {
+        return (uint32_t) st.st_size;
+    }
+    else {
+        return 0;
+    }
+}
+
+_SOKOL_PRIVATE bool _sfbench_file_read(void* h, uint32_t offset, uint32_t num_bytes, void* ptr, void* user_data) {
+    _sfbench_storage_t* st = (_sfbench_storage_t*) user_data;
+    const uint64_t start = _sfbench_now();
+
+    /* the transfer starts when the latency has passed and the device
+       has finished all earlier transfers, the device is then busy
+       for num_bytes / bandwidth
+    */
+    pthread_mutex_lock(&st->mutex);
+    uint64_t latency = (uint64_t)st->desc.read_latency_us * 1000;
+    if (st->desc.read_jitter_us > 0) {
+        uint32_t x = _sfbench_def(st->rand_state, 0x12345678);
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        st->rand_state = x;
+        latency += (uint64_t)(x % (st->desc.read_jitter_us + 1)) * 1000;
+    }
+    uint64_t done = start + latency;
+    if (st->desc.bandwidth_mbps > 0) {
+        const uint64_t transfer_start = (st->device_free > done) ? st->device_free : done;
+        done = transfer_start + ((uint64_t)num_bytes * 1000) / st->desc.bandwidth_mbps;
+        st->device_free = done;
+    }
+    pthread_mutex_unlock(&st->mutex);
+
+    const int fd = _sfbench_handle_to_fd(h);
+    uint8_t* dst = (uint8_t*) ptr;
+    bool res = true;
+    while (num_bytes > 0) {
+        const ssize_t n = pread(fd, dst, num_bytes, (off_t)offset);
+        if (n > 0) {
+            dst += n;
+            offset += (uint32_t)n;
+            num_bytes -= (uint32_t)n;
+        }
+        else if ((n < 0) && (errno == EINTR)) {
+            continue;
+        }
+        else {
+            res = false;
+            break;
+        }
+    }
+    _sfbench_sleep_until(done);
+    return res;
+}
+
+/*=== CORPUS =================================================================*/
+_SOKOL_PRIVATE const char* _sfbench_dir(const sfbench_desc* desc) {
+    return desc->dir ? desc->dir : _SFBENCH_DEFAULT_DIR;
+}
+
+_SOKOL_PRIVATE uint32_t _sfbench_num_classes(const sfbench_desc* desc) {
+    uint32_t num = 0;
+    while ((num < SFBENCH_MAX_FILE_CLASSES) && (desc->files[num].num_files > 0)) {
+        num++;
+    }
+    return num;
+}
+
+_SOKOL_PRIVATE bool _sfbench_file_path(char* buf, const sfbench_desc* desc, uint32_t cls, uint32_t file) {
+    const int res = snprintf(buf, _SFBENCH_MAX_PATH, "%s/c%u_%u.bin", _sfbench_dir(desc), cls, file);
+    return (res > 0) && (res < _SFBENCH_MAX_PATH);
+}
+
+/* write a file with a byte pattern that depends on the file offset */
+_SOKOL_PRIVATE bool _sfbench_write_file(const char* path, uint32_t size, uint8_t* block) {
+    struct stat st;
+    if ((0 == stat(path, &st)) && ((uint64_t)st.st_size == size)) {
+        /* reuse the existing file */
+        return true;
+    }
+    const int fd = open(path, O_WRONLY|O_CREAT|O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    bool res = true;
+    uint32_t offset = 0;
+    while (res && (offset < size)) {
+        const uint32_t num_bytes = ((size - offset) < _SFBENCH_WRITE_BLOCK_SIZE) ? (size - offset) : _SFBENCH_WRITE_BLOCK_SIZE;
+        for (uint32_t i = 0; i < num_bytes; i++) {
+            block[i] = (uint8_t)(offset + i);
+        }
+        res = (write(fd, block, num_bytes) == (ssize_t)num_bytes);
+        offset += num_bytes;
+    }
+    close(fd);
+    return res;
+}
+
+/*=== BENCHMARK RUN ==========================================================*/
+_SOKOL_PRIVATE void _sfbench_response_callback(const sfetch_response_t* response) {
+    _sfbench_run_t* run = &_sfbench.run;
+    if (response->fetched) {
+        run->num_bytes += response->fetched_size;
+    }
+    if (response->finished) {
+        const _sfbench_request_data_t* data = (const _sfbench_request_data_t*) response->user_data;
+        if (response->failed) {
+            run->num_failed++;
+        }
+        _sfbench_samples_add(&run->latencies, response->timings.callback - response->timings.sent);
+        run->free_slots[run->num_free_slots++] = data->slot;
+        run->num_finished++;
+    }
+}
+
+/*=== PUBLIC API FUNCTIONS ===================================================*/
+SOKOL_API_IMPL sfetch_file_backend_t sfbench_file_backend(const sfbench_storage_desc* storage) {
+    SOKOL_ASSERT(storage);
+    _sfbench_storage_t* st = &_sfbench.storage;
+    pthread_mutex_lock(&st->mutex);
+    st->desc = *storage;
+    st->device_free = 0;
+    pthread_mutex_unlock(&st->mutex);
+    sfetch_file_backend_t fb;
+    memset(&fb, 0, sizeof(fb));
+    fb.open_cb = _sfbench_file_open;
+    fb.close_cb = _sfbench_file_close;
+    fb.size_cb = _sfbench_file_size;
+    fb.read_cb = _sfbench_file_read;
+    fb.user_data = st;
+    return fb;
+}
+
+SOKOL_API_IMPL bool sfbench_make_corpus(const sfbench_desc* desc) {
+    SOKOL_ASSERT(desc);
+    if ((0 != mkdir(_sfbench_dir(desc), 0755)) && (errno != EEXIST)) {
+        SOKOL_LOG("sokol_fetchbench.h: failed to create corpus directory");
+        return false;
+    }
+    uint8_t* block = (uint8_t*) SOKOL_MALLOC(_SFBENCH_WRITE_BLOCK_SIZE);
+    SOKOL_ASSERT(block);
+    bool res = true;
+    char path[_SFBENCH_MAX_PATH];
+    const uint32_t num_classes = _sfbench_num_classes(desc);
+    for (uint32_t cls = 0; res && (cls < num_classes); cls++) {
+        for (uint32_t file = 0; res && (file < desc->files[cls].num_files); file++) {
+            res = _sfbench_file_path(path, desc, cls, file) && _sfbench_write_file(path, desc->files[cls].file_size, block);
+        }
+    }
+    SOKOL_FREE(block);
+    if (!res) {
+        SOKOL_LOG("sokol_fetchbench.h: failed to write corpus file");
+    }
+    return res;
+}
+
+SOKOL_API_IMPL void sfbench_remove_corpus(const sfbench_desc* desc) {
+    SOKOL_ASSERT(desc);
+    char path[_SFBENCH_MAX_PATH];
+    const uint32_t num_classes = _sfbench_num_classes(desc);
+    for (uint32_t cls = 0; cls < num_classes; cls++) {
+        for (uint32_t file = 0; file < desc->files[cls].num_files; file++) {
+            if (_sfbench_file_path(path, desc, cls, file)) {
+                unlink(path);
+            }
+        }
+    }
+    /* only succeeds if there are no other files in the directory */
+    rmdir(_sfbench_dir(desc));
+}
+
+SOKOL_API_IMPL sfbench_result sfbench_run(const sfbench_desc* desc) {
+    SOKOL_ASSERT(desc);
+    sfbench_result res;
+    memset(&res, 0, sizeof(res));
+    const uint32_t num_classes = _sfbench_num_classes(desc);
+    const uint32_t max_inflight = _sfbench_def(desc->max_inflight, _SFBENCH_DEFAULT_MAX_INFLIGHT);
+
+    /* setup sokol_fetch.h, with the simulated storage if requested */
+    sfetch_desc_t fetch_desc = desc->fetch;
+    if (_sfbench_def(fetch_desc.max_requests, 128) < max_inflight) {
+        fetch_desc.max_requests = max_inflight;
+    }
+    const sfbench_storage_desc* sd = &desc->storage;
+    if (sd->open_latency_us || sd->read_latency_us || sd->read_jitter_us || sd->bandwidth_mbps) {
+        fetch_desc.file_backend = sfbench_file_backend(sd);
+    }
+    sfetch_setup(&fetch_desc);
+    if (!sfetch_valid()) {
+        SOKOL_LOG("sokol_fetchbench.h: sfetch_setup() failed");
+        sfetch_shutdown();
+        return res;
+    }
+
+    /* without a buffer pool, each request slot gets its own buffer */
+    const bool use_pool = fetch_desc.buffer_pool[0].size > 0;
+    uint32_t max_buffer_size = 0;
+    for (uint32_t cls = 0; cls < num_classes; cls++) {
+        const sfbench_file_class* fc = &desc->files[cls];
+        const uint32_t size = (fc->chunk_size > 0) ? fc->chunk_size : fc->file_size;
+        max_buffer_size = (size > max_buffer_size) ? size : max_buffer_size;
+    }
+    uint8_t* buffers = 0;
+    if (!use_pool) {
+        buffers = (uint8_t*) SOKOL_MALLOC((size_t)max_inflight * max_buffer_size);
+        SOKOL_ASSERT(buffers);
+    }
+    _sfbench_run_t* run = &_sfbench.run;
+    memset(run, 0, sizeof(_sfbench_run_t));
+    run->free_slots = (uint32_t*) SOKOL_MALLOC(max_inflight * sizeof(uint32_t));
+    SOKOL_ASSERT(run->free_slots);
+    for (uint32_t i = 0; i < max_inflight; i++) {
+        run->free_slots[run->num_free_slots++] = max_inflight - 1 - i;
+    }
+
+    /* the requests of the file classes are interleaved round-robin */
+    uint32_t num_sent[SFBENCH_MAX_FILE_CLASSES];
+    memset(num_sent, 0, sizeof(num_sent));
+    uint32_t num_requests = 0;
+    for (uint32_t cls = 0; cls < num_classes; cls++) {
+        num_requests += _sfbench_def(desc->files[cls].num_loads, desc->files[cls].num_files);
+    }
+    _sfbench_samples_t dowork_times;
+    memset(&dowork_times, 0, sizeof(dowork_times));
+    char path[_SFBENCH_MAX_PATH];
+    uint32_t next_cls = 0;
+    uint32_t num_requests_sent = 0;
+    const uint64_t start = _sfbench_now();
+    uint64_t frame_start = start;
+    while (run->num_finished < num_requests) {
+        while ((num_requests_sent < num_requests) && (run->num_free_slots > 0)) {
+            /* find the next class with requests left */
+            uint32_t cls = next_cls;
+            while (num_sent[cls] >= _sfbench_def(desc->files[cls].num_loads, desc->files[cls].num_files)) {
+                cls = (cls + 1) % num_classes;
+            }
+            next_cls = (cls + 1) % num_classes;
+            const sfbench_file_class* fc = &desc->files[cls];
+            const uint32_t file = num_sent[cls]++ % fc->num_files;
+            num_requests_sent++;
+
+            _sfbench_request_data_t data;
+            data.slot = run->free_slots[--run->num_free_slots];
+            sfetch_request_t req;
+            memset(&req, 0, sizeof(req));
+            req.channel = fc->channel;
+            req.path = path;
+            req.callback = _sfbench_response_callback;
+            req.buffer_size = (fc->chunk_size > 0) ? fc->chunk_size : fc->file_size;
+            if (!use_pool) {
+                req.buffer_ptr = buffers + (size_t)data.slot * max_buffer_size;
+            }
+            req.chunk_size = fc->chunk_size;
+            req.read_ahead = fc->read_ahead;
+            req.direct_io = fc->direct_io;
+            req.user_data_ptr = &data;
+            req.user_data_size = sizeof(data);
+            if (!(_sfbench_file_path(path, desc, cls, file) && sfetch_handle_valid(sfetch_send(&req)))) {
+                run->free_slots[run->num_free_slots++] = data.slot;
+                run->num_failed++;
+                run->num_finished++;
+            }
+        }
+        const uint64_t t0 = _sfbench_now();
+        sfetch_dowork();
+        _sfbench_samples_add(&dowork_times, _sfbench_now() - t0);
+        if (desc->frame_us > 0) {
+            frame_start += (uint64_t)desc->frame_us * 1000;
+            _sfbench_sleep_until(frame_start);
+        }
+    }
+    const uint64_t duration = _sfbench_now() - start;
+    sfetch_shutdown();
+
+    res.valid = true;
+    res.num_requests = num_requests;
+    res.num_failed = run->num_failed;
+    res.num_bytes = run->num_bytes;
+    res.num_frames = dowork_times.num;
+    res.duration_ms = (double)duration / 1000000.0;
+    if (duration > 0) {
+        res.mbytes_per_sec = ((double)run->num_bytes / (1024.0 * 1024.0)) / ((double)duration / 1000000000.0);
+    }
+    res.latency_avg_ms = _sfbench_samples_avg(&run->latencies) / 1000000.0;
+    res.latency_p50_ms = (double)_sfbench_samples_percentile(&run->latencies, 0.5) / 1000000.0;
+    res.latency_p90_ms = (double)_sfbench_samples_percentile(&run->latencies, 0.9) / 1000000.0;
+    res.latency_p99_ms = (double)_sfbench_samples_percentile(&run->latencies, 0.99) / 1000000.0;
+    res.latency_max_ms = (double)_sfbench_samples_percentile(&run->latencies, 1.0) / 1000000.0;
+    res.dowork_avg_us = _sfbench_samples_avg(&dowork_times) / 1000.0;
+    res.dowork_p99_us = (double)_sfbench_samples_percentile(&dowork_times, 0.99) / 1000.0;
+    res.dowork_max_us = (double)_sfbench_samples_percentile(&dowork_times, 1.0) / 1000.0;
+
+    _sfbench_samples_discard(&dowork_times);
+    _sfbench_samples_discard(&run->latencies);
+    SOKOL_FREE(run->free_slots);
+    run->free_slots = 0;
+    if (buffers) {
+        SOKOL_FREE(buffers);
+    }
+    return res;
+}
+
+SOKOL_API_IMPL void sfbench_print_result(const char* title, const sfbench_result* res) {
+    SOKOL_ASSERT(title && res);
+    if (!res->valid) {
+        printf("%s: invalid result\n", title);
+        return;
+    }
+    printf("%s:\n", title);
+    printf("  requests:   %u (%u failed), %.2f MBytes in %.1f ms, %.1f MBytes/sec\n",
+        res->num_requests, res->num_failed, (double)res->num_bytes / (1024.0 * 1024.0), res->duration_ms, res->mbytes_per_sec);
+    printf("  latency:    avg %.3f ms, p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+        res->latency_avg_ms, res->latency_p50_ms, res->latency_p90_ms, res->latency_p99_ms, res->latency_max_ms);
+    printf("  dowork:     %u frames, avg %.2f us, p99 %.2f us, max %.2f us\n",
+        res->num_frames, res->dowork_avg_us, res->dowork_p99_us, res->dowork_max_us);
+}
+
+#undef _sfbench_def
+
+#endif /* SOKOL_FETCHBENCH_IMPL */
@@ -1006,6 +1006,8 @@ _SOKOL_PRIVATE const char* _sg_imgui_vertexformat_string(sg_vertex_format f) {
         case SG_VERTEXFORMAT_SHORT4N:   return "SG_VERTEXFORMAT_SHORT4N";
         case SG_VERTEXFORMAT_USHORT4N:  return "SG_VERTEXFORMAT_USHORT4N";
         case SG_VERTEXFORMAT_UINT10_N2: return "SG_VERTEXFORMAT_UINT10_N2";
+        case SG_VERTEXFORMAT_HALF2:     return "SG_VERTEXFORMAT_HALF2";
+        case SG_VERTEXFORMAT_HALF4:     return "SG_VERTEXFORMAT_HALF4";
         default:                        return "???";
     }
 }
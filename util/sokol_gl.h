@@ -30,6 +30,9 @@
     SOKOL_LOG(msg)      - your own logging function (default: puts(msg))
     SOKOL_UNREACHABLE() - a guard macro for unreachable code (default: assert(false))
 
+    Define SGL_NO_SIMD to disable the SSE/NEON code path which is used
+    for transforming vertices in CPU transform mode.
+
     If sokol_gl.h is compiled as a DLL, define the following before
     including the declaration or implementation:
 
@@ -116,10 +119,14 @@
             int max_vertices    - default is 65536
             int max_commands    - default is 16384
 
+        The above values describe the 'default context' which is created
+        by sgl_setup() (see RENDERING CONTEXTS below).
+
         You can adjust the size of the internal pipeline state object pool
-        with:
+        and context pool with:
 
             int pipeline_pool_size  - default is 64
+            int context_pool_size   - default is 4 (including the default context)
 
         Finally you can change the face winding for front-facing triangles
         and quads:
@@ -147,6 +154,15 @@
         call to sgl_make_pipeline() needs to create several sokol-gfx
         pipeline objects (one for each primitive type).
 
+        The pixel formats and sample count are taken from the current
+        context, so a pipeline can only be used with contexts which render
+        into passes with the same attributes, and which use the same vertex
+        format and index type (meaning max_vertices is either <= 65536 for
+        both, or greater than 65536 for both). To create a pipeline for a
+        specific context without making it current, call:
+
+            sgl_pipeline sgl_context_make_pipeline(sgl_context ctx, const sg_pipeline_desc* desc)
+
     --- if you need to destroy sgl_pipeline objects before sgl_shutdown():
 
             sgl_destroy_pipeline(sgl_pipeline pip)
@@ -310,23 +326,116 @@
         call to sgl_draw() through sokol-gfx, and will 'rewind' the internal
         vertex-, uniform- and command-buffers.
 
-    --- sokol-gl tracks a single internal error code which can be
-        queried with
+    --- each context tracks a single internal error code, the error
+        code of the current context can be queried with
 
             sgl_error_t sgl_error(void)
 
         ...which can return the following error codes:
 
         SGL_NO_ERROR                - all OK, no error occurred since last sgl_draw()
-        SGL_ERROR_VERTICES_FULL     - internal vertex buffer is full (checked in sgl_end())
+        SGL_ERROR_VERTICES_FULL     - internal vertex (or index) buffer is full (checked in sgl_end())
         SGL_ERROR_UNIFORMS_FULL     - the internal uniforms buffer is full (checked in sgl_end())
         SGL_ERROR_COMMANDS_FULL     - the internal command buffer is full (checked in sgl_end())
         SGL_ERROR_STACK_OVERFLOW    - matrix- or pipeline-stack overflow
         SGL_ERROR_STACK_UNDERFLOW   - matrix- or pipeline-stack underflow
+        SGL_ERROR_NO_CONTEXT        - the current context no longer exists
 
-        ...if sokol-gl is in an error-state, sgl_draw() will skip any rendering,
+        ...if a context is in an error-state, sgl_draw() will skip any rendering,
         and reset the error code to SGL_NO_ERROR.
 
+    RENDERING CONTEXTS
+    ==================
+    A sokol-gl context owns its own vertex-, uniform- and command-buffers,
+    a sokol-gfx vertex buffer, the matrix- and pipeline-stacks and all
+    other 'current state' (color, texture coords, texture, ...). Having
+    several contexts allows to record sokol-gl commands for different
+    render passes (for instance an offscreen pass and the default pass)
+    without having to sgl_draw() everything in between.
+
+    sgl_setup() creates a default context which is also the current
+    context after setup. To create additional contexts, call:
+
+        sgl_context ctx = sgl_make_context(&(sgl_context_desc_t){
+            .max_vertices = ...,        // default is 65536
+            .max_commands = ...,        // default is 16384
+            .color_format = ...,
+            .depth_format = ...,
+            .sample_count = ...,
+        });
+
+    The pixel formats and sample count must match the render pass where
+    the context will be rendered. All recording functions work on the
+    current context, which is changed with:
+
+        sgl_set_context(ctx);
+        sgl_context cur = sgl_get_context();
+        sgl_context def = sgl_default_context();
+
+    sgl_set_context() must not be called between sgl_begin_*() and sgl_end().
+
+    To render a context, either make it current and call sgl_draw(), or call:
+
+        sgl_context_draw(ctx);
+
+    Contexts are destroyed with:
+
+        sgl_destroy_context(ctx);
+
+    The default context cannot be destroyed. If the current context is
+    destroyed, the recording functions become no-ops and sgl_error() returns
+    SGL_ERROR_NO_CONTEXT until another context is made current. This is
+    also true for other threads which have the destroyed context as their
+    current context (even if a new context is later created in the same
+    slot).
+
+    To get statistics about what has been recorded into a context before
+    its last sgl_draw() or sgl_merge_context(), call:
+
+        sgl_context_stats_t stats = sgl_context_stats(ctx);
+
+    MULTITHREADED RECORDING
+    =======================
+    The current context is tracked per thread (via thread-local storage),
+    so several threads can record into different contexts at the same time.
+    After sgl_setup() the default context is only current on the thread
+    which called sgl_setup(), all other threads start without a current
+    context and must call sgl_set_context() before recording.
+
+    A typical setup for recording debug-draw commands on worker threads:
+
+        - on the render thread, create one context per worker thread
+          with the same pixel formats as the render thread's context
+        - each worker thread calls sgl_set_context() with its own context
+          and records its commands as usual
+        - once all workers have finished recording, the render thread merges
+          the worker contexts into its current context and renders everything
+          with a single sgl_draw():
+
+            for (int i = 0; i < num_workers; i++) {
+                sgl_merge_context(worker_ctx[i]);
+            }
+            sgl_draw();
+
+    sgl_merge_context() appends the recorded vertices, uniforms and commands
+    of a context to the current context, and rewinds the merged context
+    so that it can be recorded into again. The current context must have
+    enough space for all merged data, otherwise it will go into an
+    error state (e.g. SGL_ERROR_VERTICES_FULL). A merged context which
+    is in an error state is skipped, as well as a context which has
+    different pixel formats, sample count, vertex format or index type
+    than the current context (this is logged via SOKOL_LOG). In both
+    cases the merged context is still rewound.
+
+    The following restrictions apply:
+
+        - a context must only be used by one thread at a time, and must not
+          be recorded into while it is merged
+        - contexts and pipelines must only be created and destroyed on the
+          render thread, while no other thread is recording
+        - sgl_setup(), sgl_shutdown(), sgl_draw() and sgl_context_draw() must
+          be called on the render thread (they call into sokol-gfx)
+
     UNDER THE HOOD:
     ===============
     sokol_gl.h works by recording vertex data and rendering commands into
@@ -335,28 +444,52 @@
     The only functions which call into sokol_gfx.h are:
         - sgl_setup()
         - sgl_shutdown()
-        - sgl_draw()
+        - sgl_make_context()
+        - sgl_destroy_context()
+        - sgl_make_pipeline() / sgl_context_make_pipeline()
+        - sgl_destroy_pipeline()
+        - sgl_draw() / sgl_context_draw()
 
     sgl_setup() must be called after initializing sokol-gfx.
     sgl_shutdown() must be called before shutting down sokol-gfx.
-    sgl_draw() must be called once per frame inside a sokol-gfx render pass.
+    sgl_draw() must be called inside a sokol-gfx render pass, a context
+    may be drawn several times per frame (for instance into different
+    passes), but all vertices drawn from one context within a frame must
+    fit into its max_vertices.
 
     All other sokol-gl function can be called anywhere in a frame, since
-    they just record data into memory buffers owned by sokol-gl.
+    they just record data into memory buffers owned by sokol-gl (see
+    MULTITHREADED RECORDING for calling them from other threads).
 
     What happens in:
 
         sgl_setup():
-            - 3 memory buffers are allocated, one for vertex data,
-              one for uniform data, and one for commands
-            - sokol-gfx resources are created: a (dynamic) vertex buffer,
-              a shader object (using embedded shader source or byte code),
-              and an 8x8 all-white default texture
-
-            One vertex is 24 bytes:
+            - sokol-gfx resources are created: a shader object (using
+              embedded shader source or byte code), and an 8x8 all-white
+              default texture
+            - the default context is created
+
+        sgl_make_context():
+            - 4 memory buffers are allocated, one for vertex data, one
+              for index data, one for uniform data, and one for commands
+            - sokol-gfx resources are created: a (stream) vertex buffer,
+              a (stream) index buffer and the context's default pipeline
+
+            With the default vertex format, one vertex is 24 bytes:
                 - float3 position
                 - float2 texture coords
                 - uint32_t color
+            (see VERTEX FORMATS for more compact alternatives)
+
+            One index is 2 bytes if max_vertices is <= 65536, otherwise
+            4 bytes. Only unique vertices are stored, primitive types
+            which are not directly supported by sokol-gfx are converted
+            into lists via the index buffer:
+                - quads: 4 vertices and 6 indices per quad
+                - line strips: 2 indices per line segment
+                - triangle strips: 3 indices per triangle
+            The index buffer has room for 3 * max_vertices indices so that
+            it never runs out of space before the vertex buffer.
 
             One uniform block is 128 bytes:
                 - mat4 model-view-projection matrix
@@ -369,16 +502,18 @@
             (only when the matrices have changed).
             The required size for one sgl_begin/end pair is (at most):
 
-                (152 + 24 * num_verts) bytes
+                (152 + vertex_size * num_verts + index_size * num_indices) bytes
 
         sgl_shutdown():
-            - all sokol-gfx resources (buffer, shader, default-texture and
+            - all contexts are destroyed, this frees the 4 memory buffers
+              and the vertex and index buffer of each context
+            - all remaining sokol-gfx resources (shader, default-texture and
               all pipeline objects) are destroyed
-            - the 3 memory buffers are freed
 
         sgl_draw():
-            - copy all recorded vertex data into the dynamic sokol-gfx buffer
-              via a call to sg_update_buffer()
+            - append all recorded vertex and index data of the context to its
+              sokol-gfx vertex and index buffer via sg_append_buffer(), if
+              a buffer has overflown in this frame, rendering is skipped
             - for each recorded command:
                 - if it's a viewport command, call sg_apply_viewport()
                 - if it's a scissor-rect command, call sg_apply_scissor_rect()
@@ -386,10 +521,11 @@
                     - depending on what has changed since the last draw command,
                       call sg_apply_pipeline(), sg_apply_bindings() and
                       sg_apply_uniforms()
-                    - finally call sg_draw()
+                    - finally call sg_draw() (which always renders indexed
+                      points, lines or triangles)
 
     All other functions only modify the internally tracked state, add
-    data to the vertex, uniform and command buffers, or manipulate
+    data to the vertex, index, uniform and command buffers, or manipulate
     the matrix stack.
 
     ON DRAW COMMAND MERGING
@@ -402,15 +538,94 @@
     state has changed" since the last sgl_end(), meaning:
 
     - no calls to sgl_apply_viewport() and sgl_apply_scissor_rect()
-    - the primitive type hasn't changed
-    - the primitive type isn't a 'strip type' (no line or triangle strip)
+    - the primitive type hasn't changed (since strips and quads are
+      converted into lists, lines and line strips count as the same
+      primitive type, and so do triangles, triangle strips and quads)
     - the pipeline state object hasn't changed
     - none of the matrices has changed
     - none of the texture state has changed
 
-    Merging a draw command simply means that the number of vertices
+    Merging a draw command simply means that the number of indices
     to render in the previous draw command will be incremented by the
-    number of vertices in the new draw command.
+    number of indices in the new draw command. An incomplete last line
+    or triangle in an sgl_begin/end pair is dropped, so that it doesn't
+    garble the following merged primitives.
+
+    VERTEX FORMATS
+    ==============
+    By default, vertices are stored as float3 position, float2 texture
+    coordinates and a packed RGBA8 color (24 bytes per vertex). To reduce
+    memory and upload bandwidth, a context can be created with a more
+    compact vertex format:
+
+        sgl_context ctx = sgl_make_context(&(sgl_context_desc_t){
+            ...
+            .vertex_format = SGL_VERTEXFORMAT_POS2F
+        });
+
+    (or for the default context, via sgl_desc_t.vertex_format)
+
+    The following vertex formats are available:
+
+        SGL_VERTEXFORMAT_POS3F_UV2F (24 bytes, the default)
+            float3 position, float2 texture coords, RGBA8 color
+
+        SGL_VERTEXFORMAT_POS3F_UV2US (20 bytes)
+            float3 position, 16-bit normalized texture coords, RGBA8 color,
+            texture coordinates are clamped to the range 0..1
+
+        SGL_VERTEXFORMAT_POS3H_UV2US (16 bytes)
+            half-float position, 16-bit normalized texture coords, RGBA8 color,
+            positions have reduced precision (about 3 decimal digits) and
+            a max range of +-65504, this format isn't supported on WebGL/GLES2
+
+        SGL_VERTEXFORMAT_POS2F (12 bytes)
+            float2 position, RGBA8 color, no texture coords, this is useful
+            for untextured 2D rendering like large point- or line-clouds,
+            the z coordinate is dropped (also in CPU transform mode), and
+            texturing is ignored (the default white texture is used instead)
+
+    All sgl_v*() functions work with all vertex formats, they convert
+    their arguments into the context's vertex format when the vertex is
+    recorded. All vertex formats use the same shader, the conversion
+    to the shader's float inputs happens in the GPU's vertex fetch stage.
+
+    Pipeline objects depend on the vertex format, so an sgl_pipeline
+    can only be used with contexts which have the same vertex format
+    as the context it was created for, and sgl_merge_context() requires
+    that both contexts have the same vertex format.
+
+    CPU TRANSFORM MODE
+    ==================
+    Since any matrix change prevents merging, code which sets a separate
+    modelview matrix for each object (typical for debug rendering) ends
+    up with one draw call per object. To fix this, a context can be created
+    in 'CPU transform mode':
+
+        sgl_context ctx = sgl_make_context(&(sgl_context_desc_t){
+            ...
+            .cpu_transform = true
+        });
+
+    ...or for the default context:
+
+        sgl_setup(&(sgl_desc_t){
+            ...
+            .cpu_transform = true
+        });
+
+    In CPU transform mode, each vertex is transformed by the current
+    modelview matrix on the CPU when it is recorded (using SSE or NEON
+    if available), and the uniform block only contains the projection and
+    texture matrix. This means that changing the modelview matrix no longer
+    prevents draw commands from being merged, only changes to the projection
+    or texture matrix do.
+
+    The tradeoff is more CPU work per vertex in exchange for fewer
+    draw calls, which is usually a win for many small objects. Note that
+    in CPU transform mode the modelview matrix must be an affine transform
+    (no projection), since the w component of the transformed vertex
+    is discarded.
 
     LICENSE
     =======
@@ -462,6 +677,9 @@ extern "C" {
 /* sokol_gl pipeline handle (created with sgl_make_pipeline()) */
 typedef struct sgl_pipeline { uint32_t id; } sgl_pipeline;
 
+/* a context handle (created with sgl_make_context()) */
+typedef struct sgl_context { uint32_t id; } sgl_context;
+
 /*
     sgl_error_t
 
@@ -475,16 +693,70 @@ typedef enum sgl_error_t {
     SGL_ERROR_COMMANDS_FULL,
     SGL_ERROR_STACK_OVERFLOW,
     SGL_ERROR_STACK_UNDERFLOW,
+    SGL_ERROR_NO_CONTEXT,
 } sgl_error_t;
 
-typedef struct sgl_desc_t {
+/*
+    sgl_vertex_format_t
+
+    The vertex layout used by a context (see VERTEX FORMATS).
+*/
+typedef enum sgl_vertex_format_t {
+    _SGL_VERTEXFORMAT_DEFAULT,      /* value 0 reserved for default-init */
+    SGL_VERTEXFORMAT_POS3F_UV2F,    /* 24 bytes: float3 position, float2 uv, ubyte4n color (default) */
+    SGL_VERTEXFORMAT_POS3F_UV2US,   /* 20 bytes: float3 position, ushort2n uv, ubyte4n color */
+    SGL_VERTEXFORMAT_POS3H_UV2US,   /* 16 bytes: half4 position, ushort2n uv, ubyte4n color */
+    SGL_VERTEXFORMAT_POS2F,         /* 12 bytes: float2 position, ubyte4n color, no uv */
+    _SGL_VERTEXFORMAT_NUM,
+    _SGL_VERTEXFORMAT_FORCE_U32 = 0x7FFFFFFF
+} sgl_vertex_format_t;
+
+/*
+    sgl_context_desc_t
+
+    Describes the initialization parameters of a rendering context.
+    Creating additional contexts is optional since sokol-gl
+    creates a default context (described by the same parameters
+    in sgl_desc_t).
+*/
+typedef struct sgl_context_desc_t {
     int max_vertices;       /* size for vertex buffer */
     int max_commands;       /* size of uniform- and command-buffers */
+    sg_pixel_format color_format;
+    sg_pixel_format depth_format;
+    int sample_count;
+    bool cpu_transform;     /* transform vertices by the modelview matrix on the CPU */
+    sgl_vertex_format_t vertex_format;  /* default is SGL_VERTEXFORMAT_POS3F_UV2F */
+} sgl_context_desc_t;
+
+/*
+    sgl_context_stats_t
+
+    Per-context statistics of the last 'frame', meaning everything
+    recorded between two calls to sgl_draw() or sgl_merge_context(),
+    query with sgl_context_stats().
+*/
+typedef struct sgl_context_stats_t {
+    int num_vertices;           /* number of recorded vertices */
+    int num_indices;            /* number of recorded indices */
+    int num_uniforms;           /* number of recorded uniform blocks */
+    int num_commands;           /* number of recorded commands */
+    int num_draw_calls;         /* number of sg_draw() calls issued (always 0 for merged contexts) */
+    int num_merged_contexts;    /* number of contexts merged into this context */
+    sgl_error_t error;          /* the error code before it was reset */
+} sgl_context_stats_t;
+
+typedef struct sgl_desc_t {
+    int max_vertices;       /* default context: size for vertex buffer */
+    int max_commands;       /* default context: size of uniform- and command-buffers */
+    int context_pool_size;  /* max number of contexts (including the default context), default is 4 */
     int pipeline_pool_size; /* size of the internal pipeline pool, default is 64 */
     sg_pixel_format color_format;
     sg_pixel_format depth_format;
     int sample_count;
     sg_face_winding face_winding; /* default front face winding is CCW */
+    bool cpu_transform;     /* default context: transform vertices by the modelview matrix on the CPU */
+    sgl_vertex_format_t vertex_format;  /* default context: vertex format, default is SGL_VERTEXFORMAT_POS3F_UV2F */
 } sgl_desc_t;
 
 /* setup/shutdown/misc */
@@ -495,8 +767,18 @@ SOKOL_API_DECL void sgl_defaults(void);
 SOKOL_API_DECL float sgl_rad(float deg);
 SOKOL_API_DECL float sgl_deg(float rad);
 
+/* context functions */
+SOKOL_API_DECL sgl_context sgl_make_context(const sgl_context_desc_t* desc);
+SOKOL_API_DECL void sgl_destroy_context(sgl_context ctx);
+SOKOL_API_DECL void sgl_set_context(sgl_context ctx);
+SOKOL_API_DECL sgl_context sgl_get_context(void);
+SOKOL_API_DECL sgl_context sgl_default_context(void);
+SOKOL_API_DECL void sgl_merge_context(sgl_context src);
+SOKOL_API_DECL sgl_context_stats_t sgl_context_stats(sgl_context ctx);
+
 /* create and destroy pipeline objects */
 SOKOL_API_DECL sgl_pipeline sgl_make_pipeline(const sg_pipeline_desc* desc);
+SOKOL_API_DECL sgl_pipeline sgl_context_make_pipeline(sgl_context ctx, const sg_pipeline_desc* desc);
 SOKOL_API_DECL void sgl_destroy_pipeline(sgl_pipeline pip);
 
 /* render state functions */
@@ -572,15 +854,19 @@ SOKOL_API_DECL void sgl_v3f_t2f_c4b(float x, float y, float z, float u, float v,
 SOKOL_API_DECL void sgl_v3f_t2f_c1i(float x, float y, float z, float u, float v, uint32_t rgba);
 SOKOL_API_DECL void sgl_end(void);
 
-/* render everything */
+/* render everything recorded in the current context */
 SOKOL_API_DECL void sgl_draw(void);
+/* render everything recorded in a specific context */
+SOKOL_API_DECL void sgl_context_draw(sgl_context ctx);
 
 #ifdef __cplusplus
 } /* extern "C" */
 
 /* reference-based equivalents for C++ */
 inline void sgl_setup(const sgl_desc_t& desc) { return sgl_setup(&desc); }
+inline sgl_context sgl_make_context(const sgl_context_desc_t& desc) { return sgl_make_context(&desc); }
 inline sgl_pipeline sgl_make_pipeline(const sg_pipeline_desc& desc) { return sgl_make_pipeline(&desc); }
+inline sgl_pipeline sgl_context_make_pipeline(sgl_context ctx, const sg_pipeline_desc& desc) { return sgl_context_make_pipeline(ctx, &desc); }
 #endif
 #endif /* SOKOL_GL_INCLUDED */
 
@@ -625,9 +911,25 @@ inline sgl_pipeline sgl_make_pipeline(const sg_pipeline_desc& desc) { return sgl
     #define SOKOL_UNREACHABLE SOKOL_ASSERT(false)
 #endif
 
+#if !defined(SGL_NO_SIMD)
+    #if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1))
+        #define _SGL_SSE (1)
+        #include <xmmintrin.h>
+    #elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+        #define _SGL_NEON (1)
+        #include <arm_neon.h>
+    #endif
+#endif
+
 #define _sgl_def(val, def) (((val) == 0) ? (def) : (val))
 #define _SGL_INIT_COOKIE (0xABCDABCD)
 
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    #define _SGL_HAS_THREADS (0)
+#else
+    #define _SGL_HAS_THREADS (1)
+#endif
+
 /*
     Embedded source code compiled with:
 
@@ -1958,12 +2260,33 @@ typedef enum {
     SGL_NUM_MATRIXMODES
 } _sgl_matrix_mode_t;
 
+/* SGL_VERTEXFORMAT_POS3F_UV2F */
 typedef struct {
     float pos[3];
     float uv[2];
     uint32_t rgba;
 } _sgl_vertex_t;
 
+/* SGL_VERTEXFORMAT_POS3F_UV2US */
+typedef struct {
+    float pos[3];
+    uint16_t uv[2];
+    uint32_t rgba;
+} _sgl_vertex_pos3f_uv2us_t;
+
+/* SGL_VERTEXFORMAT_POS3H_UV2US, the 4th position component is always 1.0 */
+typedef struct {
+    uint16_t pos[4];
+    uint16_t uv[2];
+    uint32_t rgba;
+} _sgl_vertex_pos3h_uv2us_t;
+
+/* SGL_VERTEXFORMAT_POS2F */
+typedef struct {
+    float pos[2];
+    uint32_t rgba;
+} _sgl_vertex_pos2f_t;
+
 typedef struct {
     float v[4][4];
 } _sgl_matrix_t;
@@ -1982,8 +2305,8 @@ typedef enum {
 typedef struct {
     sg_pipeline pip;
     sg_image img;
-    int base_vertex;
-    int num_vertices;
+    int base_element;
+    int num_elements;
     int uniform_index;
 } _sgl_draw_args_t;
 
@@ -2013,26 +2336,33 @@ typedef struct {
 #define _SGL_DEFAULT_PIPELINE_POOL_SIZE (64)
 #define _SGL_DEFAULT_MAX_VERTICES (1<<16)
 #define _SGL_DEFAULT_MAX_COMMANDS (1<<14)
+#define _SGL_DEFAULT_CONTEXT_POOL_SIZE (4)
 #define _SGL_SLOT_SHIFT (16)
 #define _SGL_MAX_POOL_SIZE (1<<_SGL_SLOT_SHIFT)
 #define _SGL_SLOT_MASK (_SGL_MAX_POOL_SIZE-1)
 
 typedef struct {
-    uint32_t init_cookie;
-    sgl_desc_t desc;
+    _sgl_slot_t slot;
+    sgl_context_desc_t desc;
 
     int num_vertices;
+    int num_indices;
     int num_uniforms;
     int num_commands;
     int cur_vertex;
+    int cur_index;
     int cur_uniform;
     int cur_command;
-    _sgl_vertex_t* vertices;
+    sg_index_type index_type;   /* 16-bit indices if max_vertices <= 65536, otherwise 32-bit */
+    int vertex_size;            /* size of one vertex in the context's vertex format */
+    uint8_t* vertices;
+    void* indices;
     _sgl_uniform_t* uniforms;
     _sgl_command_t* commands;
 
     /* state tracking */
     int base_vertex;
+    int base_index;
     int vtx_count;          /* number of times vtx function has been called, used for non-triangle primitives */
     sgl_error_t error;
     bool in_begin;
@@ -2042,14 +2372,16 @@ typedef struct {
     sg_image cur_img;
     bool texturing_enabled;
     bool matrix_dirty;      /* reset in sgl_end(), set in any of the matrix stack functions */
+    int num_merged_contexts;
+
+    /* statistics of the last draw or merge */
+    sgl_context_stats_t stats;
 
     /* sokol-gfx resources */
     sg_buffer vbuf;
-    sg_image def_img;   /* a default white texture */
-    sg_shader shd;
+    sg_buffer ibuf;
     sg_bindings bind;
-    sgl_pipeline def_pip;
-    _sgl_pipeline_pool_t pip_pool;
+    sgl_pipeline def_pip;   /* the default pipeline matches the context's pixel formats */
 
     /* pipeline stack */
     int pip_tos;
@@ -2059,9 +2391,45 @@ typedef struct {
     _sgl_matrix_mode_t cur_matrix_mode;
     int matrix_tos[SGL_NUM_MATRIXMODES];
     _sgl_matrix_t matrix_stack[SGL_NUM_MATRIXMODES][_SGL_MAX_STACK_DEPTH];
+} _sgl_context_t;
+
+typedef struct {
+    _sgl_pool_t pool;
+    _sgl_context_t* contexts;
+} _sgl_context_pool_t;
+
+typedef struct {
+    uint32_t init_cookie;
+    sgl_desc_t desc;
+
+    /* shared sokol-gfx resources */
+    sg_image def_img;   /* a default white texture */
+    sg_shader shd;
+    _sgl_pipeline_pool_t pip_pool;
+
+    /* contexts */
+    _sgl_context_pool_t context_pool;
+    sgl_context def_ctx_id;
 } _sgl_t;
 static _sgl_t _sgl;
 
+/* the current context is tracked per thread, so that different threads
+    can record into different contexts at the same time
+*/
+typedef struct {
+    sgl_context cur_ctx_id;
+    _sgl_context_t* cur_ctx;    /* may be 0 if the current context was destroyed */
+} _sgl_thread_t;
+#if _SGL_HAS_THREADS
+#if defined(_MSC_VER)
+static __declspec(thread) _sgl_thread_t _sgl_thread;
+#else
+static __thread _sgl_thread_t _sgl_thread;
+#endif
+#else
+static _sgl_thread_t _sgl_thread;
+#endif
+
 /*== PRIVATE FUNCTIONS =======================================================*/
 
 static void _sgl_init_pool(_sgl_pool_t* pool, int num) {
@@ -2145,6 +2513,22 @@ static void _sgl_discard_pipeline_pool(void) {
     _sgl_discard_pool(&_sgl.pip_pool.pool);
 }
 
+static void _sgl_setup_context_pool(const sgl_desc_t* desc) {
+    SOKOL_ASSERT(desc);
+    /* note: the pools here will have an additional item, since slot 0 is reserved */
+    SOKOL_ASSERT((desc->context_pool_size > 0) && (desc->context_pool_size < _SGL_MAX_POOL_SIZE));
+    _sgl_init_pool(&_sgl.context_pool.pool, desc->context_pool_size);
+    size_t pool_byte_size = sizeof(_sgl_context_t) * _sgl.context_pool.pool.size;
+    _sgl.context_pool.contexts = (_sgl_context_t*) SOKOL_MALLOC(pool_byte_size);
+    SOKOL_ASSERT(_sgl.context_pool.contexts);
+    memset(_sgl.context_pool.contexts, 0, pool_byte_size);
+}
+
+static void _sgl_discard_context_pool(void) {
+    SOKOL_FREE(_sgl.context_pool.contexts); _sgl.context_pool.contexts = 0;
+    _sgl_discard_pool(&_sgl.context_pool.pool);
+}
+
 /* allocate the slot at slot_index:
     - bump the slot's generation counter
     - create a resource id from the generation counter and slot index
@@ -2212,34 +2596,101 @@ static sgl_pipeline _sgl_alloc_pipeline(void) {
     return res;
 }
 
-static void _sgl_init_pipeline(sgl_pipeline pip_id, const sg_pipeline_desc* in_desc) {
-    SOKOL_ASSERT((pip_id.id != SG_INVALID_ID) && in_desc);
+/* the index type depends on the number of vertices a context can hold */
+static sg_index_type _sgl_index_type(const sgl_context_desc_t* ctx_desc) {
+    return (ctx_desc->max_vertices <= (1<<16)) ? SG_INDEXTYPE_UINT16 : SG_INDEXTYPE_UINT32;
+}
+
+static int _sgl_index_size(sg_index_type index_type) {
+    return (SG_INDEXTYPE_UINT16 == index_type) ? 2 : 4;
+}
+
+/* returns true for primitive types which are converted into lists via the index buffer */
+static bool _sgl_is_emulated_prim_type(_sgl_primitive_type_t prim_type) {
+    return (SGL_PRIMITIVETYPE_LINE_STRIP == prim_type) ||
+           (SGL_PRIMITIVETYPE_TRIANGLE_STRIP == prim_type) ||
+           (SGL_PRIMITIVETYPE_QUADS == prim_type);
+}
+
+/* the list primitive type an emulated primitive type is rendered with */
+static _sgl_primitive_type_t _sgl_list_prim_type(_sgl_primitive_type_t prim_type) {
+    switch (prim_type) {
+        case SGL_PRIMITIVETYPE_LINE_STRIP:
+            return SGL_PRIMITIVETYPE_LINES;
+        case SGL_PRIMITIVETYPE_TRIANGLE_STRIP:
+        case SGL_PRIMITIVETYPE_QUADS:
+            return SGL_PRIMITIVETYPE_TRIANGLES;
+        default:
+            return prim_type;
+    }
+}
+
+static int _sgl_vertex_size(sgl_vertex_format_t fmt) {
+    switch (fmt) {
+        case SGL_VERTEXFORMAT_POS3F_UV2US:  return sizeof(_sgl_vertex_pos3f_uv2us_t);
+        case SGL_VERTEXFORMAT_POS3H_UV2US:  return sizeof(_sgl_vertex_pos3h_uv2us_t);
+        case SGL_VERTEXFORMAT_POS2F:        return sizeof(_sgl_vertex_pos2f_t);
+        default:                            return sizeof(_sgl_vertex_t);
+    }
+}
+
+/* all vertex formats use the same shader, the vertex fetch stage converts
+    the compact formats into the float vertex shader inputs
+*/
+static void _sgl_init_vertex_layout(sg_layout_desc* layout, sgl_vertex_format_t fmt) {
+    sg_vertex_attr_desc* pos = &layout->attrs[0];
+    sg_vertex_attr_desc* uv = &layout->attrs[1];
+    sg_vertex_attr_desc* rgba = &layout->attrs[2];
+    layout->buffers[0].stride = _sgl_vertex_size(fmt);
+    switch (fmt) {
+        case SGL_VERTEXFORMAT_POS3F_UV2US:
+            pos->offset = offsetof(_sgl_vertex_pos3f_uv2us_t, pos);
+            pos->format = SG_VERTEXFORMAT_FLOAT3;
+            uv->offset = offsetof(_sgl_vertex_pos3f_uv2us_t, uv);
+            uv->format = SG_VERTEXFORMAT_USHORT2N;
+            rgba->offset = offsetof(_sgl_vertex_pos3f_uv2us_t, rgba);
+            break;
+        case SGL_VERTEXFORMAT_POS3H_UV2US:
+            pos->offset = offsetof(_sgl_vertex_pos3h_uv2us_t, pos);
+            pos->format = SG_VERTEXFORMAT_HALF4;
+            uv->offset = offsetof(_sgl_vertex_pos3h_uv2us_t, uv);
+            uv->format = SG_VERTEXFORMAT_USHORT2N;
+            rgba->offset = offsetof(_sgl_vertex_pos3h_uv2us_t, rgba);
+            break;
+        case SGL_VERTEXFORMAT_POS2F:
+            pos->offset = offsetof(_sgl_vertex_pos2f_t, pos);
+            pos->format = SG_VERTEXFORMAT_FLOAT2;
+            /* the shader still needs a texcoord input, but since texturing
+               is disabled for this vertex format the values don't matter
+            */
+            uv->offset = offsetof(_sgl_vertex_pos2f_t, rgba);
+            uv->format = SG_VERTEXFORMAT_UBYTE4N;
+            rgba->offset = offsetof(_sgl_vertex_pos2f_t, rgba);
+            break;
+        default:
+            pos->offset = offsetof(_sgl_vertex_t, pos);
+            pos->format = SG_VERTEXFORMAT_FLOAT3;
+            uv->offset = offsetof(_sgl_vertex_t, uv);
+            uv->format = SG_VERTEXFORMAT_FLOAT2;
+            rgba->offset = offsetof(_sgl_vertex_t, rgba);
+            break;
+    }
+    rgba->format = SG_VERTEXFORMAT_UBYTE4N;
+}
+
+static void _sgl_init_pipeline(sgl_pipeline pip_id, const sg_pipeline_desc* in_desc, const sgl_context_desc_t* ctx_desc) {
+    SOKOL_ASSERT((pip_id.id != SG_INVALID_ID) && in_desc && ctx_desc);
 
     /* create a new desc with 'patched' shader and pixel format state */
     sg_pipeline_desc desc = *in_desc;
-    desc.layout.buffers[0].stride = sizeof(_sgl_vertex_t);
-    {
-        sg_vertex_attr_desc* pos = &desc.layout.attrs[0];
-        pos->offset = offsetof(_sgl_vertex_t, pos);
-        pos->format = SG_VERTEXFORMAT_FLOAT3;
-    }
-    {
-        sg_vertex_attr_desc* uv = &desc.layout.attrs[1];
-        uv->offset = offsetof(_sgl_vertex_t, uv);
-        uv->format = SG_VERTEXFORMAT_FLOAT2;
-    }
-    {
-        sg_vertex_attr_desc* rgba = &desc.layout.attrs[2];
-        rgba->offset = offsetof(_sgl_vertex_t, rgba);
-        rgba->format = SG_VERTEXFORMAT_UBYTE4N;
-    }
+    _sgl_init_vertex_layout(&desc.layout, ctx_desc->vertex_format);
     if (in_desc->shader.id == SG_INVALID_ID) {
         desc.shader = _sgl.shd;
     }
-    desc.index_type = SG_INDEXTYPE_NONE;
-    desc.blend.color_format = _sgl.desc.color_format;
-    desc.blend.depth_format = _sgl.desc.depth_format;
-    desc.rasterizer.sample_count = _sgl.desc.sample_count;
+    desc.index_type = _sgl_index_type(ctx_desc);
+    desc.blend.color_format = ctx_desc->color_format;
+    desc.blend.depth_format = ctx_desc->depth_format;
+    desc.rasterizer.sample_count = ctx_desc->sample_count;
     if (desc.rasterizer.face_winding == _SG_FACEWINDING_DEFAULT) {
         desc.rasterizer.face_winding = _sgl.desc.face_winding;
     }
@@ -2256,22 +2707,18 @@ static void _sgl_init_pipeline(sgl_pipeline pip_id, const sg_pipeline_desc* in_d
                 desc.primitive_type = SG_PRIMITIVETYPE_POINTS;
                 break;
             case SGL_PRIMITIVETYPE_LINES:
-                desc.primitive_type = SG_PRIMITIVETYPE_LINES;
-                break;
             case SGL_PRIMITIVETYPE_LINE_STRIP:
-                desc.primitive_type = SG_PRIMITIVETYPE_LINE_STRIP;
+                desc.primitive_type = SG_PRIMITIVETYPE_LINES;
                 break;
             case SGL_PRIMITIVETYPE_TRIANGLES:
-                desc.primitive_type = SG_PRIMITIVETYPE_TRIANGLES;
-                break;
             case SGL_PRIMITIVETYPE_TRIANGLE_STRIP:
             case SGL_PRIMITIVETYPE_QUADS:
-                desc.primitive_type = SG_PRIMITIVETYPE_TRIANGLE_STRIP;
+                desc.primitive_type = SG_PRIMITIVETYPE_TRIANGLES;
                 break;
         }
-        if (SGL_PRIMITIVETYPE_QUADS == i) {
-            /* quads are emulated via triangles, use the same pipeline object */
-            pip->pip[i] = pip->pip[SGL_PRIMITIVETYPE_TRIANGLES];
+        if (_sgl_is_emulated_prim_type((_sgl_primitive_type_t)i)) {
+            /* quads and strips are emulated via indexed lines and triangles, use the same pipeline object */
+            pip->pip[i] = pip->pip[_sgl_list_prim_type((_sgl_primitive_type_t)i)];
         }
         else {
             pip->pip[i] = sg_make_pipeline(&desc);
@@ -2283,11 +2730,11 @@ static void _sgl_init_pipeline(sgl_pipeline pip_id, const sg_pipeline_desc* in_d
     }
 }
 
-static sgl_pipeline _sgl_make_pipeline(const sg_pipeline_desc* desc) {
-    SOKOL_ASSERT(desc);
+static sgl_pipeline _sgl_make_pipeline(const sg_pipeline_desc* desc, const sgl_context_desc_t* ctx_desc) {
+    SOKOL_ASSERT(desc && ctx_desc);
     sgl_pipeline pip_id = _sgl_alloc_pipeline();
     if (pip_id.id != SG_INVALID_ID) {
-        _sgl_init_pipeline(pip_id, desc);
+        _sgl_init_pipeline(pip_id, desc, ctx_desc);
     }
     else {
         SOKOL_LOG("sokol_gl.h: pipeline pool exhausted!");
@@ -2299,7 +2746,7 @@ static void _sgl_destroy_pipeline(sgl_pipeline pip_id) {
     _sgl_pipeline_t* pip = _sgl_lookup_pipeline(pip_id.id);
     if (pip) {
         for (int i = 0; i < SGL_NUM_PRIMITIVE_TYPES; i++) {
-            if (i != SGL_PRIMITIVETYPE_QUADS) {
+            if (!_sgl_is_emulated_prim_type((_sgl_primitive_type_t)i)) {
                 sg_destroy_pipeline(pip->pip[i]);
             }
         }
@@ -2319,57 +2766,87 @@ static sg_pipeline _sgl_get_pipeline(sgl_pipeline pip_id, _sgl_primitive_type_t
     }
 }
 
-static inline void _sgl_begin(_sgl_primitive_type_t mode) {
-    _sgl.in_begin = true;
-    _sgl.base_vertex = _sgl.cur_vertex;
-    _sgl.vtx_count = 0;
-    _sgl.cur_prim_type = mode;
+static inline void _sgl_begin(_sgl_context_t* ctx, _sgl_primitive_type_t mode) {
+    ctx->in_begin = true;
+    ctx->base_vertex = ctx->cur_vertex;
+    ctx->base_index = ctx->cur_index;
+    ctx->vtx_count = 0;
+    ctx->cur_prim_type = mode;
 }
 
-static void _sgl_rewind(void) {
-    _sgl.base_vertex = 0;
-    _sgl.cur_vertex = 0;
-    _sgl.cur_uniform = 0;
-    _sgl.cur_command = 0;
-    _sgl.error = SGL_NO_ERROR;
-    _sgl.matrix_dirty = true;
+static void _sgl_rewind(_sgl_context_t* ctx) {
+    ctx->base_vertex = 0;
+    ctx->base_index = 0;
+    ctx->cur_vertex = 0;
+    ctx->cur_index = 0;
+    ctx->cur_uniform = 0;
+    ctx->cur_command = 0;
+    ctx->error = SGL_NO_ERROR;
+    ctx->matrix_dirty = true;
+    ctx->num_merged_contexts = 0;
 }
 
-static inline _sgl_vertex_t* _sgl_next_vertex(void) {
-    if (_sgl.cur_vertex < _sgl.num_vertices) {
-        return &_sgl.vertices[_sgl.cur_vertex++];
+static void _sgl_update_stats(_sgl_context_t* ctx, int num_draw_calls) {
+    ctx->stats.num_vertices = ctx->cur_vertex;
+    ctx->stats.num_indices = ctx->cur_index;
+    ctx->stats.num_uniforms = ctx->cur_uniform;
+    ctx->stats.num_commands = ctx->cur_command;
+    ctx->stats.num_draw_calls = num_draw_calls;
+    ctx->stats.num_merged_contexts = ctx->num_merged_contexts;
+    ctx->stats.error = ctx->error;
+}
+
+static inline void* _sgl_next_vertex(_sgl_context_t* ctx) {
+    if (ctx->cur_vertex < ctx->num_vertices) {
+        return &ctx->vertices[(ctx->cur_vertex++) * ctx->vertex_size];
     }
     else {
-        _sgl.error = SGL_ERROR_VERTICES_FULL;
+        ctx->error = SGL_ERROR_VERTICES_FULL;
         return 0;
     }
 }
 
-static inline _sgl_uniform_t* _sgl_next_uniform(void) {
-    if (_sgl.cur_uniform < _sgl.num_uniforms) {
-        return &_sgl.uniforms[_sgl.cur_uniform++];
+/* the index buffer is sized so that it shouldn't run out of space before the
+    vertex buffer, but this is still checked at runtime like the vertices
+*/
+static inline void _sgl_index(_sgl_context_t* ctx, uint32_t index) {
+    if (ctx->cur_index >= ctx->num_indices) {
+        ctx->error = SGL_ERROR_VERTICES_FULL;
+        return;
+    }
+    if (SG_INDEXTYPE_UINT16 == ctx->index_type) {
+        ((uint16_t*)ctx->indices)[ctx->cur_index++] = (uint16_t) index;
     }
     else {
-        _sgl.error = SGL_ERROR_UNIFORMS_FULL;
+        ((uint32_t*)ctx->indices)[ctx->cur_index++] = index;
+    }
+}
+
+static inline _sgl_uniform_t* _sgl_next_uniform(_sgl_context_t* ctx) {
+    if (ctx->cur_uniform < ctx->num_uniforms) {
+        return &ctx->uniforms[ctx->cur_uniform++];
+    }
+    else {
+        ctx->error = SGL_ERROR_UNIFORMS_FULL;
         return 0;
     }
 }
 
-static inline _sgl_command_t* _sgl_prev_command(void) {
-    if (_sgl.cur_command > 0) {
-        return &_sgl.commands[_sgl.cur_command - 1];
+static inline _sgl_command_t* _sgl_prev_command(_sgl_context_t* ctx) {
+    if (ctx->cur_command > 0) {
+        return &ctx->commands[ctx->cur_command - 1];
     }
     else {
         return 0;
     }
 }
 
-static inline _sgl_command_t* _sgl_next_command(void) {
-    if (_sgl.cur_command < _sgl.num_commands) {
-        return &_sgl.commands[_sgl.cur_command++];
+static inline _sgl_command_t* _sgl_next_command(_sgl_context_t* ctx) {
+    if (ctx->cur_command < ctx->num_commands) {
+        return &ctx->commands[ctx->cur_command++];
     }
     else {
-        _sgl.error = SGL_ERROR_COMMANDS_FULL;
+        ctx->error = SGL_ERROR_COMMANDS_FULL;
         return 0;
     }
 }
@@ -2392,26 +2869,167 @@ static inline uint32_t _sgl_pack_rgbaf(float r, float g, float b, float a) {
     return _sgl_pack_rgbab(r_u8, g_u8, b_u8, a_u8);
 }
 
-static inline void _sgl_vtx(float x, float y, float z, float u, float v, uint32_t rgba) {
-    SOKOL_ASSERT(_sgl.in_begin);
-    _sgl_vertex_t* vtx;
-    /* handle non-native primitive types */
-    if ((_sgl.cur_prim_type == SGL_PRIMITIVETYPE_QUADS) && ((_sgl.vtx_count & 3) == 3)) {
-        /* for quads, before writing the last quad vertex, reuse
-           the first and third vertex to start the second triangle in the quad
-        */
-        vtx = _sgl_next_vertex();
-        if (vtx) { *vtx = *(vtx - 3); }
-        vtx = _sgl_next_vertex();
-        if (vtx) { *vtx = *(vtx - 2); }
+/* current top-of-stack projection matrix */
+static inline _sgl_matrix_t* _sgl_matrix_projection(_sgl_context_t* ctx) {
+    return &ctx->matrix_stack[SGL_MATRIXMODE_PROJECTION][ctx->matrix_tos[SGL_MATRIXMODE_PROJECTION]];
+}
+
+/* get top-of-stack modelview matrix */
+static inline _sgl_matrix_t* _sgl_matrix_modelview(_sgl_context_t* ctx) {
+    return &ctx->matrix_stack[SGL_MATRIXMODE_MODELVIEW][ctx->matrix_tos[SGL_MATRIXMODE_MODELVIEW]];
+}
+
+/* get top-of-stack texture matrix */
+static inline _sgl_matrix_t* _sgl_matrix_texture(_sgl_context_t* ctx) {
+    return &ctx->matrix_stack[SGL_MATRIXMODE_TEXTURE][ctx->matrix_tos[SGL_MATRIXMODE_TEXTURE]];
+}
+
+/* get pointer to current top-of-stack of current matrix mode */
+static inline _sgl_matrix_t* _sgl_matrix(_sgl_context_t* ctx) {
+    return &ctx->matrix_stack[ctx->cur_matrix_mode][ctx->matrix_tos[ctx->cur_matrix_mode]];
+}
+
+/* called by all functions which modify the current matrix */
+static inline void _sgl_matrix_changed(_sgl_context_t* ctx) {
+    /* in CPU transform mode, the modelview matrix isn't part of the uniform block */
+    if (!(ctx->desc.cpu_transform && (ctx->cur_matrix_mode == SGL_MATRIXMODE_MODELVIEW))) {
+        ctx->matrix_dirty = true;
     }
-    vtx = _sgl_next_vertex();
-    if (vtx) {
-        vtx->pos[0] = x; vtx->pos[1] = y; vtx->pos[2] = z;
-        vtx->uv[0] = u; vtx->uv[1] = v;
-        vtx->rgba = rgba;
+}
+
+/* transform a position by a matrix (which is expected to be affine), used in CPU transform mode */
+static inline void _sgl_transform_pos(float* dst, const _sgl_matrix_t* m, float x, float y, float z) {
+    #if defined(_SGL_SSE)
+        __m128 p = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(m->v[0]), _mm_set1_ps(x)), _mm_loadu_ps(m->v[3]));
+        p = _mm_add_ps(p, _mm_mul_ps(_mm_loadu_ps(m->v[1]), _mm_set1_ps(y)));
+        p = _mm_add_ps(p, _mm_mul_ps(_mm_loadu_ps(m->v[2]), _mm_set1_ps(z)));
+        float res[4];
+        _mm_storeu_ps(res, p);
+        dst[0] = res[0]; dst[1] = res[1]; dst[2] = res[2];
+    #elif defined(_SGL_NEON)
+        float32x4_t p = vmlaq_n_f32(vld1q_f32(m->v[3]), vld1q_f32(m->v[0]), x);
+        p = vmlaq_n_f32(p, vld1q_f32(m->v[1]), y);
+        p = vmlaq_n_f32(p, vld1q_f32(m->v[2]), z);
+        dst[0] = vgetq_lane_f32(p, 0); dst[1] = vgetq_lane_f32(p, 1); dst[2] = vgetq_lane_f32(p, 2);
+    #else
+        for (int r = 0; r < 3; r++) {
+            dst[r] = m->v[0][r]*x + m->v[1][r]*y + m->v[2][r]*z + m->v[3][r];
+        }
+    #endif
+}
+
+/* convert a texture coordinate to 16-bit normalized, range is clamped to 0..1 */
+static inline uint16_t _sgl_unorm16(float v) {
+    return (uint16_t) (_sgl_clamp(v, 0.0f, 1.0f) * 65535.0f + 0.5f);
+}
+
+/* convert a float to a half-float (round-to-nearest, denormals are flushed to zero) */
+#define _SGL_HALF_ONE (0x3C00)
+static inline uint16_t _sgl_half(float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    const uint16_t sign = (uint16_t) ((u >> 16) & 0x8000);
+    const int32_t exp = (int32_t) ((u >> 23) & 0xFF) - 127 + 15;
+    const uint32_t mant = u & 0x007FFFFF;
+    if (exp <= 0) {
+        return sign;
+    }
+    else if (exp >= 31) {
+        /* overflow to infinity, NaN stays NaN */
+        const bool is_nan = (((u >> 23) & 0xFF) == 0xFF) && (mant != 0);
+        return (uint16_t) (sign | 0x7C00 | (is_nan ? 0x0200 : 0));
+    }
+    else {
+        /* rounding may carry over into the exponent, which is the correct result */
+        uint32_t h = ((uint32_t)exp << 10) | (mant >> 13);
+        h += (mant >> 12) & 1;
+        if (h >= 0x7C00) {
+            h = 0x7C00;
+        }
+        return (uint16_t) (sign | h);
+    }
+}
+
+static inline void _sgl_vtx(_sgl_context_t* ctx, float x, float y, float z, float u, float v, uint32_t rgba) {
+    SOKOL_ASSERT(ctx->in_begin);
+    void* ptr = _sgl_next_vertex(ctx);
+    if (ptr) {
+        float pos[3];
+        if (ctx->desc.cpu_transform) {
+            _sgl_transform_pos(pos, _sgl_matrix_modelview(ctx), x, y, z);
+        }
+        else {
+            pos[0] = x; pos[1] = y; pos[2] = z;
+        }
+        switch (ctx->desc.vertex_format) {
+            case SGL_VERTEXFORMAT_POS3F_UV2US:
+                {
+                    _sgl_vertex_pos3f_uv2us_t* vtx = (_sgl_vertex_pos3f_uv2us_t*) ptr;
+                    vtx->pos[0] = pos[0]; vtx->pos[1] = pos[1]; vtx->pos[2] = pos[2];
+                    vtx->uv[0] = _sgl_unorm16(u); vtx->uv[1] = _sgl_unorm16(v);
+                    vtx->rgba = rgba;
+                }
+                break;
+            case SGL_VERTEXFORMAT_POS3H_UV2US:
+                {
+                    _sgl_vertex_pos3h_uv2us_t* vtx = (_sgl_vertex_pos3h_uv2us_t*) ptr;
+                    vtx->pos[0] = _sgl_half(pos[0]); vtx->pos[1] = _sgl_half(pos[1]); vtx->pos[2] = _sgl_half(pos[2]);
+                    vtx->pos[3] = _SGL_HALF_ONE;
+                    vtx->uv[0] = _sgl_unorm16(u); vtx->uv[1] = _sgl_unorm16(v);
+                    vtx->rgba = rgba;
+                }
+                break;
+            case SGL_VERTEXFORMAT_POS2F:
+                {
+                    _sgl_vertex_pos2f_t* vtx = (_sgl_vertex_pos2f_t*) ptr;
+                    vtx->pos[0] = pos[0]; vtx->pos[1] = pos[1];
+                    vtx->rgba = rgba;
+                }
+                break;
+            default:
+                {
+                    _sgl_vertex_t* vtx = (_sgl_vertex_t*) ptr;
+                    vtx->pos[0] = pos[0]; vtx->pos[1] = pos[1]; vtx->pos[2] = pos[2];
+                    vtx->uv[0] = u; vtx->uv[1] = v;
+                    vtx->rgba = rgba;
+                }
+                break;
+        }
+
+        /* only unique vertices are stored, quads and strips are converted
+           into lists of lines or triangles via the index buffer
+        */
+        const uint32_t i = (uint32_t) (ctx->cur_vertex - 1);
+        const int n = ctx->vtx_count;
+        switch (ctx->cur_prim_type) {
+            case SGL_PRIMITIVETYPE_LINE_STRIP:
+                if (n >= 1) {
+                    _sgl_index(ctx, i - 1); _sgl_index(ctx, i);
+                }
+                break;
+            case SGL_PRIMITIVETYPE_TRIANGLE_STRIP:
+                /* every second triangle has flipped winding */
+                if (n >= 2) {
+                    if (n & 1) {
+                        _sgl_index(ctx, i - 1); _sgl_index(ctx, i - 2); _sgl_index(ctx, i);
+                    }
+                    else {
+                        _sgl_index(ctx, i - 2); _sgl_index(ctx, i - 1); _sgl_index(ctx, i);
+                    }
+                }
+                break;
+            case SGL_PRIMITIVETYPE_QUADS:
+                if ((n & 3) == 3) {
+                    _sgl_index(ctx, i - 3); _sgl_index(ctx, i - 2); _sgl_index(ctx, i - 1);
+                    _sgl_index(ctx, i - 3); _sgl_index(ctx, i - 1); _sgl_index(ctx, i);
+                }
+                break;
+            default:
+                _sgl_index(ctx, i);
+                break;
+        }
     }
-    _sgl.vtx_count++;
+    ctx->vtx_count++;
 }
 
 static void _sgl_identity(_sgl_matrix_t* m) {
@@ -2604,24 +3222,289 @@ static void _sgl_lookat(_sgl_matrix_t* dst,
     _sgl_translate(dst, -eye_x, -eye_y, -eye_z);
 }
 
-/* current top-of-stack projection matrix */
-static inline _sgl_matrix_t* _sgl_matrix_projection(void) {
-    return &_sgl.matrix_stack[SGL_MATRIXMODE_PROJECTION][_sgl.matrix_tos[SGL_MATRIXMODE_PROJECTION]];
+/* get context pointer without id-check */
+static _sgl_context_t* _sgl_context_at(uint32_t ctx_id) {
+    SOKOL_ASSERT(SG_INVALID_ID != ctx_id);
+    int slot_index = _sgl_slot_index(ctx_id);
+    SOKOL_ASSERT((slot_index > _SGL_INVALID_SLOT_INDEX) && (slot_index < _sgl.context_pool.pool.size));
+    return &_sgl.context_pool.contexts[slot_index];
 }
 
-/* get top-of-stack modelview matrix */
-static inline _sgl_matrix_t* _sgl_matrix_modelview(void) {
-    return &_sgl.matrix_stack[SGL_MATRIXMODE_MODELVIEW][_sgl.matrix_tos[SGL_MATRIXMODE_MODELVIEW]];
+/* get context pointer with id-check, returns 0 if no match */
+static _sgl_context_t* _sgl_lookup_context(uint32_t ctx_id) {
+    if (SG_INVALID_ID != ctx_id) {
+        _sgl_context_t* ctx = _sgl_context_at(ctx_id);
+        if (ctx->slot.id == ctx_id) {
+            return ctx;
+        }
+    }
+    return 0;
 }
 
-/* get top-of-stack texture matrix */
-static inline _sgl_matrix_t* _sgl_matrix_texture(void) {
-    return &_sgl.matrix_stack[SGL_MATRIXMODE_TEXTURE][_sgl.matrix_tos[SGL_MATRIXMODE_TEXTURE]];
+/* get the current context of this thread, returns 0 if the context has been
+    destroyed in the meantime (possibly on another thread, which can't reset
+    this thread's cached pointer, so the slot id is checked on each call)
+*/
+static _sgl_context_t* _sgl_cur_ctx(void) {
+    _sgl_context_t* ctx = _sgl_thread.cur_ctx;
+    if (ctx && (ctx->slot.id != _sgl_thread.cur_ctx_id.id)) {
+        ctx = 0;
+        _sgl_thread.cur_ctx = 0;
+    }
+    return ctx;
 }
 
-/* get pointer to current top-of-stack of current matrix mode */
-static inline _sgl_matrix_t* _sgl_matrix(void) {
-    return &_sgl.matrix_stack[_sgl.cur_matrix_mode][_sgl.matrix_tos[_sgl.cur_matrix_mode]];
+/* make context id from uint32_t id */
+static sgl_context _sgl_make_ctx_id(uint32_t ctx_id) {
+    sgl_context ctx;
+    ctx.id = ctx_id;
+    return ctx;
+}
+
+static sgl_context _sgl_alloc_context(void) {
+    sgl_context res;
+    int slot_index = _sgl_pool_alloc_index(&_sgl.context_pool.pool);
+    if (_SGL_INVALID_SLOT_INDEX != slot_index) {
+        res = _sgl_make_ctx_id(_sgl_slot_alloc(&_sgl.context_pool.pool, &_sgl.context_pool.contexts[slot_index].slot, slot_index));
+    }
+    else {
+        /* pool is exhausted */
+        res = _sgl_make_ctx_id(SG_INVALID_ID);
+    }
+    return res;
+}
+
+static void _sgl_init_context(sgl_context ctx_id, const sgl_context_desc_t* in_desc) {
+    SOKOL_ASSERT((ctx_id.id != SG_INVALID_ID) && in_desc);
+    _sgl_context_t* ctx = _sgl_lookup_context(ctx_id.id);
+    SOKOL_ASSERT(ctx && (ctx->slot.state == SG_RESOURCESTATE_ALLOC));
+    ctx->desc = *in_desc;
+    ctx->desc.max_vertices = _sgl_def(ctx->desc.max_vertices, _SGL_DEFAULT_MAX_VERTICES);
+    ctx->desc.max_commands = _sgl_def(ctx->desc.max_commands, _SGL_DEFAULT_MAX_COMMANDS);
+    ctx->desc.vertex_format = _sgl_def(ctx->desc.vertex_format, SGL_VERTEXFORMAT_POS3F_UV2F);
+
+    /* allocate buffers */
+    ctx->num_vertices = ctx->desc.max_vertices;
+    ctx->num_indices = 3 * ctx->num_vertices;   /* worst case are triangle strips */
+    ctx->index_type = _sgl_index_type(&ctx->desc);
+    ctx->num_uniforms = ctx->desc.max_commands;
+    ctx->num_commands = ctx->num_uniforms;
+    ctx->vertex_size = _sgl_vertex_size(ctx->desc.vertex_format);
+    ctx->vertices = (uint8_t*) SOKOL_MALLOC(ctx->num_vertices * ctx->vertex_size);
+    SOKOL_ASSERT(ctx->vertices);
+    ctx->indices = SOKOL_MALLOC(ctx->num_indices * _sgl_index_size(ctx->index_type));
+    SOKOL_ASSERT(ctx->indices);
+    ctx->uniforms = (_sgl_uniform_t*) SOKOL_MALLOC(ctx->num_uniforms * sizeof(_sgl_uniform_t));
+    SOKOL_ASSERT(ctx->uniforms);
+    ctx->commands = (_sgl_command_t*) SOKOL_MALLOC(ctx->num_commands * sizeof(_sgl_command_t));
+    SOKOL_ASSERT(ctx->commands);
+
+    /* create sokol-gfx resource objects */
+    sg_push_debug_group("sokol-gl");
+    sg_buffer_desc vbuf_desc;
+    memset(&vbuf_desc, 0, sizeof(vbuf_desc));
+    vbuf_desc.size = ctx->num_vertices * ctx->vertex_size;
+    vbuf_desc.type = SG_BUFFERTYPE_VERTEXBUFFER;
+    vbuf_desc.usage = SG_USAGE_STREAM;
+    vbuf_desc.label = "sgl-vertex-buffer";
+    ctx->vbuf = sg_make_buffer(&vbuf_desc);
+    SOKOL_ASSERT(SG_INVALID_ID != ctx->vbuf.id);
+
+    sg_buffer_desc ibuf_desc;
+    memset(&ibuf_desc, 0, sizeof(ibuf_desc));
+    ibuf_desc.size = ctx->num_indices * _sgl_index_size(ctx->index_type);
+    ibuf_desc.type = SG_BUFFERTYPE_INDEXBUFFER;
+    ibuf_desc.usage = SG_USAGE_STREAM;
+    ibuf_desc.label = "sgl-index-buffer";
+    ctx->ibuf = sg_make_buffer(&ibuf_desc);
+    SOKOL_ASSERT(SG_INVALID_ID != ctx->ibuf.id);
+
+    /* create the default pipeline object for the context's pixel formats */
+    sg_pipeline_desc def_pip_desc;
+    memset(&def_pip_desc, 0, sizeof(def_pip_desc));
+    def_pip_desc.depth_stencil.depth_write_enabled = true;
+    ctx->def_pip = _sgl_make_pipeline(&def_pip_desc, &ctx->desc);
+    sg_pop_debug_group();
+
+    /* default state */
+    ctx->rgba = 0xFFFFFFFF;
+    ctx->cur_img = _sgl.def_img;
+    for (int i = 0; i < SGL_NUM_MATRIXMODES; i++) {
+        _sgl_identity(&ctx->matrix_stack[i][0]);
+    }
+    ctx->pip_stack[0] = ctx->def_pip;
+    ctx->matrix_dirty = true;
+    ctx->slot.state = SG_RESOURCESTATE_VALID;
+}
+
+static sgl_context _sgl_make_context(const sgl_context_desc_t* desc) {
+    SOKOL_ASSERT(desc);
+    sgl_context ctx_id = _sgl_alloc_context();
+    if (ctx_id.id != SG_INVALID_ID) {
+        _sgl_init_context(ctx_id, desc);
+    }
+    else {
+        SOKOL_LOG("sokol_gl.h: context pool exhausted!");
+    }
+    return ctx_id;
+}
+
+static void _sgl_destroy_context(sgl_context ctx_id) {
+    _sgl_context_t* ctx = _sgl_lookup_context(ctx_id.id);
+    if (ctx) {
+        SOKOL_FREE(ctx->vertices);
+        SOKOL_FREE(ctx->indices);
+        SOKOL_FREE(ctx->uniforms);
+        SOKOL_FREE(ctx->commands);
+        sg_push_debug_group("sokol-gl");
+        sg_destroy_buffer(ctx->vbuf);
+        sg_destroy_buffer(ctx->ibuf);
+        _sgl_destroy_pipeline(ctx->def_pip);
+        sg_pop_debug_group();
+        memset(ctx, 0, sizeof(_sgl_context_t));
+        _sgl_pool_free_index(&_sgl.context_pool.pool, _sgl_slot_index(ctx_id.id));
+    }
+}
+
+/* render the recorded commands of a context, the vertex and index data is
+    appended to the context's vertex and index buffer, so that a context can
+    be rendered into several passes per frame
+*/
+static void _sgl_draw(_sgl_context_t* ctx) {
+    SOKOL_ASSERT(ctx);
+    int num_draw_calls = 0;
+    if ((ctx->error == SGL_NO_ERROR) && (ctx->cur_index > 0) && (ctx->cur_command > 0)) {
+        uint32_t cur_pip_id = SG_INVALID_ID;
+        uint32_t cur_img_id = SG_INVALID_ID;
+        int cur_uniform_index = -1;
+        sg_push_debug_group("sokol-gl");
+        const int vbuf_offset = sg_append_buffer(ctx->vbuf, ctx->vertices, ctx->cur_vertex * ctx->vertex_size);
+        const int ibuf_offset = sg_append_buffer(ctx->ibuf, ctx->indices, ctx->cur_index * _sgl_index_size(ctx->index_type));
+        /* if a buffer has overflown this frame, all draw calls would be dropped anyway */
+        if (!sg_query_buffer_overflow(ctx->vbuf) && !sg_query_buffer_overflow(ctx->ibuf)) {
+            ctx->bind.vertex_buffers[0] = ctx->vbuf;
+            ctx->bind.vertex_buffer_offsets[0] = vbuf_offset;
+            ctx->bind.index_buffer = ctx->ibuf;
+            ctx->bind.index_buffer_offset = ibuf_offset;
+            for (int i = 0; i < ctx->cur_command; i++) {
+                const _sgl_command_t* cmd = &ctx->commands[i];
+                switch (cmd->cmd) {
+                    case SGL_COMMAND_VIEWPORT:
+                        {
+                            const _sgl_viewport_args_t* args = &cmd->args.viewport;
+                            sg_apply_viewport(args->x, args->y, args->w, args->h, args->origin_top_left);
+                        }
+                        break;
+                    case SGL_COMMAND_SCISSOR_RECT:
+                        {
+                            const _sgl_scissor_rect_args_t* args = &cmd->args.scissor_rect;
+                            sg_apply_scissor_rect(args->x, args->y, args->w, args->h, args->origin_top_left);
+                        }
+                        break;
+                    case SGL_COMMAND_DRAW:
+                        {
+                            const _sgl_draw_args_t* args = &cmd->args.draw;
+                            if (args->pip.id != cur_pip_id) {
+                                sg_apply_pipeline(args->pip);
+                                cur_pip_id = args->pip.id;
+                                /* when pipeline changes, also need to re-apply uniforms and bindings */
+                                cur_img_id = SG_INVALID_ID;
+                                cur_uniform_index = -1;
+                            }
+                            if (cur_img_id != args->img.id) {
+                                ctx->bind.fs_images[0] = args->img;
+                                sg_apply_bindings(&ctx->bind);
+                                cur_img_id = args->img.id;
+                            }
+                            if (cur_uniform_index != args->uniform_index) {
+                                sg_apply_uniforms(SG_SHADERSTAGE_VS, 0, &ctx->uniforms[args->uniform_index], sizeof(_sgl_uniform_t));
+                                cur_uniform_index = args->uniform_index;
+                            }
+                            if (args->num_elements > 0) {
+                                sg_draw(args->base_element, args->num_elements, 1);
+                                num_draw_calls++;
+                            }
+                        }
+                        break;
+                }
+            }
+        }
+        sg_pop_debug_group();
+    }
+    _sgl_update_stats(ctx, num_draw_calls);
+    _sgl_rewind(ctx);
+}
+
+/* append the recorded vertices, uniforms and commands of the src context
+    to the dst context, and rewind the src context
+*/
+static void _sgl_merge_context(_sgl_context_t* dst, _sgl_context_t* src) {
+    SOKOL_ASSERT(dst && src && (dst != src));
+    SOKOL_ASSERT(!dst->in_begin && !src->in_begin);
+    /* the recorded data can only be appended if the vertex layout, index
+        type and pipeline pixel formats are identical, otherwise the vertex
+        memcpy() below would overflow or misinterpret the vertex data
+    */
+    const bool compatible = (dst->desc.color_format == src->desc.color_format) &&
+                            (dst->desc.depth_format == src->desc.depth_format) &&
+                            (dst->desc.sample_count == src->desc.sample_count) &&
+                            (dst->index_type == src->index_type) &&
+                            (dst->desc.vertex_format == src->desc.vertex_format) &&
+                            (dst->vertex_size == src->vertex_size);
+    if (!compatible) {
+        SOKOL_LOG("sokol_gl.h: sgl_merge_context(): contexts have different pixel formats, sample count, vertex format or index type, merge skipped");
+    }
+    else if ((src->error == SGL_NO_ERROR) && (dst->error == SGL_NO_ERROR) && (src->cur_command > 0)) {
+        if ((dst->cur_vertex + src->cur_vertex) > dst->num_vertices) {
+            dst->error = SGL_ERROR_VERTICES_FULL;
+        }
+        else if ((dst->cur_index + src->cur_index) > dst->num_indices) {
+            /* this can only happen if dst has less vertex capacity than src */
+            dst->error = SGL_ERROR_VERTICES_FULL;
+        }
+        else if ((dst->cur_uniform + src->cur_uniform) > dst->num_uniforms) {
+            dst->error = SGL_ERROR_UNIFORMS_FULL;
+        }
+        else if ((dst->cur_command + src->cur_command) > dst->num_commands) {
+            dst->error = SGL_ERROR_COMMANDS_FULL;
+        }
+        else {
+            memcpy(&dst->vertices[dst->cur_vertex * dst->vertex_size], src->vertices, src->cur_vertex * src->vertex_size);
+            const uint32_t vertex_offset = (uint32_t) dst->cur_vertex;
+            if (SG_INDEXTYPE_UINT16 == dst->index_type) {
+                const uint16_t* src_indices = (const uint16_t*) src->indices;
+                uint16_t* dst_indices = ((uint16_t*)dst->indices) + dst->cur_index;
+                for (int i = 0; i < src->cur_index; i++) {
+                    dst_indices[i] = (uint16_t) (src_indices[i] + vertex_offset);
+                }
+            }
+            else {
+                const uint32_t* src_indices = (const uint32_t*) src->indices;
+                uint32_t* dst_indices = ((uint32_t*)dst->indices) + dst->cur_index;
+                for (int i = 0; i < src->cur_index; i++) {
+                    dst_indices[i] = src_indices[i] + vertex_offset;
+                }
+            }
+            memcpy(&dst->uniforms[dst->cur_uniform], src->uniforms, src->cur_uniform * sizeof(_sgl_uniform_t));
+            for (int i = 0; i < src->cur_command; i++) {
+                _sgl_command_t* cmd = &dst->commands[dst->cur_command + i];
+                *cmd = src->commands[i];
+                if (cmd->cmd == SGL_COMMAND_DRAW) {
+                    cmd->args.draw.base_element += dst->cur_index;
+                    cmd->args.draw.uniform_index += dst->cur_uniform;
+                }
+            }
+            dst->cur_vertex += src->cur_vertex;
+            dst->cur_index += src->cur_index;
+            dst->cur_uniform += src->cur_uniform;
+            dst->cur_command += src->cur_command;
+            /* the next draw command in dst must not be merged into a command from src */
+            dst->matrix_dirty = true;
+            dst->num_merged_contexts++;
+        }
+    }
+    _sgl_update_stats(src, 0);
+    _sgl_rewind(src);
 }
 
 /*== PUBLIC FUNCTIONS ========================================================*/
@@ -2631,34 +3514,18 @@ SOKOL_API_IMPL void sgl_setup(const sgl_desc_t* desc) {
     _sgl.init_cookie = _SGL_INIT_COOKIE;
     _sgl.desc = *desc;
     _sgl.desc.pipeline_pool_size = _sgl_def(_sgl.desc.pipeline_pool_size, _SGL_DEFAULT_PIPELINE_POOL_SIZE);
+    _sgl.desc.context_pool_size = _sgl_def(_sgl.desc.context_pool_size, _SGL_DEFAULT_CONTEXT_POOL_SIZE);
     _sgl.desc.max_vertices = _sgl_def(_sgl.desc.max_vertices, _SGL_DEFAULT_MAX_VERTICES);
     _sgl.desc.max_commands = _sgl_def(_sgl.desc.max_commands, _SGL_DEFAULT_MAX_COMMANDS);
     _sgl.desc.face_winding = _sgl_def(_sgl.desc.face_winding, SG_FACEWINDING_CCW);
 
-    /* allocate buffers and pools */
-    _sgl.num_vertices = _sgl.desc.max_vertices;
-    _sgl.num_uniforms = _sgl.desc.max_commands;
-    _sgl.num_commands = _sgl.num_uniforms;
-    _sgl.vertices = (_sgl_vertex_t*) SOKOL_MALLOC(_sgl.num_vertices * sizeof(_sgl_vertex_t));
-    SOKOL_ASSERT(_sgl.vertices);
-    _sgl.uniforms = (_sgl_uniform_t*) SOKOL_MALLOC(_sgl.num_uniforms * sizeof(_sgl_uniform_t));
-    SOKOL_ASSERT(_sgl.uniforms);
-    _sgl.commands = (_sgl_command_t*) SOKOL_MALLOC(_sgl.num_commands * sizeof(_sgl_command_t));
-    SOKOL_ASSERT(_sgl.commands);
+    /* allocate pools */
     _sgl_setup_pipeline_pool(&_sgl.desc);
+    _sgl_setup_context_pool(&_sgl.desc);
 
-    /* create sokol-gfx resource objects */
+    /* create shared sokol-gfx resource objects */
     sg_push_debug_group("sokol-gl");
 
-    sg_buffer_desc vbuf_desc;
-    memset(&vbuf_desc, 0, sizeof(vbuf_desc));
-    vbuf_desc.size = _sgl.num_vertices * sizeof(_sgl_vertex_t);
-    vbuf_desc.type = SG_BUFFERTYPE_VERTEXBUFFER;
-    vbuf_desc.usage = SG_USAGE_STREAM;
-    vbuf_desc.label = "sgl-vertex-buffer";
-    _sgl.vbuf = sg_make_buffer(&vbuf_desc);
-    SOKOL_ASSERT(SG_INVALID_ID != _sgl.vbuf.id);
-
     uint32_t pixels[64];
     for (int i = 0; i < 64; i++) {
         pixels[i] = 0xFFFFFFFF;
@@ -2677,7 +3544,6 @@ SOKOL_API_IMPL void sgl_setup(const sgl_desc_t* desc) {
     img_desc.label = "sgl-default-texture";
     _sgl.def_img = sg_make_image(&img_desc);
     SOKOL_ASSERT(SG_INVALID_ID != _sgl.def_img.id);
-    _sgl.cur_img = _sgl.def_img;
 
     sg_shader_desc shd_desc;
     memset(&shd_desc, 0, sizeof(shd_desc));
@@ -2737,35 +3603,35 @@ SOKOL_API_IMPL void sgl_setup(const sgl_desc_t* desc) {
         shd_desc.fs.byte_code = _sgl_fs_bytecode_wgpu;
         shd_desc.fs.byte_code_size = sizeof(_sgl_fs_bytecode_wgpu);
     #else
-        shd_desc.vs.source = _sgl_vs_src_dummy;
-        shd_desc.fs.source = _sgl_fs_src_dummy;
+        shd_desc.vs.source = _sgl_vs_source_dummy;
+        shd_desc.fs.source = _sgl_fs_source_dummy;
     #endif
     _sgl.shd = sg_make_shader(&shd_desc);
     SOKOL_ASSERT(SG_INVALID_ID != _sgl.shd.id);
-
-    /* create default pipeline object */
-    sg_pipeline_desc def_pip_desc;
-    memset(&def_pip_desc, 0, sizeof(def_pip_desc));
-    def_pip_desc.depth_stencil.depth_write_enabled = true;
-    _sgl.def_pip = _sgl_make_pipeline(&def_pip_desc);
     sg_pop_debug_group();
 
-    /* default state */
-    _sgl.rgba = 0xFFFFFFFF;
-    for (int i = 0; i < SGL_NUM_MATRIXMODES; i++) {
-        _sgl_identity(&_sgl.matrix_stack[i][0]);
-    }
-    _sgl.pip_stack[0] = _sgl.def_pip;
-    _sgl.matrix_dirty = true;
+    /* create the default context */
+    sgl_context_desc_t ctx_desc;
+    memset(&ctx_desc, 0, sizeof(ctx_desc));
+    ctx_desc.max_vertices = _sgl.desc.max_vertices;
+    ctx_desc.max_commands = _sgl.desc.max_commands;
+    ctx_desc.color_format = _sgl.desc.color_format;
+    ctx_desc.depth_format = _sgl.desc.depth_format;
+    ctx_desc.sample_count = _sgl.desc.sample_count;
+    ctx_desc.cpu_transform = _sgl.desc.cpu_transform;
+    ctx_desc.vertex_format = _sgl.desc.vertex_format;
+    _sgl.def_ctx_id = _sgl_make_context(&ctx_desc);
+    SOKOL_ASSERT(SG_INVALID_ID != _sgl.def_ctx_id.id);
+    sgl_set_context(_sgl.def_ctx_id);
 }
 
 SOKOL_API_IMPL void sgl_shutdown(void) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    SOKOL_FREE(_sgl.vertices); _sgl.vertices = 0;
-    SOKOL_FREE(_sgl.uniforms); _sgl.uniforms = 0;
-    SOKOL_FREE(_sgl.commands); _sgl.commands = 0;
+    for (int i = 0; i < _sgl.context_pool.pool.size; i++) {
+        _sgl_context_t* ctx = &_sgl.context_pool.contexts[i];
+        _sgl_destroy_context(_sgl_make_ctx_id(ctx->slot.id));
+    }
     sg_push_debug_group("sokol-gl");
-    sg_destroy_buffer(_sgl.vbuf);
     sg_destroy_image(_sgl.def_img);
     sg_destroy_shader(_sgl.shd);
     for (int i = 0; i < _sgl.pip_pool.pool.size; i++) {
@@ -2773,12 +3639,20 @@ SOKOL_API_IMPL void sgl_shutdown(void) {
         _sgl_destroy_pipeline(_sgl_make_pip_id(pip->slot.id));
     }
     sg_pop_debug_group();
+    _sgl_discard_context_pool();
     _sgl_discard_pipeline_pool();
+    memset(&_sgl_thread, 0, sizeof(_sgl_thread));
     _sgl.init_cookie = 0;
 }
 
 SOKOL_API_IMPL sgl_error_t sgl_error(void) {
-    return _sgl.error;
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (ctx) {
+        return ctx->error;
+    }
+    else {
+        return SGL_ERROR_NO_CONTEXT;
+    }
 }
 
 SOKOL_API_IMPL float sgl_rad(float deg) {
@@ -2789,9 +3663,82 @@ SOKOL_API_IMPL float sgl_deg(float rad) {
     return (rad * 180.0f) / (float)M_PI;
 }
 
+SOKOL_API_IMPL sgl_context sgl_make_context(const sgl_context_desc_t* desc) {
+    SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
+    return _sgl_make_context(desc);
+}
+
+SOKOL_API_IMPL void sgl_destroy_context(sgl_context ctx_id) {
+    SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
+    if (ctx_id.id == _sgl.def_ctx_id.id) {
+        SOKOL_LOG("sokol_gl.h: cannot destroy the default context");
+        return;
+    }
+    _sgl_destroy_context(ctx_id);
+    /* re-validate the current context pointer (this will return 0 if the current context was destroyed) */
+    _sgl_thread.cur_ctx = _sgl_lookup_context(_sgl_thread.cur_ctx_id.id);
+}
+
+SOKOL_API_IMPL void sgl_set_context(sgl_context ctx_id) {
+    SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
+    SOKOL_ASSERT(!(_sgl_cur_ctx() && _sgl_thread.cur_ctx->in_begin));
+    _sgl_thread.cur_ctx_id = ctx_id;
+    _sgl_thread.cur_ctx = _sgl_lookup_context(ctx_id.id);
+}
+
+SOKOL_API_IMPL sgl_context sgl_get_context(void) {
+    SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
+    return _sgl_thread.cur_ctx_id;
+}
+
+SOKOL_API_IMPL sgl_context sgl_default_context(void) {
+    SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
+    return _sgl.def_ctx_id;
+}
+
+SOKOL_API_IMPL void sgl_merge_context(sgl_context src_id) {
+    SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
+    _sgl_context_t* dst = _sgl_cur_ctx();
+    _sgl_context_t* src = _sgl_lookup_context(src_id.id);
+    if (dst && src && (dst != src)) {
+        _sgl_merge_context(dst, src);
+    }
+}
+
+SOKOL_API_IMPL sgl_context_stats_t sgl_context_stats(sgl_context ctx_id) {
+    SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
+    const _sgl_context_t* ctx = _sgl_lookup_context(ctx_id.id);
+    if (ctx) {
+        return ctx->stats;
+    }
+    else {
+        sgl_context_stats_t res;
+        memset(&res, 0, sizeof(res));
+        res.error = SGL_ERROR_NO_CONTEXT;
+        return res;
+    }
+}
+
 SOKOL_API_IMPL sgl_pipeline sgl_make_pipeline(const sg_pipeline_desc* desc) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    return _sgl_make_pipeline(desc);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (ctx) {
+        return _sgl_make_pipeline(desc, &ctx->desc);
+    }
+    else {
+        return _sgl_make_pip_id(SG_INVALID_ID);
+    }
+}
+
+SOKOL_API_IMPL sgl_pipeline sgl_context_make_pipeline(sgl_context ctx_id, const sg_pipeline_desc* desc) {
+    SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
+    const _sgl_context_t* ctx = _sgl_lookup_context(ctx_id.id);
+    if (ctx) {
+        return _sgl_make_pipeline(desc, &ctx->desc);
+    }
+    else {
+        return _sgl_make_pip_id(SG_INVALID_ID);
+    }
 }
 
 SOKOL_API_IMPL void sgl_destroy_pipeline(sgl_pipeline pip_id) {
@@ -2801,56 +3748,80 @@ SOKOL_API_IMPL void sgl_destroy_pipeline(sgl_pipeline pip_id) {
 
 SOKOL_API_IMPL void sgl_load_pipeline(sgl_pipeline pip_id) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    SOKOL_ASSERT((_sgl.pip_tos >= 0) && (_sgl.pip_tos < _SGL_MAX_STACK_DEPTH));
-    _sgl.pip_stack[_sgl.pip_tos] = pip_id;
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    SOKOL_ASSERT((ctx->pip_tos >= 0) && (ctx->pip_tos < _SGL_MAX_STACK_DEPTH));
+    ctx->pip_stack[ctx->pip_tos] = pip_id;
 }
 
 SOKOL_API_IMPL void sgl_default_pipeline(void) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    SOKOL_ASSERT((_sgl.pip_tos >= 0) && (_sgl.pip_tos < _SGL_MAX_STACK_DEPTH));
-    _sgl.pip_stack[_sgl.pip_tos] = _sgl.def_pip;
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    SOKOL_ASSERT((ctx->pip_tos >= 0) && (ctx->pip_tos < _SGL_MAX_STACK_DEPTH));
+    ctx->pip_stack[ctx->pip_tos] = ctx->def_pip;
 }
 
 SOKOL_API_IMPL void sgl_push_pipeline(void) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    if (_sgl.pip_tos < (_SGL_MAX_STACK_DEPTH - 1)) {
-        _sgl.pip_tos++;
-        _sgl.pip_stack[_sgl.pip_tos] = _sgl.pip_stack[_sgl.pip_tos-1];
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    if (ctx->pip_tos < (_SGL_MAX_STACK_DEPTH - 1)) {
+        ctx->pip_tos++;
+        ctx->pip_stack[ctx->pip_tos] = ctx->pip_stack[ctx->pip_tos-1];
     }
     else {
-        _sgl.error = SGL_ERROR_STACK_OVERFLOW;
+        ctx->error = SGL_ERROR_STACK_OVERFLOW;
     }
 }
 
 SOKOL_API_IMPL void sgl_pop_pipeline(void) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    if (_sgl.pip_tos > 0) {
-        _sgl.pip_tos--;
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    if (ctx->pip_tos > 0) {
+        ctx->pip_tos--;
     }
     else {
-        _sgl.error = SGL_ERROR_STACK_UNDERFLOW;
+        ctx->error = SGL_ERROR_STACK_UNDERFLOW;
     }
 }
 
 SOKOL_API_IMPL void sgl_defaults(void) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    SOKOL_ASSERT(!_sgl.in_begin);
-    _sgl.u = 0.0f; _sgl.v = 0.0f;
-    _sgl.rgba = 0xFFFFFFFF;
-    _sgl.texturing_enabled = false;
-    _sgl.cur_img = _sgl.def_img;
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    SOKOL_ASSERT(!ctx->in_begin);
+    ctx->u = 0.0f; ctx->v = 0.0f;
+    ctx->rgba = 0xFFFFFFFF;
+    ctx->texturing_enabled = false;
+    ctx->cur_img = _sgl.def_img;
     sgl_default_pipeline();
-    _sgl_identity(_sgl_matrix_texture());
-    _sgl_identity(_sgl_matrix_modelview());
-    _sgl_identity(_sgl_matrix_projection());
-    _sgl.cur_matrix_mode = SGL_MATRIXMODE_MODELVIEW;
-    _sgl.matrix_dirty = true;
+    _sgl_identity(_sgl_matrix_texture(ctx));
+    _sgl_identity(_sgl_matrix_modelview(ctx));
+    _sgl_identity(_sgl_matrix_projection(ctx));
+    ctx->cur_matrix_mode = SGL_MATRIXMODE_MODELVIEW;
+    ctx->matrix_dirty = true;
 }
 
 SOKOL_API_IMPL void sgl_viewport(int x, int y, int w, int h, bool origin_top_left) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    SOKOL_ASSERT(!_sgl.in_begin);
-    _sgl_command_t* cmd = _sgl_next_command();
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    SOKOL_ASSERT(!ctx->in_begin);
+    _sgl_command_t* cmd = _sgl_next_command(ctx);
     if (cmd) {
         cmd->cmd = SGL_COMMAND_VIEWPORT;
         cmd->args.viewport.x = x;
@@ -2863,8 +3834,12 @@ SOKOL_API_IMPL void sgl_viewport(int x, int y, int w, int h, bool origin_top_lef
 
 SOKOL_API_IMPL void sgl_scissor_rect(int x, int y, int w, int h, bool origin_top_left) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    SOKOL_ASSERT(!_sgl.in_begin);
-    _sgl_command_t* cmd = _sgl_next_command();
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    SOKOL_ASSERT(!ctx->in_begin);
+    _sgl_command_t* cmd = _sgl_next_command(ctx);
     if (cmd) {
         cmd->cmd = SGL_COMMAND_SCISSOR_RECT;
         cmd->args.scissor_rect.x = x;
@@ -2877,86 +3852,144 @@ SOKOL_API_IMPL void sgl_scissor_rect(int x, int y, int w, int h, bool origin_top
 
 SOKOL_API_IMPL void sgl_enable_texture(void) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    SOKOL_ASSERT(!_sgl.in_begin);
-    _sgl.texturing_enabled = true;
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    SOKOL_ASSERT(!ctx->in_begin);
+    ctx->texturing_enabled = true;
 }
 
 SOKOL_API_IMPL void sgl_disable_texture(void) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    SOKOL_ASSERT(!_sgl.in_begin);
-    _sgl.texturing_enabled = false;
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    SOKOL_ASSERT(!ctx->in_begin);
+    ctx->texturing_enabled = false;
 }
 
 SOKOL_API_IMPL void sgl_texture(sg_image img) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    SOKOL_ASSERT(!_sgl.in_begin);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    SOKOL_ASSERT(!ctx->in_begin);
     if (SG_INVALID_ID != img.id) {
-        _sgl.cur_img = img;
+        ctx->cur_img = img;
     }
     else {
-        _sgl.cur_img = _sgl.def_img;
+        ctx->cur_img = _sgl.def_img;
     }
 }
 
 SOKOL_API_IMPL void sgl_begin_points(void) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    SOKOL_ASSERT(!_sgl.in_begin);
-    _sgl_begin(SGL_PRIMITIVETYPE_POINTS);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    SOKOL_ASSERT(!ctx->in_begin);
+    _sgl_begin(ctx, SGL_PRIMITIVETYPE_POINTS);
 }
 
 SOKOL_API_IMPL void sgl_begin_lines(void) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    SOKOL_ASSERT(!_sgl.in_begin);
-    _sgl_begin(SGL_PRIMITIVETYPE_LINES);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    SOKOL_ASSERT(!ctx->in_begin);
+    _sgl_begin(ctx, SGL_PRIMITIVETYPE_LINES);
 }
 
 SOKOL_API_IMPL void sgl_begin_line_strip(void) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    SOKOL_ASSERT(!_sgl.in_begin);
-    _sgl_begin(SGL_PRIMITIVETYPE_LINE_STRIP);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    SOKOL_ASSERT(!ctx->in_begin);
+    _sgl_begin(ctx, SGL_PRIMITIVETYPE_LINE_STRIP);
 }
 
 SOKOL_API_IMPL void sgl_begin_triangles(void) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    SOKOL_ASSERT(!_sgl.in_begin);
-    _sgl_begin(SGL_PRIMITIVETYPE_TRIANGLES);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    SOKOL_ASSERT(!ctx->in_begin);
+    _sgl_begin(ctx, SGL_PRIMITIVETYPE_TRIANGLES);
 }
 
 SOKOL_API_IMPL void sgl_begin_triangle_strip(void) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    SOKOL_ASSERT(!_sgl.in_begin);
-    _sgl_begin(SGL_PRIMITIVETYPE_TRIANGLE_STRIP);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    SOKOL_ASSERT(!ctx->in_begin);
+    _sgl_begin(ctx, SGL_PRIMITIVETYPE_TRIANGLE_STRIP);
 }
 
 SOKOL_API_IMPL void sgl_begin_quads(void) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    SOKOL_ASSERT(!_sgl.in_begin);
-    _sgl_begin(SGL_PRIMITIVETYPE_QUADS);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    SOKOL_ASSERT(!ctx->in_begin);
+    _sgl_begin(ctx, SGL_PRIMITIVETYPE_QUADS);
 }
 
 SOKOL_API_IMPL void sgl_end(void) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    SOKOL_ASSERT(_sgl.in_begin);
-    SOKOL_ASSERT(_sgl.cur_vertex >= _sgl.base_vertex);
-    _sgl.in_begin = false;
-    bool matrix_dirty = _sgl.matrix_dirty;
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    SOKOL_ASSERT(ctx->in_begin);
+    SOKOL_ASSERT(ctx->cur_vertex >= ctx->base_vertex);
+    SOKOL_ASSERT(ctx->cur_index >= ctx->base_index);
+    ctx->in_begin = false;
+    /* drop the indices of an incomplete last primitive, so that it doesn't
+       garble the following primitives when draw commands are merged
+    */
+    int num_elements = ctx->cur_index - ctx->base_index;
+    if (SGL_PRIMITIVETYPE_LINES == ctx->cur_prim_type) {
+        num_elements -= num_elements % 2;
+    }
+    else if (SGL_PRIMITIVETYPE_TRIANGLES == ctx->cur_prim_type) {
+        num_elements -= num_elements % 3;
+    }
+    ctx->cur_index = ctx->base_index + num_elements;
+    bool matrix_dirty = ctx->matrix_dirty;
     if (matrix_dirty) {
-        _sgl.matrix_dirty = false;
-        _sgl_uniform_t* uni = _sgl_next_uniform();
+        ctx->matrix_dirty = false;
+        _sgl_uniform_t* uni = _sgl_next_uniform(ctx);
         if (uni) {
-            _sgl_matmul4(&uni->mvp, _sgl_matrix_projection(), _sgl_matrix_modelview());
-            uni->tm = *_sgl_matrix_texture();
+            if (ctx->desc.cpu_transform) {
+                /* vertices are already in view space */
+                uni->mvp = *_sgl_matrix_projection(ctx);
+            }
+            else {
+                _sgl_matmul4(&uni->mvp, _sgl_matrix_projection(ctx), _sgl_matrix_modelview(ctx));
+            }
+            uni->tm = *_sgl_matrix_texture(ctx);
         }
     }
     /* check if command can be merged with previous command */
-    sg_pipeline pip = _sgl_get_pipeline(_sgl.pip_stack[_sgl.pip_tos], _sgl.cur_prim_type);
-    sg_image img = _sgl.texturing_enabled ? _sgl.cur_img : _sgl.def_img;
-    _sgl_command_t* prev_cmd = _sgl_prev_command();
+    sg_pipeline pip = _sgl_get_pipeline(ctx->pip_stack[ctx->pip_tos], ctx->cur_prim_type);
+    /* the POS2F vertex format has no texture coordinates */
+    const bool has_uv = (SGL_VERTEXFORMAT_POS2F != ctx->desc.vertex_format);
+    sg_image img = (ctx->texturing_enabled && has_uv) ? ctx->cur_img : _sgl.def_img;
+    _sgl_command_t* prev_cmd = _sgl_prev_command(ctx);
     bool merge_cmd = false;
     if (prev_cmd) {
         if ((prev_cmd->cmd == SGL_COMMAND_DRAW) &&
-            (_sgl.cur_prim_type != SGL_PRIMITIVETYPE_LINE_STRIP) &&
-            (_sgl.cur_prim_type != SGL_PRIMITIVETYPE_TRIANGLE_STRIP) &&
             !matrix_dirty &&
             (prev_cmd->args.draw.img.id == img.id) &&
             (prev_cmd->args.draw.pip.id == pip.id))
@@ -2966,314 +3999,462 @@ SOKOL_API_IMPL void sgl_end(void) {
     }
     if (merge_cmd) {
         /* draw command can be merged with the previous command */
-        prev_cmd->args.draw.num_vertices += _sgl.cur_vertex - _sgl.base_vertex;
+        prev_cmd->args.draw.num_elements += num_elements;
     }
     else {
         /* append a new draw command */
-        _sgl_command_t* cmd = _sgl_next_command();
+        _sgl_command_t* cmd = _sgl_next_command(ctx);
         if (cmd) {
-            SOKOL_ASSERT(_sgl.cur_uniform > 0);
+            SOKOL_ASSERT(ctx->cur_uniform > 0);
             cmd->cmd = SGL_COMMAND_DRAW;
             cmd->args.draw.img = img;
-            cmd->args.draw.pip = _sgl_get_pipeline(_sgl.pip_stack[_sgl.pip_tos], _sgl.cur_prim_type);
-            cmd->args.draw.base_vertex = _sgl.base_vertex;
-            cmd->args.draw.num_vertices = _sgl.cur_vertex - _sgl.base_vertex;
-            cmd->args.draw.uniform_index = _sgl.cur_uniform - 1;
+            cmd->args.draw.pip = pip;
+            cmd->args.draw.base_element = ctx->base_index;
+            cmd->args.draw.num_elements = num_elements;
+            cmd->args.draw.uniform_index = ctx->cur_uniform - 1;
         }
     }
 }
 
 SOKOL_API_IMPL void sgl_t2f(float u, float v) {
-    _sgl.u = u; _sgl.v = v;
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    ctx->u = u; ctx->v = v;
 }
 
 SOKOL_API_IMPL void sgl_c3f(float r, float g, float b) {
-    _sgl.rgba = _sgl_pack_rgbaf(r, g, b, 1.0f);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    ctx->rgba = _sgl_pack_rgbaf(r, g, b, 1.0f);
 }
 
 SOKOL_API_IMPL void sgl_c4f(float r, float g, float b, float a) {
-    _sgl.rgba = _sgl_pack_rgbaf(r, g, b, a);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    ctx->rgba = _sgl_pack_rgbaf(r, g, b, a);
 }
 
 SOKOL_API_IMPL void sgl_c3b(uint8_t r, uint8_t g, uint8_t b) {
-    _sgl.rgba = _sgl_pack_rgbab(r, g, b, 255);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    ctx->rgba = _sgl_pack_rgbab(r, g, b, 255);
 }
 
 SOKOL_API_IMPL void sgl_c4b(uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
-    _sgl.rgba = _sgl_pack_rgbab(r, g, b, a);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    ctx->rgba = _sgl_pack_rgbab(r, g, b, a);
 }
 
 SOKOL_API_IMPL void sgl_c1i(uint32_t rgba) {
-    _sgl.rgba = rgba;
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    ctx->rgba = rgba;
 }
 
 SOKOL_API_IMPL void sgl_v2f(float x, float y) {
-    _sgl_vtx(x, y, 0.0f, _sgl.u, _sgl.v, _sgl.rgba);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_vtx(ctx, x, y, 0.0f, ctx->u, ctx->v, ctx->rgba);
 }
 
 SOKOL_API_IMPL void sgl_v3f(float x, float y, float z) {
-    _sgl_vtx(x, y, z, _sgl.u, _sgl.v, _sgl.rgba);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_vtx(ctx, x, y, z, ctx->u, ctx->v, ctx->rgba);
 }
 
 SOKOL_API_IMPL void sgl_v2f_t2f(float x, float y, float u, float v) {
-    _sgl_vtx(x, y, 0.0f, u, v, _sgl.rgba);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_vtx(ctx, x, y, 0.0f, u, v, ctx->rgba);
 }
 
 SOKOL_API_IMPL void sgl_v3f_t2f(float x, float y, float z, float u, float v) {
-    _sgl_vtx(x, y, z, u, v, _sgl.rgba);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_vtx(ctx, x, y, z, u, v, ctx->rgba);
 }
 
 SOKOL_API_IMPL void sgl_v2f_c3f(float x, float y, float r, float g, float b) {
-    _sgl_vtx(x, y, 0.0f, _sgl.u, _sgl.v, _sgl_pack_rgbaf(r, g, b, 1.0f));
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_vtx(ctx, x, y, 0.0f, ctx->u, ctx->v, _sgl_pack_rgbaf(r, g, b, 1.0f));
 }
 
 SOKOL_API_IMPL void sgl_v2f_c3b(float x, float y, uint8_t r, uint8_t g, uint8_t b) {
-    _sgl_vtx(x, y, 0.0f, _sgl.u, _sgl.v, _sgl_pack_rgbab(r, g, b, 255));
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_vtx(ctx, x, y, 0.0f, ctx->u, ctx->v, _sgl_pack_rgbab(r, g, b, 255));
 }
 
 SOKOL_API_IMPL void sgl_v2f_c4f(float x, float y, float r, float g, float b, float a) {
-    _sgl_vtx(x, y, 0.0f, _sgl.u, _sgl.v, _sgl_pack_rgbaf(r, g, b, a));
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_vtx(ctx, x, y, 0.0f, ctx->u, ctx->v, _sgl_pack_rgbaf(r, g, b, a));
 }
 
 SOKOL_API_IMPL void sgl_v2f_c4b(float x, float y, uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
-    _sgl_vtx(x, y, 0.0f, _sgl.u, _sgl.v, _sgl_pack_rgbab(r, g, b, a));
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_vtx(ctx, x, y, 0.0f, ctx->u, ctx->v, _sgl_pack_rgbab(r, g, b, a));
 }
 
 SOKOL_API_IMPL void sgl_v2f_c1i(float x, float y, uint32_t rgba) {
-    _sgl_vtx(x, y, 0.0f, _sgl.u, _sgl.v, rgba);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_vtx(ctx, x, y, 0.0f, ctx->u, ctx->v, rgba);
 }
 
 SOKOL_API_IMPL void sgl_v3f_c3f(float x, float y, float z, float r, float g, float b) {
-    _sgl_vtx(x, y, z, _sgl.u, _sgl.v, _sgl_pack_rgbaf(r, g, b, 1.0f));
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_vtx(ctx, x, y, z, ctx->u, ctx->v, _sgl_pack_rgbaf(r, g, b, 1.0f));
 }
 
 SOKOL_API_IMPL void sgl_v3f_c3b(float x, float y, float z, uint8_t r, uint8_t g, uint8_t b) {
-    _sgl_vtx(x, y, z, _sgl.u, _sgl.v, _sgl_pack_rgbab(r, g, b, 255));
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_vtx(ctx, x, y, z, ctx->u, ctx->v, _sgl_pack_rgbab(r, g, b, 255));
 }
 
 SOKOL_API_IMPL void sgl_v3f_c4f(float x, float y, float z, float r, float g, float b, float a) {
-    _sgl_vtx(x, y, z, _sgl.u, _sgl.v, _sgl_pack_rgbaf(r, g, b, a));
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_vtx(ctx, x, y, z, ctx->u, ctx->v, _sgl_pack_rgbaf(r, g, b, a));
 }
 
 SOKOL_API_IMPL void sgl_v3f_c4b(float x, float y, float z, uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
-    _sgl_vtx(x, y, z, _sgl.u, _sgl.v, _sgl_pack_rgbab(r, g, b, a));
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_vtx(ctx, x, y, z, ctx->u, ctx->v, _sgl_pack_rgbab(r, g, b, a));
 }
 
 SOKOL_API_IMPL void sgl_v3f_c1i(float x, float y, float z, uint32_t rgba) {
-    _sgl_vtx(x, y, z, _sgl.u, _sgl.v, rgba);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_vtx(ctx, x, y, z, ctx->u, ctx->v, rgba);
 }
 
 SOKOL_API_IMPL void sgl_v2f_t2f_c3f(float x, float y, float u, float v, float r, float g, float b) {
-    _sgl_vtx(x, y, 0.0f, u, v, _sgl_pack_rgbaf(r, g, b, 1.0f));
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_vtx(ctx, x, y, 0.0f, u, v, _sgl_pack_rgbaf(r, g, b, 1.0f));
 }
 
 SOKOL_API_IMPL void sgl_v2f_t2f_c3b(float x, float y, float u, float v, uint8_t r, uint8_t g, uint8_t b) {
-    _sgl_vtx(x, y, 0.0f, u, v, _sgl_pack_rgbab(r, g, b, 255));
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_vtx(ctx, x, y, 0.0f, u, v, _sgl_pack_rgbab(r, g, b, 255));
 }
 
 SOKOL_API_IMPL void sgl_v2f_t2f_c4f(float x, float y, float u, float v, float r, float g, float b, float a) {
-    _sgl_vtx(x, y, 0.0f, u, v, _sgl_pack_rgbaf(r, g, b, a));
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_vtx(ctx, x, y, 0.0f, u, v, _sgl_pack_rgbaf(r, g, b, a));
 }
 
 SOKOL_API_IMPL void sgl_v2f_t2f_c4b(float x, float y, float u, float v, uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
-    _sgl_vtx(x, y, 0.0f, u, v, _sgl_pack_rgbab(r, g, b, a));
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_vtx(ctx, x, y, 0.0f, u, v, _sgl_pack_rgbab(r, g, b, a));
 }
 
 SOKOL_API_IMPL void sgl_v2f_t2f_c1i(float x, float y, float u, float v, uint32_t rgba) {
-    _sgl_vtx(x, y, 0.0f, u, v, rgba);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_vtx(ctx, x, y, 0.0f, u, v, rgba);
 }
 
 SOKOL_API_IMPL void sgl_v3f_t2f_c3f(float x, float y, float z, float u, float v, float r, float g, float b) {
-    _sgl_vtx(x, y, z, u, v, _sgl_pack_rgbaf(r, g, b, 1.0f));
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_vtx(ctx, x, y, z, u, v, _sgl_pack_rgbaf(r, g, b, 1.0f));
 }
 
 SOKOL_API_IMPL void sgl_v3f_t2f_c3b(float x, float y, float z, float u, float v, uint8_t r, uint8_t g, uint8_t b) {
-    _sgl_vtx(x, y, z, u, v, _sgl_pack_rgbab(r, g, b, 255));
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_vtx(ctx, x, y, z, u, v, _sgl_pack_rgbab(r, g, b, 255));
 }
 
 SOKOL_API_IMPL void sgl_v3f_t2f_c4f(float x, float y, float z, float u, float v, float r, float g, float b, float a) {
-    _sgl_vtx(x, y, z, u, v, _sgl_pack_rgbaf(r, g, b, a));
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_vtx(ctx, x, y, z, u, v, _sgl_pack_rgbaf(r, g, b, a));
 }
 
 SOKOL_API_IMPL void sgl_v3f_t2f_c4b(float x, float y, float z, float u, float v, uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
-    _sgl_vtx(x, y, z, u, v, _sgl_pack_rgbab(r, g, b, a));
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_vtx(ctx, x, y, z, u, v, _sgl_pack_rgbab(r, g, b, a));
 }
 
 SOKOL_API_IMPL void sgl_v3f_t2f_c1i(float x, float y, float z, float u, float v, uint32_t rgba) {
-    _sgl_vtx(x, y, z, u, v, rgba);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_vtx(ctx, x, y, z, u, v, rgba);
 }
 
 SOKOL_API_IMPL void sgl_matrix_mode_modelview(void) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    _sgl.cur_matrix_mode = SGL_MATRIXMODE_MODELVIEW;
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    ctx->cur_matrix_mode = SGL_MATRIXMODE_MODELVIEW;
 }
 
 SOKOL_API_IMPL void sgl_matrix_mode_projection(void) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    _sgl.cur_matrix_mode = SGL_MATRIXMODE_PROJECTION;
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    ctx->cur_matrix_mode = SGL_MATRIXMODE_PROJECTION;
 }
 
 SOKOL_API_IMPL void sgl_matrix_mode_texture(void) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    _sgl.cur_matrix_mode = SGL_MATRIXMODE_TEXTURE;
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    ctx->cur_matrix_mode = SGL_MATRIXMODE_TEXTURE;
 }
 
 SOKOL_API_IMPL void sgl_load_identity(void) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    _sgl.matrix_dirty = true;
-    _sgl_identity(_sgl_matrix());
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_matrix_changed(ctx);
+    _sgl_identity(_sgl_matrix(ctx));
 }
 
 SOKOL_API_IMPL void sgl_load_matrix(const float m[16]) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    _sgl.matrix_dirty = true;
-    memcpy(&_sgl_matrix()->v[0][0], &m[0], 64);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_matrix_changed(ctx);
+    memcpy(&_sgl_matrix(ctx)->v[0][0], &m[0], 64);
 }
 
 SOKOL_API_IMPL void sgl_load_transpose_matrix(const float m[16]) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    _sgl.matrix_dirty = true;
-    _sgl_transpose(_sgl_matrix(), (const _sgl_matrix_t*) &m[0]);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_matrix_changed(ctx);
+    _sgl_transpose(_sgl_matrix(ctx), (const _sgl_matrix_t*) &m[0]);
 }
 
 SOKOL_API_IMPL void sgl_mult_matrix(const float m[16]) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    _sgl.matrix_dirty = true;
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_matrix_changed(ctx);
     const _sgl_matrix_t* m0  = (const _sgl_matrix_t*) &m[0];
-    _sgl_mul(_sgl_matrix(), m0);
+    _sgl_mul(_sgl_matrix(ctx), m0);
 }
 
 SOKOL_API_IMPL void sgl_mult_transpose_matrix(const float m[16]) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    _sgl.matrix_dirty = true;
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_matrix_changed(ctx);
     _sgl_matrix_t m0;
     _sgl_transpose(&m0, (const _sgl_matrix_t*) &m[0]);
-    _sgl_mul(_sgl_matrix(), &m0);
+    _sgl_mul(_sgl_matrix(ctx), &m0);
 }
 
 SOKOL_API_IMPL void sgl_rotate(float angle_rad, float x, float y, float z) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    _sgl.matrix_dirty = true;
-    _sgl_rotate(_sgl_matrix(), angle_rad, x, y, z);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_matrix_changed(ctx);
+    _sgl_rotate(_sgl_matrix(ctx), angle_rad, x, y, z);
 }
 
 SOKOL_API_IMPL void sgl_scale(float x, float y, float z) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    _sgl.matrix_dirty = true;
-    _sgl_scale(_sgl_matrix(), x, y, z);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_matrix_changed(ctx);
+    _sgl_scale(_sgl_matrix(ctx), x, y, z);
 }
 
 SOKOL_API_IMPL void sgl_translate(float x, float y, float z) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    _sgl.matrix_dirty = true;
-    _sgl_translate(_sgl_matrix(), x, y, z);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_matrix_changed(ctx);
+    _sgl_translate(_sgl_matrix(ctx), x, y, z);
 }
 
 SOKOL_API_IMPL void sgl_frustum(float l, float r, float b, float t, float n, float f) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    _sgl.matrix_dirty = true;
-    _sgl_frustum(_sgl_matrix(), l, r, b, t, n, f);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_matrix_changed(ctx);
+    _sgl_frustum(_sgl_matrix(ctx), l, r, b, t, n, f);
 }
 
 SOKOL_API_IMPL void sgl_ortho(float l, float r, float b, float t, float n, float f) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    _sgl.matrix_dirty = true;
-    _sgl_ortho(_sgl_matrix(), l, r, b, t, n, f);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_matrix_changed(ctx);
+    _sgl_ortho(_sgl_matrix(ctx), l, r, b, t, n, f);
 }
 
 SOKOL_API_IMPL void sgl_perspective(float fov_y, float aspect, float z_near, float z_far) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    _sgl.matrix_dirty = true;
-    _sgl_perspective(_sgl_matrix(), fov_y, aspect, z_near, z_far);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_matrix_changed(ctx);
+    _sgl_perspective(_sgl_matrix(ctx), fov_y, aspect, z_near, z_far);
 }
 
 SOKOL_API_IMPL void sgl_lookat(float eye_x, float eye_y, float eye_z, float center_x, float center_y, float center_z, float up_x, float up_y, float up_z) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    _sgl.matrix_dirty = true;
-    _sgl_lookat(_sgl_matrix(), eye_x, eye_y, eye_z, center_x, center_y, center_z, up_x, up_y, up_z);
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    _sgl_matrix_changed(ctx);
+    _sgl_lookat(_sgl_matrix(ctx), eye_x, eye_y, eye_z, center_x, center_y, center_z, up_x, up_y, up_z);
 }
 
 SOKOL_API_DECL void sgl_push_matrix(void) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    SOKOL_ASSERT((_sgl.cur_matrix_mode >= 0) && (_sgl.cur_matrix_mode < SGL_NUM_MATRIXMODES));
-    _sgl.matrix_dirty = true;
-    if (_sgl.matrix_tos[_sgl.cur_matrix_mode] < (_SGL_MAX_STACK_DEPTH - 1)) {
-        const _sgl_matrix_t* src = _sgl_matrix();
-        _sgl.matrix_tos[_sgl.cur_matrix_mode]++;
-        _sgl_matrix_t* dst = _sgl_matrix();
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    SOKOL_ASSERT((ctx->cur_matrix_mode >= 0) && (ctx->cur_matrix_mode < SGL_NUM_MATRIXMODES));
+    _sgl_matrix_changed(ctx);
+    if (ctx->matrix_tos[ctx->cur_matrix_mode] < (_SGL_MAX_STACK_DEPTH - 1)) {
+        const _sgl_matrix_t* src = _sgl_matrix(ctx);
+        ctx->matrix_tos[ctx->cur_matrix_mode]++;
+        _sgl_matrix_t* dst = _sgl_matrix(ctx);
         *dst = *src;
     }
     else {
-        _sgl.error = SGL_ERROR_STACK_OVERFLOW;
+        ctx->error = SGL_ERROR_STACK_OVERFLOW;
     }
 }
 
 SOKOL_API_DECL void sgl_pop_matrix(void) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    SOKOL_ASSERT((_sgl.cur_matrix_mode >= 0) && (_sgl.cur_matrix_mode < SGL_NUM_MATRIXMODES));
-    _sgl.matrix_dirty = true;
-    if (_sgl.matrix_tos[_sgl.cur_matrix_mode] > 0) {
-        _sgl.matrix_tos[_sgl.cur_matrix_mode]--;
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (!ctx) {
+        return;
+    }
+    SOKOL_ASSERT((ctx->cur_matrix_mode >= 0) && (ctx->cur_matrix_mode < SGL_NUM_MATRIXMODES));
+    _sgl_matrix_changed(ctx);
+    if (ctx->matrix_tos[ctx->cur_matrix_mode] > 0) {
+        ctx->matrix_tos[ctx->cur_matrix_mode]--;
     }
     else {
-        _sgl.error = SGL_ERROR_STACK_UNDERFLOW;
+        ctx->error = SGL_ERROR_STACK_UNDERFLOW;
     }
 }
 
-/* this renders the accumulated draw commands via sokol-gfx */
+/* this renders the accumulated draw commands of the current context via sokol-gfx */
 SOKOL_API_IMPL void sgl_draw(void) {
     SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
-    if ((_sgl.error == SGL_NO_ERROR) && (_sgl.cur_vertex > 0) && (_sgl.cur_command > 0)) {
-        uint32_t cur_pip_id = SG_INVALID_ID;
-        uint32_t cur_img_id = SG_INVALID_ID;
-        int cur_uniform_index = -1;
-        sg_push_debug_group("sokol-gl");
-        sg_update_buffer(_sgl.vbuf, _sgl.vertices, _sgl.cur_vertex * sizeof(_sgl_vertex_t));
-        _sgl.bind.vertex_buffers[0] = _sgl.vbuf;
-        for (int i = 0; i < _sgl.cur_command; i++) {
-            const _sgl_command_t* cmd = &_sgl.commands[i];
-            switch (cmd->cmd) {
-                case SGL_COMMAND_VIEWPORT:
-                    {
-                        const _sgl_viewport_args_t* args = &cmd->args.viewport;
-                        sg_apply_viewport(args->x, args->y, args->w, args->h, args->origin_top_left);
-                    }
-                    break;
-                case SGL_COMMAND_SCISSOR_RECT:
-                    {
-                        const _sgl_scissor_rect_args_t* args = &cmd->args.scissor_rect;
-                        sg_apply_scissor_rect(args->x, args->y, args->w, args->h, args->origin_top_left);
-                    }
-                    break;
-                case SGL_COMMAND_DRAW:
-                    {
-                        const _sgl_draw_args_t* args = &cmd->args.draw;
-                        if (args->pip.id != cur_pip_id) {
-                            sg_apply_pipeline(args->pip);
-                            cur_pip_id = args->pip.id;
-                            /* when pipeline changes, also need to re-apply uniforms and bindings */
-                            cur_img_id = SG_INVALID_ID;
-                            cur_uniform_index = -1;
-                        }
-                        if (cur_img_id != args->img.id) {
-                            _sgl.bind.fs_images[0] = args->img;
-                            sg_apply_bindings(&_sgl.bind);
-                            cur_img_id = args->img.id;
-                        }
-                        if (cur_uniform_index != args->uniform_index) {
-                            sg_apply_uniforms(SG_SHADERSTAGE_VS, 0, &_sgl.uniforms[args->uniform_index], sizeof(_sgl_uniform_t));
-                            cur_uniform_index = args->uniform_index;
-                        }
-                        /* FIXME: what if number of vertices doesn't match the primitive type? */
-                        if (args->num_vertices > 0) {
-                            sg_draw(args->base_vertex, args->num_vertices, 1);
-                        }
-                    }
-                    break;
-            }
-        }
-        sg_pop_debug_group();
+    _sgl_context_t* ctx = _sgl_cur_ctx();
+    if (ctx) {
+        _sgl_draw(ctx);
+    }
+}
+
+SOKOL_API_IMPL void sgl_context_draw(sgl_context ctx_id) {
+    SOKOL_ASSERT(_SGL_INIT_COOKIE == _sgl.init_cookie);
+    _sgl_context_t* ctx = _sgl_lookup_context(ctx_id.id);
+    if (ctx) {
+        _sgl_draw(ctx);
     }
-    _sgl_rewind();
 }
 #endif /* SOKOL_GL_IMPL */